@@ -0,0 +1,580 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <math.h>
+# include <float.h>
+
+# include "abm.h"
+
+static void abm_accept ( abm *a, double tnew );
+static double abm_norm ( abm *a, double c, double e[] );
+static void abm_table ( abm *a, double tnew, double fnew[], int m );
+
+/******************************************************************************/
+
+static void abm_accept ( abm *a, double tnew )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ABM_ACCEPT makes the new difference table the current one.
+
+  Discussion:
+
+    The tables are exchanged, not copied, and the oldest time drops out
+    once ABM_MAXORDER+1 are kept.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, abm *A, the integrator, with the new table in A->DN.
+
+    Input, double TNEW, the time of the new point.
+*/
+{
+  int j;
+  double *temp;
+
+  for ( j = 0; j < ABM_MAXORDER + 2; j++ )
+  {
+    temp = a->d[j];
+    a->d[j] = a->dn[j];
+    a->dn[j] = temp;
+  }
+  for ( j = ABM_MAXORDER; 0 < j; j-- )
+  {
+    a->tt[j] = a->tt[j-1];
+  }
+  a->tt[0] = tnew;
+  if ( a->nhist <= ABM_MAXORDER )
+  {
+    a->nhist = a->nhist + 1;
+  }
+
+  return;
+}
+/******************************************************************************/
+
+int abm_advance ( abm *a, double tout )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ABM_ADVANCE integrates up to a given time.
+
+  Discussion:
+
+    The last step is shortened to land on TOUT, but the step size
+    proposed by the controller is kept for the next call.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, abm *A, the integrator.
+
+    Input, double TOUT, the time to reach.
+
+    Output, int ABM_ADVANCE, is 0 on success, or 1 if the step size
+    underflowed.
+*/
+{
+  while ( a->t < tout )
+  {
+    if ( abm_step ( a, tout ) != 0 )
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+abm *abm_create ( ode_rhs *f, int n, double t, double x[], double atol,
+  double rtol, void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ABM_CREATE sets up an Adams-Bashforth-Moulton integrator.
+
+  Discussion:
+
+    The error is measured as in DOPRI_CREATE.  A->HMAX, the largest
+    step allowed, is initially unlimited and may be set by the caller.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T, X[N], the initial time and state.
+
+    Input, double ATOL, RTOL, the absolute and relative tolerances.
+
+    Input, void *DATA, passed to F.
+
+    Output, abm *ABM_CREATE, the integrator, or NULL if memory ran out.
+*/
+{
+  abm *a;
+  int i;
+  int j;
+
+  a = ( abm * ) malloc ( sizeof ( abm ) );
+  if ( a == NULL )
+  {
+    return NULL;
+  }
+  a->start = NULL;
+  a->x = ( double * ) malloc ( ( 2 * ABM_MAXORDER + 7 ) * n
+    * sizeof ( double ) );
+  if ( a->x == NULL )
+  {
+    free ( a );
+    return NULL;
+  }
+  a->xp = a->x + n;
+  for ( j = 0; j < ABM_MAXORDER + 2; j++ )
+  {
+    a->d[j] = a->x + ( 2 + j ) * n;
+    a->dn[j] = a->x + ( ABM_MAXORDER + 4 + j ) * n;
+  }
+  a->w = a->x + ( 2 * ABM_MAXORDER + 6 ) * n;
+
+  a->f = f;
+  a->data = data;
+  a->n = n;
+  a->mode = ABM_PECE;
+  a->atol = atol;
+  a->rtol = rtol;
+  a->hmax = HUGE_VAL;
+  a->t = t;
+  a->order = 1;
+  a->nhist = 1;
+  a->nsame = 0;
+  a->tt[0] = t;
+  a->nfev = 0;
+  a->naccept = 0;
+  a->nreject = 0;
+
+/*
+  The starting steps, and the first step size, come from DOPRI, whose
+  last stage is F at the new point.
+*/
+  a->start = dopri_create ( f, n, t, x, atol, rtol, data );
+  if ( a->start == NULL )
+  {
+    abm_free ( a );
+    return NULL;
+  }
+  a->nfev = a->start->nfev;
+  a->h = a->start->h;
+  for ( i = 0; i < n; i++ )
+  {
+    a->x[i] = x[i];
+    a->d[0][i] = a->start->k[0][i];
+  }
+
+  return a;
+}
+/******************************************************************************/
+
+void abm_free ( abm *a )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ABM_FREE frees an Adams-Bashforth-Moulton integrator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, abm *A, the integrator.
+*/
+{
+  if ( a->start != NULL )
+  {
+    dopri_free ( a->start );
+  }
+  free ( a->x );
+  free ( a );
+
+  return;
+}
+/******************************************************************************/
+
+static double abm_norm ( abm *a, double c, double e[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ABM_NORM is the scaled RMS norm of C * E.
+
+  Discussion:
+
+    The scale uses the larger of the old state and the prediction.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, abm *A, the integrator.
+
+    Input, double C, E[N], the factor and the vector.
+
+    Output, double ABM_NORM, the norm.
+*/
+{
+  int i;
+  double sk;
+  double value;
+
+  value = 0.0;
+  for ( i = 0; i < a->n; i++ )
+  {
+    sk = a->atol + a->rtol * fmax ( fabs ( a->x[i] ), fabs ( a->xp[i] ) );
+    value = value + ( c * e[i] / sk ) * ( c * e[i] / sk );
+  }
+  value = sqrt ( value / a->n );
+
+  return value;
+}
+/******************************************************************************/
+
+int abm_step ( abm *a, double tout )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ABM_STEP takes one accepted step.
+
+  Discussion:
+
+    With past times T(0) = A->T > T(1) > ... and the divided differences
+    D(I) = F[T(0),...,T(I)], the interpolant of F through the last K
+    points is P(S) = sum D(I) W(I,S), W(I,S) = ( S - T(0) ) ... ( S - T(I-1) ),
+    and the predictor is
+
+      XP = X + sum ( 0 <= I < K ) C(I) D(I),  C(I) = integral W(I,S) dS
+
+    over [T, T+H].  With FP = F ( T+H, XP ) the table is extended to
+    DN(I) = F[T+H,T(0),...,T(I-1)], and adding the next interpolation
+    term gives the corrector of order K+1,
+
+      X = XP + C(K) DN(K).
+
+    |C(K) DN(K)| is the error estimate, and |C(K-1) DN(K-1)| and
+    |C(K+1) DN(K+1)| play the same role for orders K-1 and K+1.
+
+    The C(I) are integrals of polynomials with known roots, formed in
+    O(K^2) operations; the table update costs O(K*N).
+
+    A rejected step costs one evaluation, and leaves the history as it
+    was.  The step never goes past TOUT.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Lawrence Shampine, Marilyn Gordon,
+    Computer Solution of Ordinary Differential Equations:
+    The Initial Value Problem,
+    Freeman, 1975.
+
+  Parameters:
+
+    Input/output, abm *A, the integrator.
+
+    Input, double TOUT, a time not to step past.
+
+    Output, int ABM_STEP, is 0 on success, or 1 if the step size became
+    too small to change T.
+*/
+{
+  double c[ABM_MAXORDER+2];
+  double err;
+  double errm;
+  double errp;
+  double fac;
+  double h;
+  double hi;
+  int i;
+  int j;
+  int k;
+  int knew;
+  int last;
+  int m;
+  int mfail;
+  int n = a->n;
+  double poly[ABM_MAXORDER+3];
+  double sj;
+  double sum;
+  double t = a->t;
+  double *x = a->x;
+  double *xp = a->xp;
+
+  mfail = 0;
+
+  for ( ; ; )
+  {
+    h = fmin ( a->h, a->hmax );
+    last = 0;
+    if ( tout <= t + 1.01 * h )
+    {
+      h = tout - t;
+      last = 1;
+    }
+    if ( fabs ( h ) <= 16.0 * DBL_EPSILON * fabs ( t ) || h <= 0.0 )
+    {
+      return 1;
+    }
+/*
+  Start with DOPRI steps, under the same error control, until there are
+  ABM_START points.
+*/
+    if ( a->start != NULL )
+    {
+      a->start->hmax = a->hmax;
+      if ( dopri_step ( a->start, tout ) != 0 )
+      {
+        return 1;
+      }
+      a->nfev = a->start->nfev;
+      abm_table ( a, a->start->t, a->start->k[0], a->nhist );
+      abm_accept ( a, a->start->t );
+      for ( i = 0; i < n; i++ )
+      {
+        x[i] = a->start->x[i];
+      }
+      a->t = a->start->t;
+      a->h = a->start->h;
+      a->naccept = a->naccept + 1;
+      if ( ABM_START <= a->nhist )
+      {
+        a->nreject = a->start->nreject;
+        dopri_free ( a->start );
+        a->start = NULL;
+        a->order = ABM_START;
+        a->nsame = 0;
+      }
+      return 0;
+    }
+
+    k = a->order;
+    m = ( a->nhist < k + 1 ) ? a->nhist : k + 1;
+/*
+  C(I) = H^(I+1) * integral ( 0 to 1 ) prod ( J < I ) ( U - UJ ) dU,
+  with UJ = ( T(J) - T ) / H, by multiplying out the product.
+*/
+    for ( i = 0; i <= m + 1; i++ )
+    {
+      poly[i] = 0.0;
+    }
+    poly[0] = 1.0;
+    hi = h;
+    for ( i = 0; i <= m; i++ )
+    {
+      sum = 0.0;
+      for ( j = 0; j <= i; j++ )
+      {
+        sum = sum + poly[j] / ( double ) ( j + 1 );
+      }
+      c[i] = hi * sum;
+      hi = hi * h;
+      if ( i < m )
+      {
+        sj = ( a->tt[i] - t ) / h;
+        for ( j = i + 1; 0 < j; j-- )
+        {
+          poly[j] = poly[j-1] - sj * poly[j];
+        }
+        poly[0] = - sj * poly[0];
+      }
+    }
+
+    for ( i = 0; i < n; i++ )
+    {
+      sum = 0.0;
+      for ( j = k - 1; 0 <= j; j-- )
+      {
+        sum = sum + c[j] * a->d[j][i];
+      }
+      xp[i] = x[i] + sum;
+    }
+    a->f ( t + h, xp, a->w, a->data );
+    a->nfev = a->nfev + 1;
+    abm_table ( a, t + h, a->w, m );
+
+    err = abm_norm ( a, c[k], a->dn[k] );
+    errm = ( 1 < k ) ? abm_norm ( a, c[k-1], a->dn[k-1] ) : HUGE_VAL;
+    errp = ( k < m && k < ABM_MAXORDER && k + 1 <= a->nsame )
+      ? abm_norm ( a, c[k+1], a->dn[k+1] ) : HUGE_VAL;
+
+    if ( err <= 1.0 )
+    {
+      break;
+    }
+/*
+  Reject.  Shrink the step, and fall back to order 1 after three
+  failures in a row, as the history may not describe F any more.
+*/
+    a->nreject = a->nreject + 1;
+    mfail = mfail + 1;
+    if ( errm <= err )
+    {
+      a->order = k - 1;
+    }
+    if ( 3 <= mfail )
+    {
+      a->order = 1;
+    }
+    fac = 0.9 * pow ( err, -1.0 / ( double ) ( k + 1 ) );
+    a->h = h * fmax ( 0.1, fmin ( 0.9, fac ) );
+    a->nsame = 0;
+  }
+/*
+  Accept: correct, and with PECE evaluate again and redo the table.
+*/
+  for ( i = 0; i < n; i++ )
+  {
+    x[i] = xp[i] + c[k] * a->dn[k][i];
+  }
+  if ( a->mode == ABM_PECE )
+  {
+    a->f ( t + h, x, a->w, a->data );
+    a->nfev = a->nfev + 1;
+    abm_table ( a, t + h, a->w, m );
+  }
+  abm_accept ( a, t + h );
+/*
+  Choose the order whose estimate is smallest, then the step for it.
+*/
+  knew = k;
+  if ( errm <= err && errm <= errp )
+  {
+    knew = k - 1;
+    err = errm;
+  }
+  else if ( errp < err )
+  {
+    knew = k + 1;
+    err = errp;
+  }
+  a->nsame = ( knew == k ) ? a->nsame + 1 : 0;
+  a->order = knew;
+
+  fac = ( 0.0 < err ) ? 0.9 * pow ( err, -1.0 / ( double ) ( knew + 1 ) )
+    : 2.0;
+  fac = fmax ( 0.5, fmin ( 2.0, fac ) );
+  if ( mfail )
+  {
+    fac = fmin ( 1.0, fac );
+  }
+  if ( !last || a->h < h * fac )
+  {
+    a->h = h * fac;
+  }
+  a->t = last ? tout : t + h;
+  a->naccept = a->naccept + 1;
+
+  return 0;
+}
+/******************************************************************************/
+
+static void abm_table ( abm *a, double tnew, double fnew[], int m )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ABM_TABLE extends the divided differences by a new point.
+
+  Discussion:
+
+    DN(0) = FNEW and DN(I) = ( DN(I-1) - D(I-1) ) / ( TNEW - T(I-1) ),
+    so DN(I) = F[TNEW,T(0),...,T(I-1)].
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, abm *A, the integrator; A->DN(0:M) is set.
+
+    Input, double TNEW, FNEW[N], the new point and the value of F there.
+
+    Input, int M, the last difference wanted, at most A->NHIST.
+*/
+{
+  int i;
+  int j;
+  double r;
+
+  for ( i = 0; i < a->n; i++ )
+  {
+    a->dn[0][i] = fnew[i];
+  }
+  for ( j = 1; j <= m; j++ )
+  {
+    r = 1.0 / ( tnew - a->tt[j-1] );
+    for ( i = 0; i < a->n; i++ )
+    {
+      a->dn[j][i] = ( a->dn[j-1][i] - a->d[j-1][i] ) * r;
+    }
+  }
+
+  return;
+}
@@ -0,0 +1,72 @@
+/*
+  ABM holds the variable step, variable order Adams-Bashforth-Moulton
+  predictor-corrector methods, of orders 1 to ABM_MAXORDER, for smooth
+  nonstiff systems whose right hand side is expensive:
+
+    a = abm_create ( f, n, t, x, atol, rtol, data );
+    abm_advance ( a, tout );      the state is now a->x at a->t = tout
+    abm_free ( a );
+
+  The past values of F are kept as divided differences over the actual,
+  unequally spaced, past times, so the step size can change every step.
+  A step of order K predicts with the K step Adams-Bashforth formula,
+  evaluates F there, and corrects with the Adams-Moulton formula of
+  order K+1.  With A->MODE = ABM_PECE (the default) F is evaluated again
+  at the corrected point, 2 evaluations per step; with ABM_PEC the
+  predicted value is kept, 1 evaluation per step but a smaller region
+  of stability.
+
+  The difference between predictor and corrector estimates the error,
+  and the neighbouring terms of the same differences estimate what
+  orders K-1 and K+1 would have done, so the order goes up while the
+  solution is smooth and down when it is not.
+
+  The first ABM_START-1 steps are Dormand-Prince steps under the same
+  error control, which build the history for a start at order
+  ABM_START; an uncontrolled start would limit the accuracy of the
+  whole run.
+*/
+# ifndef ABM_H
+# define ABM_H
+
+# include "ode.h"
+
+# define ABM_MAXORDER 12
+# define ABM_START 4
+
+# define ABM_PEC 1
+# define ABM_PECE 2
+
+typedef struct
+{
+  ode_rhs *f;
+  void *data;
+  int n;
+  int mode;
+  double atol;
+  double rtol;
+  double hmax;
+  double t;
+  double h;
+  int order;
+  int nhist;
+  int nsame;
+  double tt[ABM_MAXORDER+1];
+  double *x;
+  double *xp;
+  double *d[ABM_MAXORDER+2];
+  double *dn[ABM_MAXORDER+2];
+  double *w;
+  dopri *start;
+  long nfev;
+  long naccept;
+  long nreject;
+} abm;
+
+int abm_advance ( abm *a, double tout );
+abm *abm_create ( ode_rhs *f, int n, double t, double x[], double atol,
+  double rtol, void *data );
+void abm_free ( abm *a );
+int abm_step ( abm *a, double tout );
+
+# endif
@@ -0,0 +1,812 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <string.h>
+# include <time.h>
+# include <unistd.h>
+# include <fcntl.h>
+# include <pthread.h>
+
+# include "ckpt.h"
+
+static double ckpt_clock ( void );
+static char *ckpt_find ( ckpt *c, char *name, size_t *size );
+static unsigned long long ckpt_hash ( char *b, size_t len );
+static int ckpt_syncdir ( char *filename );
+static void ckpt_wait ( ckpt *c );
+static void *ckpt_writer ( void *arg );
+
+/******************************************************************************/
+
+void ckpt_begin ( ckpt *c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_BEGIN starts a new snapshot.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, ckpt *C, the checkpointer.
+*/
+{
+  c->tbegin = ckpt_clock ( );
+  memcpy ( c->buf[c->cur], "CKPTFILE", 8 );
+  c->len[c->cur] = 8;
+
+  return;
+}
+/******************************************************************************/
+
+static double ckpt_clock ( void )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_CLOCK returns the wall clock time in seconds.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Output, double CKPT_CLOCK, the time, from an arbitrary origin.
+*/
+{
+  struct timespec ts;
+
+  clock_gettime ( CLOCK_MONOTONIC, &ts );
+
+  return ( double ) ts.tv_sec + 1.0E-09 * ( double ) ts.tv_nsec;
+}
+/******************************************************************************/
+
+int ckpt_commit ( ckpt *c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_COMMIT hands the snapshot to the writer thread.
+
+  Discussion:
+
+    If the previous snapshot is still being written, it waits for it
+    first.  If no thread can be started the snapshot is written before
+    returning.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, ckpt *C, the checkpointer.
+
+    Output, int CKPT_COMMIT, is 0, or 1 if writing an earlier snapshot
+    failed.
+*/
+{
+  int error;
+
+  ckpt_wait ( c );
+  error = c->error;
+  c->error = 0;
+
+  c->nsave = c->nsave + 1;
+  c->bytes = c->bytes + c->len[c->cur] + 8;
+  c->cur = 1 - c->cur;
+  c->running = 1;
+  if ( pthread_create ( &c->thread, NULL, ckpt_writer, c ) != 0 )
+  {
+    ckpt_writer ( c );
+    c->running = 0;
+  }
+  c->tcaller = c->tcaller + ckpt_clock ( ) - c->tbegin;
+
+  return error;
+}
+/******************************************************************************/
+
+ckpt *ckpt_create ( char *filename )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_CREATE creates a checkpointer for a file.
+
+  Discussion:
+
+    Nothing is read or written yet.  The run time reported by CKPT_REPORT
+    is counted from here.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, char *FILENAME, the checkpoint file.
+
+    Output, ckpt *CKPT_CREATE, the checkpointer.
+*/
+{
+  ckpt *c;
+  int k;
+
+  c = ( ckpt * ) malloc ( sizeof ( ckpt ) );
+  c->filename = filename;
+  c->tmpname = ( char * ) malloc ( strlen ( filename ) + 5 );
+  sprintf ( c->tmpname, "%s.tmp", filename );
+  for ( k = 0; k < 2; k++ )
+  {
+    c->size[k] = 4096;
+    c->buf[k] = ( char * ) malloc ( c->size[k] );
+    c->len[k] = 0;
+  }
+  c->cur = 0;
+  c->running = 0;
+  c->error = 0;
+  c->image = NULL;
+  c->ilen = 0;
+  c->tstart = ckpt_clock ( );
+  c->tcaller = 0.0;
+  c->twrite = 0.0;
+  c->tbegin = 0.0;
+  c->nsave = 0;
+  c->bytes = 0;
+
+  return c;
+}
+/******************************************************************************/
+
+static char *ckpt_find ( ckpt *c, char *name, size_t *size )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_FIND finds a section of the loaded checkpoint.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ckpt *C, the checkpointer, after CKPT_LOAD.
+
+    Input, char *NAME, the section name.
+
+    Output, size_t *SIZE, the size of the section.
+
+    Output, char *CKPT_FIND, its data, or NULL if there is no such section.
+*/
+{
+  size_t end;
+  unsigned int nl;
+  size_t offset;
+  unsigned long long s;
+
+  if ( c->image == NULL )
+  {
+    return NULL;
+  }
+
+  end = c->ilen - 8;
+  offset = 8;
+  while ( offset + 4 <= end )
+  {
+    memcpy ( &nl, c->image + offset, 4 );
+    if ( end - offset - 4 < ( size_t ) nl + 8 )
+    {
+      break;
+    }
+    memcpy ( &s, c->image + offset + 4 + nl, 8 );
+    if ( end - offset - 12 - nl < s )
+    {
+      break;
+    }
+    if ( nl == strlen ( name ) && memcmp ( c->image + offset + 4, name, nl ) == 0 )
+    {
+      *size = ( size_t ) s;
+      return c->image + offset + 12 + nl;
+    }
+    offset = offset + 12 + nl + ( size_t ) s;
+  }
+
+  return NULL;
+}
+/******************************************************************************/
+
+void ckpt_free ( ckpt *c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_FREE waits for the last snapshot to be written and frees C.
+
+  Discussion:
+
+    The checkpoint file is left in place; a run that has finished should
+    remove it so that the next run does not resume from it.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ckpt *C, the checkpointer.
+*/
+{
+  ckpt_wait ( c );
+  free ( c->tmpname );
+  free ( c->buf[0] );
+  free ( c->buf[1] );
+  free ( c->image );
+  free ( c );
+
+  return;
+}
+/******************************************************************************/
+
+int ckpt_get ( ckpt *c, char *name, void *data, size_t size )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_GET copies a section of the loaded checkpoint.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ckpt *C, the checkpointer, after CKPT_LOAD.
+
+    Input, char *NAME, the section name.
+
+    Output, void *DATA, the SIZE bytes of the section.
+
+    Input, size_t SIZE, the size expected.
+
+    Output, int CKPT_GET, is 0, or 1 if there is no such section or it
+    has another size; then DATA is unchanged.
+*/
+{
+  char *p;
+  size_t s;
+
+  p = ckpt_find ( c, name, &s );
+  if ( p == NULL || s != size )
+  {
+    return 1;
+  }
+  memcpy ( data, p, size );
+
+  return 0;
+}
+/******************************************************************************/
+
+int ckpt_get_dopri ( ckpt *c, dopri *d )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_GET_DOPRI restores a DOPRI integrator saved by CKPT_PUT_DOPRI.
+
+  Discussion:
+
+    D must have been created for the same system.  Its right hand side,
+    parameters and tolerances are not part of the checkpoint.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ckpt *C, the checkpointer, after CKPT_LOAD.
+
+    Input/output, dopri *D, the integrator.
+
+    Output, int CKPT_GET_DOPRI, is 0, or 1 if the checkpoint holds no
+    integrator of this size; then D is unchanged.
+*/
+{
+  double s[4];
+  long l[5];
+  int n = d->n;
+  size_t size;
+
+  if ( ckpt_get ( c, "dopri.long", l, sizeof ( l ) ) != 0 || l[0] != n
+    || ckpt_find ( c, "dopri.x", &size ) == NULL
+    || size != n * sizeof ( double ) )
+  {
+    return 1;
+  }
+  ckpt_get ( c, "dopri.double", s, sizeof ( s ) );
+  ckpt_get ( c, "dopri.x", d->x, n * sizeof ( double ) );
+  ckpt_get ( c, "dopri.k0", d->k[0], n * sizeof ( double ) );
+  d->t = s[0];
+  d->h = s[1];
+  d->facold = s[2];
+  d->told = s[3];
+  d->fsal = ( int ) l[1];
+  d->nfev = l[2];
+  d->naccept = l[3];
+  d->nreject = l[4];
+  if ( d->dense )
+  {
+    ckpt_get ( c, "dopri.rcont", d->rcont, 5 * n * sizeof ( double ) );
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+static unsigned long long ckpt_hash ( char *b, size_t len )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_HASH is the 64 bit FNV-1a hash of a block of bytes.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, char *B, the bytes.
+
+    Input, size_t LEN, their number.
+
+    Output, unsigned long long CKPT_HASH, the hash.
+*/
+{
+  unsigned long long h;
+  size_t i;
+
+  h = 14695981039346656037ULL;
+  for ( i = 0; i < len; i++ )
+  {
+    h = ( h ^ ( unsigned char ) b[i] ) * 1099511628211ULL;
+  }
+
+  return h;
+}
+/******************************************************************************/
+
+int ckpt_load ( ckpt *c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_LOAD reads the checkpoint file, if there is one.
+
+  Discussion:
+
+    A file that is short, or whose hash does not match, is reported and
+    ignored.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, ckpt *C, the checkpointer.
+
+    Output, int CKPT_LOAD, is 0 if a checkpoint was read, or 1 if there
+    is none.
+*/
+{
+  FILE *fp;
+  unsigned long long h;
+  long size;
+
+  free ( c->image );
+  c->image = NULL;
+  c->ilen = 0;
+
+  fp = fopen ( c->filename, "rb" );
+  if ( fp == NULL )
+  {
+    return 1;
+  }
+  fseek ( fp, 0, SEEK_END );
+  size = ftell ( fp );
+  fseek ( fp, 0, SEEK_SET );
+  if ( size < 16 )
+  {
+    fclose ( fp );
+    fprintf ( stderr, "CKPT_LOAD: \"%s\" is not a checkpoint, ignored.\n",
+      c->filename );
+    return 1;
+  }
+  c->image = ( char * ) malloc ( size );
+  c->ilen = ( size_t ) size;
+  if ( fread ( c->image, 1, c->ilen, fp ) != c->ilen )
+  {
+    c->ilen = 0;
+  }
+  fclose ( fp );
+
+  if ( 16 <= c->ilen )
+  {
+    memcpy ( &h, c->image + c->ilen - 8, 8 );
+  }
+  if ( c->ilen < 16 || memcmp ( c->image, "CKPTFILE", 8 ) != 0
+    || h != ckpt_hash ( c->image, c->ilen - 8 ) )
+  {
+    free ( c->image );
+    c->image = NULL;
+    c->ilen = 0;
+    fprintf ( stderr, "CKPT_LOAD: \"%s\" is damaged, ignored.\n",
+      c->filename );
+    return 1;
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+void ckpt_put ( ckpt *c, char *name, void *data, size_t size )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_PUT copies a section into the current snapshot.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, ckpt *C, the checkpointer, after CKPT_BEGIN.
+
+    Input, char *NAME, the section name.
+
+    Input, void *DATA, the SIZE bytes to save.
+
+    Input, size_t SIZE, their number.
+*/
+{
+  char *b;
+  int k = c->cur;
+  unsigned int nl;
+  unsigned long long s;
+
+  nl = ( unsigned int ) strlen ( name );
+  while ( c->size[k] < c->len[k] + 12 + nl + size )
+  {
+    c->size[k] = 2 * c->size[k];
+    c->buf[k] = ( char * ) realloc ( c->buf[k], c->size[k] );
+  }
+  b = c->buf[k] + c->len[k];
+  s = size;
+  memcpy ( b, &nl, 4 );
+  memcpy ( b + 4, name, nl );
+  memcpy ( b + 4 + nl, &s, 8 );
+  memcpy ( b + 12 + nl, data, size );
+  c->len[k] = c->len[k] + 12 + nl + size;
+
+  return;
+}
+/******************************************************************************/
+
+void ckpt_put_dopri ( ckpt *c, dopri *d )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_PUT_DOPRI saves the state of a DOPRI integrator.
+
+  Discussion:
+
+    Besides T and X, the step size, the memory of the step size
+    controller, the FSAL derivative, the dense output and the counters
+    are saved, so a restored integrator takes exactly the same steps.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, ckpt *C, the checkpointer, after CKPT_BEGIN.
+
+    Input, dopri *D, the integrator.
+*/
+{
+  double s[4];
+  long l[5];
+  int n = d->n;
+
+  s[0] = d->t;
+  s[1] = d->h;
+  s[2] = d->facold;
+  s[3] = d->told;
+  l[0] = n;
+  l[1] = d->fsal;
+  l[2] = d->nfev;
+  l[3] = d->naccept;
+  l[4] = d->nreject;
+  ckpt_put ( c, "dopri.double", s, sizeof ( s ) );
+  ckpt_put ( c, "dopri.long", l, sizeof ( l ) );
+  ckpt_put ( c, "dopri.x", d->x, n * sizeof ( double ) );
+  ckpt_put ( c, "dopri.k0", d->k[0], n * sizeof ( double ) );
+  if ( d->dense )
+  {
+    ckpt_put ( c, "dopri.rcont", d->rcont, 5 * n * sizeof ( double ) );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void ckpt_report ( ckpt *c, FILE *fp )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_REPORT prints what the checkpoints have cost.
+
+  Discussion:
+
+    The time in the run is what the caller spent between CKPT_BEGIN and
+    the return of CKPT_COMMIT, copying and waiting for the writer; the
+    time of the writer thread, which overlaps the run, is shown apart.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ckpt *C, the checkpointer.
+
+    Input, FILE *FP, where to print.
+*/
+{
+  double total;
+
+  ckpt_wait ( c );
+  total = ckpt_clock ( ) - c->tstart;
+  fprintf ( fp, "checkpoints = %ld, %.1f MB, %.4f s of %.3f s in the run (%.2f%%), %.4f s writing\n",
+    c->nsave, c->bytes / 1.0E+06, c->tcaller, total,
+    ( 0.0 < total ) ? 100.0 * c->tcaller / total : 0.0, c->twrite );
+
+  return;
+}
+/******************************************************************************/
+
+static int ckpt_syncdir ( char *filename )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_SYNCDIR flushes the directory holding a file to the disk.
+
+  Discussion:
+
+    A rename changes the directory, not the file, so until the directory
+    is synced a crash can still bring back the old name.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, char *FILENAME, the file.
+
+    Output, int CKPT_SYNCDIR, is 0, or 1 if the directory could not be
+    opened or synced.
+*/
+{
+  char *dir;
+  int fd;
+  size_t len;
+  char *slash;
+  int status;
+
+  slash = strrchr ( filename, '/' );
+  if ( slash == NULL )
+  {
+    dir = ( char * ) malloc ( 2 );
+    strcpy ( dir, "." );
+  }
+  else
+  {
+    len = ( slash == filename ) ? 1 : ( size_t ) ( slash - filename );
+    dir = ( char * ) malloc ( len + 1 );
+    memcpy ( dir, filename, len );
+    dir[len] = '\0';
+  }
+
+  status = 1;
+  fd = open ( dir, O_RDONLY | O_DIRECTORY );
+  if ( 0 <= fd )
+  {
+    if ( fsync ( fd ) == 0 )
+    {
+      status = 0;
+    }
+    close ( fd );
+  }
+  free ( dir );
+
+  return status;
+}
+/******************************************************************************/
+
+static void ckpt_wait ( ckpt *c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_WAIT waits for the writer thread, if it is running.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, ckpt *C, the checkpointer.
+*/
+{
+  if ( c->running )
+  {
+    pthread_join ( c->thread, NULL );
+    c->running = 0;
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void *ckpt_writer ( void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    CKPT_WRITER writes a snapshot and renames it over the checkpoint.
+
+  Discussion:
+
+    The snapshot is the buffer not being filled, C->BUF[1-C->CUR].  The
+    data is on the disk before the rename, and the directory is synced
+    after it, so a crash at any moment leaves either the old checkpoint
+    or the new one, and a finished checkpoint stays.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, void *ARG, the checkpointer.
+*/
+{
+  ckpt *c = ( ckpt * ) arg;
+  FILE *fp;
+  unsigned long long h;
+  int k = 1 - c->cur;
+  double t;
+
+  t = ckpt_clock ( );
+  h = ckpt_hash ( c->buf[k], c->len[k] );
+
+  fp = fopen ( c->tmpname, "wb" );
+  if ( fp == NULL )
+  {
+    c->error = 1;
+    return NULL;
+  }
+  if ( fwrite ( c->buf[k], 1, c->len[k], fp ) != c->len[k]
+    || fwrite ( &h, 8, 1, fp ) != 1 || fflush ( fp ) != 0
+    || fsync ( fileno ( fp ) ) != 0 )
+  {
+    c->error = 1;
+  }
+  if ( fclose ( fp ) != 0 )
+  {
+    c->error = 1;
+  }
+  if ( !c->error && ( rename ( c->tmpname, c->filename ) != 0
+    || ckpt_syncdir ( c->filename ) != 0 ) )
+  {
+    c->error = 1;
+  }
+  c->twrite = c->twrite + ckpt_clock ( ) - t;
+
+  return NULL;
+}
@@ -0,0 +1,75 @@
+/*
+  CKPT writes checkpoints of a long run and reads them back on restart:
+
+    c = ckpt_create ( "run.ckpt" );
+    if ( ckpt_load ( c ) == 0 )            a checkpoint exists: resume
+    {
+      ckpt_get ( c, "x", x, n * sizeof ( double ) );
+      ...
+    }
+    ...
+    ckpt_begin ( c );                      every so often
+    ckpt_put ( c, "x", x, n * sizeof ( double ) );
+    ckpt_commit ( c );
+    ...
+    ckpt_report ( c, stdout );
+    ckpt_free ( c );
+
+  A checkpoint is a list of named sections, each a plain copy of the
+  caller's memory, so restoring every variable the run depends on gives
+  the same results, bit for bit, as a run that never stopped.
+  CKPT_PUT_DOPRI and CKPT_GET_DOPRI do this for a DOPRI integrator,
+  with its step size controller and its FSAL derivative.
+
+  The caller only pays for the copies.  CKPT_COMMIT hands the snapshot
+  to a writer thread, which writes FILENAME.tmp, checksums it, flushes
+  it to the disk and renames it over FILENAME, so the file is always a
+  whole checkpoint, the old or the new one.  A snapshot taken while the
+  last one is still being written waits for it.
+
+  The file holds "CKPTFILE", then for each section a 32 bit name length,
+  the name, a 64 bit size and the data, and last a 64 bit FNV-1a hash of
+  everything before it, all in the byte order of the machine: a
+  checkpoint is meant for restarting on the same kind of machine.
+*/
+# ifndef CKPT_H
+# define CKPT_H
+
+# include <stdio.h>
+# include <pthread.h>
+
+# include "ode.h"
+
+typedef struct
+{
+  char *filename;
+  char *tmpname;
+  char *buf[2];
+  size_t len[2];
+  size_t size[2];
+  int cur;
+  int running;
+  pthread_t thread;
+  int error;
+  char *image;
+  size_t ilen;
+  double tstart;
+  double tcaller;
+  double twrite;
+  double tbegin;
+  long nsave;
+  size_t bytes;
+} ckpt;
+
+void ckpt_begin ( ckpt *c );
+int ckpt_commit ( ckpt *c );
+ckpt *ckpt_create ( char *filename );
+void ckpt_free ( ckpt *c );
+int ckpt_get ( ckpt *c, char *name, void *data, size_t size );
+int ckpt_get_dopri ( ckpt *c, dopri *d );
+int ckpt_load ( ckpt *c );
+void ckpt_put ( ckpt *c, char *name, void *data, size_t size );
+void ckpt_put_dopri ( ckpt *c, dopri *d );
+void ckpt_report ( ckpt *c, FILE *fp );
+
+# endif
@@ -0,0 +1,200 @@
+# include <stdlib.h>
+
+# include "erk.h"
+
+static const double heun_c[2] = { 0.0, 1.0 };
+static const double heun_a[2*2] = {
+  0.0, 0.0,
+  1.0, 0.0 };
+static const double heun_b[2] = { 0.5, 0.5 };
+
+static const double rk3_c[3] = { 0.0, 0.5, 1.0 };
+static const double rk3_a[3*3] = {
+  0.0, 0.0, 0.0,
+  0.5, 0.0, 0.0,
+ -1.0, 2.0, 0.0 };
+static const double rk3_b[3] = { 1.0 / 6.0, 2.0 / 3.0, 1.0 / 6.0 };
+
+static const double rk4_c[4] = { 0.0, 0.5, 0.5, 1.0 };
+static const double rk4_a[4*4] = {
+  0.0, 0.0, 0.0, 0.0,
+  0.5, 0.0, 0.0, 0.0,
+  0.0, 0.5, 0.0, 0.0,
+  0.0, 0.0, 1.0, 0.0 };
+static const double rk4_b[4] = { 1.0 / 6.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 6.0 };
+
+static const double rk38_c[4] = { 0.0, 1.0 / 3.0, 2.0 / 3.0, 1.0 };
+static const double rk38_a[4*4] = {
+  0.0, 0.0, 0.0, 0.0,
+  1.0 / 3.0, 0.0, 0.0, 0.0,
+ -1.0 / 3.0, 1.0, 0.0, 0.0,
+  1.0, -1.0, 1.0, 0.0 };
+static const double rk38_b[4] = { 1.0 / 8.0, 3.0 / 8.0, 3.0 / 8.0, 1.0 / 8.0 };
+
+/******************************************************************************/
+
+void erk_heun_step ( ode_rhs *f, int n, double t, double h, double x[],
+  double work[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ERK_HEUN_STEP takes one step of Heun's second order method.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T, H, the time and the step size.
+
+    Input/output, double X[N], the state at T, replaced by the state
+    at T+H.
+
+    Workspace, double WORK[3*N].
+
+    Input, void *DATA, passed to F.
+*/
+{
+  erk_step ( 2, heun_c, heun_a, heun_b, f, n, t, h, x, work, data );
+
+  return;
+}
+/******************************************************************************/
+
+void erk_rk3_step ( ode_rhs *f, int n, double t, double h, double x[],
+  double work[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ERK_RK3_STEP takes one step of Kutta's third order method.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T, H, the time and the step size.
+
+    Input/output, double X[N], the state at T, replaced by the state
+    at T+H.
+
+    Workspace, double WORK[4*N].
+
+    Input, void *DATA, passed to F.
+*/
+{
+  erk_step ( 3, rk3_c, rk3_a, rk3_b, f, n, t, h, x, work, data );
+
+  return;
+}
+/******************************************************************************/
+
+void erk_rk38_step ( ode_rhs *f, int n, double t, double h, double x[],
+  double work[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ERK_RK38_STEP takes one step of Kutta's 3/8 rule.
+
+  Discussion:
+
+    Fourth order, like the classical method, with a slightly smaller
+    error constant and no stage at a repeated node.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T, H, the time and the step size.
+
+    Input/output, double X[N], the state at T, replaced by the state
+    at T+H.
+
+    Workspace, double WORK[5*N].
+
+    Input, void *DATA, passed to F.
+*/
+{
+  erk_step ( 4, rk38_c, rk38_a, rk38_b, f, n, t, h, x, work, data );
+
+  return;
+}
+/******************************************************************************/
+
+void erk_rk4_step ( ode_rhs *f, int n, double t, double h, double x[],
+  double work[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ERK_RK4_STEP takes one step of the classical fourth order method.
+
+  Discussion:
+
+    The same method as RK4_STEP, built from its tableau.  The results
+    agree to rounding, not bit for bit, since the weights are summed in
+    a different order.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T, H, the time and the step size.
+
+    Input/output, double X[N], the state at T, replaced by the state
+    at T+H.
+
+    Workspace, double WORK[5*N].
+
+    Input, void *DATA, passed to F.
+*/
+{
+  erk_step ( 4, rk4_c, rk4_a, rk4_b, f, n, t, h, x, work, data );
+
+  return;
+}
@@ -0,0 +1,197 @@
+/*
+  ERK holds explicit Runge-Kutta steps built from Butcher tableaus:
+
+    ERK_HEUN_STEP  Heun's method, order 2, 2 stages;
+    ERK_RK3_STEP   Kutta's third order method, 3 stages;
+    ERK_RK4_STEP   the classical fourth order method, 4 stages;
+    ERK_RK38_STEP  Kutta's 3/8 rule, order 4, 4 stages.
+
+  Each has the calling sequence of RK4_STEP, but needs S+1 vectors of
+  workspace, WORK[(S+1)*N].
+
+  All of them are the one routine ERK_STEP, called with a tableau of
+  constants.  ERK_STEP is forced inline, so each caller gets its own copy
+  in which the stage count and coefficients are known to the compiler:
+  the stage loops are unrolled, terms with a zero coefficient are never
+  formed, and each stage point X + H * sum A(I,J) K(J) is built in one
+  pass over N.  Another method is a tableau and a three line wrapper:
+
+    static const double c[3] = { ... }, a[3*3] = { ... }, b[3] = { ... };
+
+    void my_step ( ode_rhs *f, int n, double t, double h, double x[],
+      double work[], void *data )
+    {
+      erk_step ( 3, c, a, b, f, n, t, h, x, work, data );
+    }
+
+  A is stored by rows, A(I,J) in A[I*S+J], and only its strictly lower
+  triangle is read.
+*/
+# ifndef ERK_H
+# define ERK_H
+
+# include "ode.h"
+
+# define ERK_MAXSTAGE 16
+
+# ifdef __GNUC__
+# define ERK_INLINE static inline __attribute__ ( ( always_inline ) )
+# define ERK_UNROLL _Pragma ( "GCC unroll 16" )
+# else
+# define ERK_INLINE static inline
+# define ERK_UNROLL
+# endif
+
+void erk_heun_step ( ode_rhs *f, int n, double t, double h, double x[],
+  double work[], void *data );
+void erk_rk3_step ( ode_rhs *f, int n, double t, double h, double x[],
+  double work[], void *data );
+void erk_rk38_step ( ode_rhs *f, int n, double t, double h, double x[],
+  double work[], void *data );
+void erk_rk4_step ( ode_rhs *f, int n, double t, double h, double x[],
+  double work[], void *data );
+/******************************************************************************/
+
+ERK_INLINE int erk_first ( const double w[], int j )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ERK_FIRST is true if W[J] is the first nonzero weight of W.
+
+  Discussion:
+
+    Used to start a sum with its first term instead of adding it to
+    zero, an addition the compiler may not remove.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, const double W[J+1], the weights.
+
+    Input, int J, the index to check.
+
+    Output, int ERK_FIRST, is 1 if W[0:J-1] are all zero.
+*/
+{
+  int i;
+
+  ERK_UNROLL
+  for ( i = 0; i < j; i++ )
+  {
+    if ( w[i] != 0.0 )
+    {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+/******************************************************************************/
+
+ERK_INLINE void erk_step ( int s, const double c[], const double a[],
+  const double b[], ode_rhs *f, int n, double t, double h, double x[],
+  double work[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ERK_STEP takes one step of an explicit Runge-Kutta method.
+
+  Discussion:
+
+    Meant to be called with S, C, A and B compile time constants; the
+    tests on the coefficients then disappear along with the zero terms.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int S, the number of stages, at most ERK_MAXSTAGE.
+
+    Input, const double C[S], A[S*S], B[S], the tableau.
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T, H, the time and the step size.
+
+    Input/output, double X[N], the state at T, replaced by the state
+    at T+H.
+
+    Workspace, double WORK[(S+1)*N], the stages and the stage point.
+
+    Input, void *DATA, passed to F.
+*/
+{
+  int i;
+  int j;
+  double *k[ERK_MAXSTAGE];
+  int p;
+  double sum;
+  double *xs = work + s * n;
+
+  ERK_UNROLL
+  for ( i = 0; i < s; i++ )
+  {
+    k[i] = work + i * n;
+  }
+
+  f ( t, x, k[0], data );
+
+  ERK_UNROLL
+  for ( i = 1; i < s; i++ )
+  {
+    ODE_OMP ( parallel for private ( j, sum ) if ( ODE_PAR_MIN <= n ) )
+    for ( p = 0; p < n; p++ )
+    {
+      sum = 0.0;
+      ERK_UNROLL
+      for ( j = 0; j < i; j++ )
+      {
+        if ( a[i*s+j] != 0.0 )
+        {
+          sum = erk_first ( a + i * s, j ) ? a[i*s+j] * k[j][p]
+            : sum + a[i*s+j] * k[j][p];
+        }
+      }
+      xs[p] = x[p] + h * sum;
+    }
+    f ( t + c[i] * h, xs, k[i], data );
+  }
+
+  ODE_OMP ( parallel for private ( j, sum ) if ( ODE_PAR_MIN <= n ) )
+  for ( p = 0; p < n; p++ )
+  {
+    sum = 0.0;
+    ERK_UNROLL
+    for ( j = 0; j < s; j++ )
+    {
+      if ( b[j] != 0.0 )
+      {
+        sum = erk_first ( b, j ) ? b[j] * k[j][p] : sum + b[j] * k[j][p];
+      }
+    }
+    x[p] = x[p] + h * sum;
+  }
+
+  return;
+}
+
+# endif
@@ -0,0 +1,361 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <math.h>
+# include <float.h>
+
+# include "event.h"
+
+static int event_cross ( double ga, double gb, int direction );
+static double event_locate ( event *e, int i, double a, double ga, double b,
+  double gb );
+
+/******************************************************************************/
+
+int event_advance ( event *e, double tout )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    EVENT_ADVANCE integrates up to TOUT or up to the next event.
+
+  Discussion:
+
+    Events left in the last step are returned before another step is
+    taken, so calling it again after EVENT_HIT goes on where it stopped.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, event *E, the event finder.
+
+    Input, double TOUT, the time to reach.
+
+    Output, int EVENT_ADVANCE, is 0 if E->D reached TOUT, 1 if its step
+    size underflowed, EVENT_HIT for an event, or EVENT_STOP for a
+    terminal one; then E->WHICH, E->TE and E->XE describe the event.
+*/
+{
+  dopri *d = e->d;
+  int i;
+  int j;
+  double t;
+  int which;
+
+  for ( ; ; )
+  {
+    if ( e->pending )
+    {
+/*
+  The earliest crossing between E->TSCAN and the end of the step.
+*/
+      which = -1;
+      for ( i = 0; i < e->m; i++ )
+      {
+        if ( event_cross ( e->gscan[i], e->gend[i], e->direction[i] ) )
+        {
+          t = event_locate ( e, i, e->tscan, e->gscan[i], d->t,
+            e->gend[i] );
+          if ( which < 0 || t < e->te )
+          {
+            which = i;
+            e->te = t;
+          }
+        }
+      }
+
+      if ( 0 <= which )
+      {
+        e->which = which;
+        e->nevent = e->nevent + 1;
+        dopri_eval ( d, e->te, e->xe );
+        e->tscan = e->te;
+        e->g ( e->te, e->xe, e->gscan, e->data );
+        e->ngev = e->ngev + 1;
+
+        if ( !e->terminal[which] )
+        {
+          return EVENT_HIT;
+        }
+/*
+  Cut the step back to the event.  The interpolant no longer holds over
+  [D->TOLD, D->T], so it is left to give the event state only.
+*/
+        for ( j = 0; j < d->n; j++ )
+        {
+          d->x[j] = e->xe[j];
+          d->rcont[j] = e->xe[j];
+        }
+        d->t = e->te;
+        d->told = e->te;
+        d->fsal = 0;
+        e->pending = 0;
+        return EVENT_STOP;
+      }
+
+      e->pending = 0;
+      e->tscan = d->t;
+      for ( i = 0; i < e->m; i++ )
+      {
+        e->gscan[i] = e->gend[i];
+      }
+    }
+
+    if ( tout <= d->t )
+    {
+      return 0;
+    }
+    if ( dopri_step ( d, tout ) != 0 )
+    {
+      return 1;
+    }
+    e->g ( d->t, d->x, e->gend, e->data );
+    e->ngev = e->ngev + 1;
+    e->pending = 1;
+  }
+}
+/******************************************************************************/
+
+event *event_create ( dopri *d, int m, event_fn *g, void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    EVENT_CREATE attaches M event functions to a DOPRI integrator.
+
+  Discussion:
+
+    D->DENSE is switched on.  All events start with DIRECTION 0, both
+    ways, and TERMINAL 0.  E->TTOL, the accuracy of the event times, is
+    0, which means to within rounding of T.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, dopri *D, the integrator, at its starting point.
+
+    Input, int M, the number of event functions.
+
+    Input, event_fn *G, fills the M event functions.
+
+    Input, void *DATA, passed to G.
+
+    Output, event *EVENT_CREATE, the event finder.
+*/
+{
+  event *e;
+  int i;
+
+  e = ( event * ) malloc ( sizeof ( event ) );
+  e->d = d;
+  e->m = m;
+  e->g = g;
+  e->data = data;
+  e->direction = ( int * ) malloc ( 2 * m * sizeof ( int ) );
+  e->terminal = e->direction + m;
+  e->gscan = ( double * ) malloc ( 3 * m * sizeof ( double ) );
+  e->gend = e->gscan + m;
+  e->gc = e->gend + m;
+  e->xe = ( double * ) malloc ( d->n * sizeof ( double ) );
+  for ( i = 0; i < m; i++ )
+  {
+    e->direction[i] = 0;
+    e->terminal[i] = 0;
+  }
+  e->ttol = 0.0;
+  e->pending = 0;
+  e->te = d->t;
+  e->which = -1;
+  e->ngev = 1;
+  e->nevent = 0;
+
+  d->dense = 1;
+  e->tscan = d->t;
+  g ( d->t, d->x, e->gscan, data );
+
+  return e;
+}
+/******************************************************************************/
+
+static int event_cross ( double ga, double gb, int direction )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    EVENT_CROSS decides if an event function crossed zero.
+
+  Discussion:
+
+    A function that starts at zero has not crossed; one that ends at zero
+    has, so a root met exactly is reported once.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double GA, GB, the values at the start and end of the interval.
+
+    Input, int DIRECTION, +1 for upward crossings only, -1 for downward
+    ones only, 0 for both.
+
+    Output, int EVENT_CROSS, is 1 if it crossed.
+*/
+{
+  if ( direction >= 0 && ga < 0.0 && 0.0 <= gb )
+  {
+    return 1;
+  }
+  if ( direction <= 0 && 0.0 < ga && gb <= 0.0 )
+  {
+    return 1;
+  }
+  return 0;
+}
+/******************************************************************************/
+
+void event_free ( event *e )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    EVENT_FREE frees an event finder, but not its integrator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, event *E, the event finder.
+*/
+{
+  free ( e->direction );
+  free ( e->gscan );
+  free ( e->xe );
+  free ( e );
+
+  return;
+}
+/******************************************************************************/
+
+static double event_locate ( event *e, int i, double a, double ga, double b,
+  double gb )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    EVENT_LOCATE finds where event function I crosses zero in [A,B].
+
+  Discussion:
+
+    The Illinois method: regula falsi, except that when the same end of
+    the bracket is kept twice running, the value at the other end is
+    halved, which restores superlinear convergence.  The bracket is
+    always kept, so the method cannot fail.
+
+    The right end of the final bracket is returned, where G has already
+    crossed, so the same crossing is not found again when the search
+    goes on from there.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    M Dowell, P Jarratt,
+    A modified regula falsi method for computing the root of an equation,
+    BIT, Volume 11, 1971, pages 168-174.
+
+  Parameters:
+
+    Input/output, event *E, the event finder; E->XE is used as workspace.
+
+    Input, int I, the event function.
+
+    Input, double A, GA, B, GB, the bracket, with GA and GB the values of
+    G[I] at its ends, of opposite signs or with GB zero.
+
+    Output, double EVENT_LOCATE, the crossing time.
+*/
+{
+  double c;
+  double gc;
+  int it;
+  int side;
+  double tol;
+
+  side = 0;
+  for ( it = 0; it < EVENT_MAXIT && gb != 0.0; it++ )
+  {
+    tol = fmax ( e->ttol, 4.0 * DBL_EPSILON * fmax ( fabs ( a ), fabs ( b ) ) );
+    if ( b - a <= tol )
+    {
+      break;
+    }
+    c = ( a * gb - b * ga ) / ( gb - ga );
+    if ( c <= a || b <= c )
+    {
+      c = 0.5 * ( a + b );
+    }
+    dopri_eval ( e->d, c, e->xe );
+    e->g ( c, e->xe, e->gc, e->data );
+    e->ngev = e->ngev + 1;
+    gc = e->gc[i];
+
+    if ( ( ga < 0.0 ) == ( gc < 0.0 ) && gc != 0.0 )
+    {
+      a = c;
+      ga = gc;
+      if ( side == -1 )
+      {
+        gb = 0.5 * gb;
+      }
+      side = -1;
+    }
+    else
+    {
+      b = c;
+      gb = gc;
+      if ( side == 1 )
+      {
+        ga = 0.5 * ga;
+      }
+      side = 1;
+    }
+  }
+
+  return b;
+}
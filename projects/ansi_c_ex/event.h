@@ -0,0 +1,67 @@
+/*
+  EVENT finds the times at which a DOPRI integration crosses surfaces
+  G(T,X) = 0, such as a zero displacement for measuring a period:
+
+    d = dopri_create ( f, n, t, x, atol, rtol, data );
+    e = event_create ( d, m, g, gdata );
+    e->direction[0] = 1;          only upward crossings of G[0]
+    e->terminal[1] = 1;           stop at the first crossing of G[1]
+    while ( ( r = event_advance ( e, tout ) ) == EVENT_HIT )
+    {
+      ...                         G[e->which] crossed at e->te, state e->xe
+    }
+    if ( r == EVENT_STOP ) ...    the same, and the integration ends there
+    event_free ( e );
+    dopri_free ( d );
+
+  The event function G ( T, X, G, DATA ) fills G[0:M-1].  After each
+  accepted step G is evaluated at its end; a change of sign, in the
+  direction asked for, is located inside the step by the Illinois
+  variant of regula falsi on the dense output, so no right hand side
+  evaluations are spent on it.  When several G change sign in one step
+  the events are returned in time order, one per call.
+
+  A terminal event cuts D back to the event: D->T = E->TE and D->X is
+  the state there, so the integration may go on from it, for instance
+  after changing D->X.
+
+  A G that changes sign twice within one step is not seen; D->HMAX
+  bounds the step if that matters.
+*/
+# ifndef EVENT_H
+# define EVENT_H
+
+# include "ode.h"
+
+# define EVENT_HIT 2
+# define EVENT_STOP 3
+# define EVENT_MAXIT 100
+
+typedef void event_fn ( double t, double x[], double g[], void *data );
+
+typedef struct
+{
+  dopri *d;
+  int m;
+  event_fn *g;
+  void *data;
+  int *direction;
+  int *terminal;
+  double ttol;
+  int pending;
+  double tscan;
+  double *gscan;
+  double *gend;
+  double *gc;
+  double *xe;
+  double te;
+  int which;
+  long ngev;
+  long nevent;
+} event;
+
+int event_advance ( event *e, double tout );
+event *event_create ( dopri *d, int m, event_fn *g, void *data );
+void event_free ( event *e );
+
+# endif
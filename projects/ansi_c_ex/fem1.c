@@ -3,8 +3,11 @@
 # include <stdlib.h>
 # include <stdio.h>
 # include <math.h>
+# include <string.h>
 # include <time.h>
 
+# include "shoot.h"
+
 double *fem1d_bvp_linear ( int n, double a ( double x ), double c ( double x ), 
   double f ( double x ), double x[] );
 int *i4vec_zero_new ( int n );
@@ -748,15 +751,21 @@ void timestamp ( void )
 # undef TIME_SIZE
 }
 
-int main ( void );
+int main ( int argc, char *argv[] );
+void fem1d_bvp_linear_report ( int n, double x[], double u[], 
+  double exact ( double x ) );
 void fem1d_bvp_linear_test01 ( void );
 void fem1d_bvp_linear_test02 ( void );
 void fem1d_bvp_linear_test03 ( void );
 void fem1d_bvp_linear_test04 ( void );
 void fem1d_bvp_linear_test05 ( void );
+void fem1d_bvp_linear_test06 ( void );
 double a1 ( double x );
 double a2 ( double x );
 double a3 ( double x );
+double a4 ( double x );
+double a5 ( double x );
+double bratu_theta ( double lambda );
 double c1 ( double x );
 double c2 ( double x );
 double c3 ( double x );
@@ -765,13 +774,39 @@ double f2 ( double x );
 double f3 ( double x );
 double f4 ( double x );
 double f5 ( double x );
+double f6 ( double x );
 double exact1 ( double x );
 double exact2 ( double x );
 double exact3 ( double x );
+void shoot_bratu_jvp ( double x, double y[], double v[], int j, double jv[], 
+  void *data );
+void shoot_bratu_rhs ( double x, double y[], double yp[], void *data );
+void shoot_fem_bc ( double ya[], double yb[], double r[], void *data );
+void shoot_fem_jvp ( double x, double y[], double v[], int j, double jv[], 
+  void *data );
+void shoot_fem_rhs ( double x, double y[], double yp[], void *data );
+/*
+  The coefficients of one problem, passed to the SHOOT_FEM routines.
+*/
+typedef struct
+{
+  double ( *a ) ( double x );
+  double ( *c ) ( double x );
+  double ( *f ) ( double x );
+} fem1d_coef;
+/*
+  QUIET is set by the -quiet option.  The tests then report only the
+  maximum error, rather than printing every node.
+*/
+int quiet = 0;
+/*
+  SHOOT_THREADS is set by the -shoot option, which adds TEST06.
+*/
+int shoot_threads = 0;
 
 /******************************************************************************/
 
-int main ( void )
+int main ( int argc, char *argv[] )
 
 /******************************************************************************/
 /*
@@ -779,6 +814,23 @@ int main ( void )
 
     FEM1D_BVP_LINEAR_PRB tests the routines in FEM1D_BVP_LINEAR.
 
+  Usage:
+
+    fem1 [-quiet] [-shoot THREADS]
+
+    With -quiet, each test prints its maximum error instead of a table
+    of the solution at every node.
+
+    With -shoot, TEST06 also solves the problems of the other tests, and
+    those with the exact solutions EXACT2 and EXACT3, by multiple
+    shooting on THREADS threads, and compares the two methods; it then
+    solves the nonlinear Bratu problem, which FEM1D_BVP_LINEAR cannot,
+    by shooting alone.
+
+    The program is built with
+
+      gcc -O3 -o fem1 fem1.c ode.c pool.c sens.c shoot.c sink.c -lm -lpthread
+
   Licensing:
 
     This code is distributed under the GNU LGPL license.
@@ -792,6 +844,21 @@ int main ( void )
     John Burkardt
 */
 {
+  int i;
+
+  for ( i = 1; i < argc; i++ )
+  {
+    if ( strcmp ( argv[i], "-quiet" ) == 0 )
+    {
+      quiet = 1;
+    }
+    else if ( strcmp ( argv[i], "-shoot" ) == 0 && i + 1 < argc )
+    {
+      shoot_threads = atoi ( argv[i+1] );
+      i = i + 1;
+    }
+  }
+
   timestamp ( );
   printf ( "\n" );
   printf ( "FEM1D_BVP_LINEAR_PRB\n" );
@@ -802,6 +869,10 @@ int main ( void )
   fem1d_bvp_linear_test03 ( );
   fem1d_bvp_linear_test04 ( );
   fem1d_bvp_linear_test05 ( );
+  if ( 0 < shoot_threads )
+  {
+    fem1d_bvp_linear_test06 ( );
+  }
 /*
   Terminate.
 */
@@ -816,6 +887,75 @@ int main ( void )
 }
 /******************************************************************************/
 
+void fem1d_bvp_linear_report ( int n, double x[], double u[], 
+  double exact ( double x ) )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FEM1D_BVP_LINEAR_REPORT compares a computed solution to the exact one.
+
+  Discussion:
+
+    Normally a table of the solution and its error at every node is
+    printed.  If QUIET is set, only the maximum error is printed.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int N, the number of nodes.
+
+    Input, double X[N], the mesh points.
+
+    Input, double U[N], the computed solution at the mesh points.
+
+    Input, double EXACT ( double X ), evaluates the exact solution.
+*/
+{
+  double error;
+  double error_max;
+  int i;
+  double uexact;
+
+  if ( quiet )
+  {
+    error_max = 0.0;
+    for ( i = 0; i < n; i++ )
+    {
+      error = r8_abs ( u[i] - exact ( x[i] ) );
+      if ( error_max < error )
+      {
+        error_max = error;
+      }
+    }
+    printf ( "\n" );
+    printf ( "  Maximum error = %14e\n", error_max );
+    return;
+  }
+
+  printf ( "\n" );
+  printf ( "     I    X         U         Uexact    Error\n" );
+  printf ( "\n" );
+
+  for ( i = 0; i < n; i++ )
+  {
+    uexact = exact ( x[i] );
+    printf ( "  %4d  %8f  %14f  %14f %14e\n", 
+      i, x[i], u[i], uexact, r8_abs ( u[i] - uexact ) );
+  }
+
+  return;
+}
+/******************************************************************************/
+
 void fem1d_bvp_linear_test01 ( void )
 
 /******************************************************************************/
@@ -841,10 +981,8 @@ void fem1d_bvp_linear_test01 ( void )
     John Burkardt
 */
 {
-  int i;
   int n = 11;
   double *u;
-  double uexact;
   double *x;
   double x_first;
   double x_last;
@@ -866,16 +1004,7 @@ void fem1d_bvp_linear_test01 ( void )
 
   u = fem1d_bvp_linear ( n, a1, c1, f1, x );
 
-  printf ( "\n" );
-  printf ( "     I    X         U         Uexact    Error\n" );
-  printf ( "\n" );
-
-  for ( i = 0; i < n; i++ )
-  {
-    uexact = exact1 ( x[i] );
-    printf ( "  %4d  %8f  %14f  %14f %14e\n", 
-      i, x[i], u[i], uexact, r8_abs ( u[i] - uexact ) );
-  }
+  fem1d_bvp_linear_report ( n, x, u, exact1 );
 
   free ( u );
   free ( x );
@@ -909,10 +1038,8 @@ void fem1d_bvp_linear_test02 ( void )
     John Burkardt
 */
 {
-  int i;
   int n = 11;
   double *u;
-  double uexact;
   double *x;
   double x_first;
   double x_last;
@@ -934,16 +1061,7 @@ void fem1d_bvp_linear_test02 ( void )
 
   u = fem1d_bvp_linear ( n, a1, c2, f2, x );
 
-  printf ( "\n" );
-  printf ( "     I    X         U         Uexact    Error\n" );
-  printf ( "\n" );
-
-  for ( i = 0; i < n; i++ )
-  {
-    uexact = exact1 ( x[i] );
-    printf ( "  %4d  %8f  %14f  %14f %14e\n", 
-      i, x[i], u[i], uexact, r8_abs ( u[i] - uexact ) );
-  }
+  fem1d_bvp_linear_report ( n, x, u, exact1 );
 
   free ( u );
   free ( x );
@@ -977,10 +1095,8 @@ void fem1d_bvp_linear_test03 ( void )
     John Burkardt
 */
 {
-  int i;
   int n = 11;
   double *u;
-  double uexact;
   double *x;
   double x_first;
   double x_last;
@@ -1002,16 +1118,7 @@ void fem1d_bvp_linear_test03 ( void )
 
   u = fem1d_bvp_linear ( n, a1, c3, f3, x );
 
-  printf ( "\n" );
-  printf ( "     I    X         U         Uexact    Error\n" );
-  printf ( "\n" );
-
-  for ( i = 0; i < n; i++ )
-  {
-    uexact = exact1 ( x[i] );
-    printf ( "  %4d  %8f  %14f  %14f %14e\n", 
-      i, x[i], u[i], uexact, r8_abs ( u[i] - uexact ) );
-  }
+  fem1d_bvp_linear_report ( n, x, u, exact1 );
 
   free ( u );
   free ( x );
@@ -1045,10 +1152,8 @@ void fem1d_bvp_linear_test04 ( void )
     John Burkardt
 */
 {
-  int i;
   int n = 11;
   double *u;
-  double uexact;
   double *x;
   double x_first;
   double x_last;
@@ -1070,16 +1175,7 @@ void fem1d_bvp_linear_test04 ( void )
 
   u = fem1d_bvp_linear ( n, a2, c1, f4, x );
 
-  printf ( "\n" );
-  printf ( "     I    X         U         Uexact    Error\n" );
-  printf ( "\n" );
-
-  for ( i = 0; i < n; i++ )
-  {
-    uexact = exact1 ( x[i] );
-    printf ( "  %4d  %8f  %14f  %14f %14e\n", 
-      i, x[i], u[i], uexact, r8_abs ( u[i] - uexact ) );
-  }
+  fem1d_bvp_linear_report ( n, x, u, exact1 );
 
   free ( u );
   free ( x );
@@ -1113,10 +1209,8 @@ void fem1d_bvp_linear_test05 ( )
     John Burkardt
 */
 {
-  int i;
   int n = 11;
   double *u;
-  double uexact;
   double *x;
   double x_first;
   double x_last;
@@ -1142,18 +1236,177 @@ void fem1d_bvp_linear_test05 ( )
 
   u = fem1d_bvp_linear ( n, a3, c1, f5, x );
 
+  fem1d_bvp_linear_report ( n, x, u, exact1 );
+
+  free ( u );
+  free ( x );
+
+  return;
+}
+/******************************************************************************/
+
+void fem1d_bvp_linear_test06 ( void )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FEM1D_BVP_LINEAR_TEST06 checks the finite element method against
+    multiple shooting.
+
+  Discussion:
+
+    The problems of tests 1 to 5 are solved again, with two more whose
+    diffusion coefficient jumps at X = 2/3:
+
+      A4, C1, F6, EXACT2;
+      A5, C1, F6, EXACT3.
+
+    Written as the first order system U' = W / A, W' = C U - F for U and
+    the flux W = A U', each problem has U(0) = U(1) = 0, and is solved by
+    SHOOT with one segment per element and 30 RK4 steps per segment, so
+    the steps land on the jumps of A and F at 1/3 and 2/3.
+
+    For smooth data RK4 is fourth order, and the shooting error at the
+    nodes is near roundoff, against H^2 for finite elements.  A jump in
+    the data is sampled by one RK4 stage on the wrong side, which costs
+    an error of order H times the jump: so cases 5 and 6 converge only
+    at first order, though still well below the finite element error.
+    EXACT3 itself jumps at 2/3, so it is not the solution of any problem
+    of this form, and both methods miss it by about half of its jump;
+    case 7 is listed to show this.
+
+    Those problems are linear, so Newton's method ends after one step.
+    Cases 8 to 10 are the nonlinear Bratu problem
+
+      U'' + LAMBDA * exp ( U ) = 0,  U(0) = U(1) = 0,
+
+    with the exact solution on its lower branch
+
+      U(X) = - 2 log ( cosh ( ( X - 1/2 ) THETA / 2 ) / cosh ( THETA / 4 ) )
+
+    where THETA = sqrt ( 2 LAMBDA ) cosh ( THETA / 4 ); see BRATU_THETA.
+    Solutions exist only for LAMBDA below about 3.5138, and as LAMBDA
+    gets near that limit the Newton iteration from U = 0 needs more
+    steps.  Case 10 is LAMBDA = 1 again, from U = 2 sin ( PI X ), well
+    above the solution, where a full Newton step would raise the defect
+    and has to be halved.  From still higher guesses, Newton's method
+    finds the upper branch instead, which has no closed form.  The finite element code is linear,
+    and has no column for these cases.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+*/
+{
+  double ( *a[7] ) ( double x ) = { a1, a1, a1, a2, a3, a4, a5 };
+  double ( *c[7] ) ( double x ) = { c1, c2, c3, c1, c1, c1, c1 };
+  double error_fem;
+  double error_shoot;
+  double ( *exact[7] ) ( double x ) = 
+    { exact1, exact1, exact1, exact1, exact1, exact2, exact3 };
+  double ( *f[7] ) ( double x ) = { f1, f2, f3, f4, f5, f6, f6 };
+  fem1d_coef coef;
+  int i;
+  int j;
+  double lambda;
+  int n = 11;
+  const double pi = 3.141592653589793;
+  shoot *sh;
+  int status;
+  double theta;
+  double *u;
+  double ue;
+  double us;
+  double *x;
+
   printf ( "\n" );
-  printf ( "     I    X         U         Uexact    Error\n" );
+  printf ( "FEM1D_BVP_LINEAR_TEST06\n" );
+  printf ( "  Finite elements against multiple shooting.\n" );
+  printf ( "  A4(X)  = 1.0 for X <= 2/3, 1/3 for 2/3 < X\n" );
+  printf ( "  A5(X)  = 1.0 for X <= 2/3, exp ( 2/3 ) / 3 for 2/3 < X\n" );
+  printf ( "  F6(X)  = F1(X) for X <= 2/3, 2/3 exp ( 2/3 ) for 2/3 < X\n" );
+  printf ( "\n" );
+  printf ( "  Number of nodes = %d\n", n );
+  printf ( "  Shooting threads = %d\n", shoot_threads );
+  printf ( "\n" );
+  printf ( "  Case  Exact   FEM error       Shooting error  Newton  Halved  Defect\n" );
   printf ( "\n" );
 
-  for ( i = 0; i < n; i++ )
+  x = r8vec_even ( n, 0.0, 1.0 );
+
+  for ( i = 0; i < 7; i++ )
   {
-    uexact = exact1 ( x[i] );
-    printf ( "  %4d  %8f  %14f  %14f %14e\n", 
-      i, x[i], u[i], uexact, r8_abs ( u[i] - uexact ) );
+    u = fem1d_bvp_linear ( n, a[i], c[i], f[i], x );
+
+    coef.a = a[i];
+    coef.c = c[i];
+    coef.f = f[i];
+    sh = shoot_create ( shoot_fem_rhs, shoot_fem_jvp, shoot_fem_bc, 2, 
+      0.0, 1.0, n - 1, 30, &coef );
+    sh->nthread = shoot_threads;
+    status = shoot_run ( sh );
+
+    error_fem = 0.0;
+    error_shoot = 0.0;
+    for ( j = 0; j < n; j++ )
+    {
+      error_fem = fmax ( error_fem, r8_abs ( u[j] - exact[i] ( x[j] ) ) );
+      us = ( j < n - 1 ) ? sh->s[2*j] : sh->phi[2*(n-2)];
+      error_shoot = fmax ( error_shoot, r8_abs ( us - exact[i] ( x[j] ) ) );
+    }
+    printf ( "  %4d  %5d  %14e  %14e  %6d  %6d  %e%s\n", i + 1, 
+      ( i < 5 ) ? 1 : i - 3, error_fem, error_shoot, sh->iter, sh->nhalf,
+      sh->res, ( status == 0 ) ? "" : "  not converged" );
+
+    shoot_free ( sh );
+    free ( u );
+  }
+/*
+  The Bratu problem, LAMBDA = 1 and 3.5 from U = 0, and 1 from
+  U = 2 sin ( PI X ).
+*/
+  printf ( "\n" );
+  printf ( "  Case  Lambda                  Shooting error  Newton  Halved  Defect\n" );
+  printf ( "\n" );
+
+  for ( i = 0; i < 3; i++ )
+  {
+    lambda = ( i == 1 ) ? 3.5 : 1.0;
+    theta = bratu_theta ( lambda );
+
+    sh = shoot_create ( shoot_bratu_rhs, shoot_bratu_jvp, shoot_fem_bc, 2, 
+      0.0, 1.0, n - 1, 30, &lambda );
+    sh->nthread = shoot_threads;
+    if ( i == 2 )
+    {
+      for ( j = 0; j < n - 1; j++ )
+      {
+        sh->s[2*j] = 2.0 * sin ( pi * x[j] );
+        sh->s[2*j+1] = 2.0 * pi * cos ( pi * x[j] );
+      }
+    }
+    status = shoot_run ( sh );
+
+    error_shoot = 0.0;
+    for ( j = 0; j < n; j++ )
+    {
+      us = ( j < n - 1 ) ? sh->s[2*j] : sh->phi[2*(n-2)];
+      ue = - 2.0 * log ( cosh ( ( x[j] - 0.5 ) * theta / 2.0 ) 
+        / cosh ( theta / 4.0 ) );
+      error_shoot = fmax ( error_shoot, r8_abs ( us - ue ) );
+    }
+    printf ( "  %4d  %6g                  %14e  %6d  %6d  %e%s\n", i + 8, 
+      lambda, error_shoot, sh->iter, sh->nhalf, sh->res, 
+      ( status == 0 ) ? "" : "  not converged" );
+
+    shoot_free ( sh );
   }
 
-  free ( u );
   free ( x );
 
   return;
@@ -1272,6 +1525,138 @@ double a3 ( double x )
 }
 /******************************************************************************/
 
+double a4 ( double x )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    A4 evaluates A function #4.
+
+  Discussion:
+
+    With C1 and F6, the exact solution is EXACT2: the jump in A keeps
+    the flux A U' continuous across the kink of EXACT2 at X = 2/3.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double X, the evaluation point.
+
+    Output, double A4, the value of A(X).
+*/
+{
+  double value;
+
+  if ( x <= 2.0 / 3.0 )
+  {
+    value = 1.0;
+  }
+  else
+  {
+    value = 1.0 / 3.0;
+  }
+
+  return value;
+}
+/******************************************************************************/
+
+double a5 ( double x )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    A5 evaluates A function #5.
+
+  Discussion:
+
+    With C1 and F6 this keeps the flux continuous across the kink of
+    the left piece of EXACT3, X * ( 1 - X ) * exp ( X ), at X = 2/3 and
+    the right piece X * ( 1 - X ); but EXACT3 jumps there, so it is not
+    the solution.  See TEST06.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double X, the evaluation point.
+
+    Output, double A5, the value of A(X).
+*/
+{
+  double value;
+
+  if ( x <= 2.0 / 3.0 )
+  {
+    value = 1.0;
+  }
+  else
+  {
+    value = exp ( 2.0 / 3.0 ) / 3.0;
+  }
+
+  return value;
+}
+/******************************************************************************/
+
+double bratu_theta ( double lambda )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    BRATU_THETA returns the constant of the exact Bratu solution.
+
+  Discussion:
+
+    THETA is the smaller root of THETA = sqrt ( 2 LAMBDA ) cosh ( THETA / 4 ),
+    found by Newton's method from 0, which approaches it from below.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, double LAMBDA, the parameter, between 0 and about 3.5138.
+
+    Output, double BRATU_THETA, the root.
+*/
+{
+  double a;
+  int it;
+  double theta;
+
+  a = sqrt ( 2.0 * lambda );
+  theta = 0.0;
+
+  for ( it = 0; it < 100; it++ )
+  {
+    theta = theta - ( theta - a * cosh ( theta / 4.0 ) ) 
+      / ( 1.0 - a * sinh ( theta / 4.0 ) / 4.0 );
+  }
+  return theta;
+}
+/******************************************************************************/
+
 double c1 ( double x )
 
 /******************************************************************************/
@@ -1560,6 +1945,44 @@ double f5 ( double x )
 }
 /******************************************************************************/
 
+double f6 ( double x )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    F6 evaluates right hand side function #6.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double X, the evaluation point.
+
+    Output, double F6, the value of F(X).
+*/
+{
+  double value;
+
+  if ( x <= 2.0 / 3.0 )
+  {
+    value = x * ( x + 3.0 ) * exp ( x );
+  }
+  else
+  {
+    value = 2.0 / 3.0 * exp ( 2.0 / 3.0 );
+  }
+
+  return value;
+}
+/******************************************************************************/
+
 double exact1 ( double x )
 
 /******************************************************************************/
@@ -1674,4 +2097,186 @@ double exact3 ( double x )
     value = x * ( 1.0 - x );
   }
   return value;
-}
\ No newline at end of file
+}
+/******************************************************************************/
+
+void shoot_bratu_jvp ( double x, double y[], double v[], int j, double jv[], 
+  void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_BRATU_JVP multiplies the Jacobian of SHOOT_BRATU_RHS by a vector.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, double X, Y[2], the point.
+
+    Input, double V[2], the vector.
+
+    Input, int J, the parameter, always a starting value, not used.
+
+    Output, double JV[2], the product.
+
+    Input, void *DATA, the double LAMBDA.
+*/
+{
+  double lambda = *( double * ) data;
+
+  jv[0] = v[1];
+  jv[1] = - lambda * exp ( y[0] ) * v[0];
+
+  return;
+}
+/******************************************************************************/
+
+void shoot_bratu_rhs ( double x, double y[], double yp[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_BRATU_RHS is U'' + LAMBDA exp ( U ) = 0 as a first order system.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, double X, the point.
+
+    Input, double Y[2], U and U'.
+
+    Output, double YP[2], their derivatives.
+
+    Input, void *DATA, the double LAMBDA.
+*/
+{
+  double lambda = *( double * ) data;
+
+  yp[0] = y[1];
+  yp[1] = - lambda * exp ( y[0] );
+
+  return;
+}
+/******************************************************************************/
+
+void shoot_fem_bc ( double ya[], double yb[], double r[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_FEM_BC evaluates the boundary conditions U(0) = U(1) = 0.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double YA[2], YB[2], U and A U' at 0 and at 1.
+
+    Output, double R[2], the residuals.
+
+    Input, void *DATA, not used.
+*/
+{
+  r[0] = ya[0];
+  r[1] = yb[0];
+
+  return;
+}
+/******************************************************************************/
+
+void shoot_fem_jvp ( double x, double y[], double v[], int j, double jv[], 
+  void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_FEM_JVP multiplies the Jacobian of SHOOT_FEM_RHS by a vector.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double X, Y[2], the point.
+
+    Input, double V[2], the vector.
+
+    Input, int J, the parameter, always a starting value, not used.
+
+    Output, double JV[2], the product.
+
+    Input, void *DATA, the fem1d_coef.
+*/
+{
+  fem1d_coef *coef = ( fem1d_coef * ) data;
+
+  jv[0] = v[1] / coef->a ( x );
+  jv[1] = coef->c ( x ) * v[0];
+
+  return;
+}
+/******************************************************************************/
+
+void shoot_fem_rhs ( double x, double y[], double yp[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_FEM_RHS is -(A U')' + C U = F as a first order system.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double X, the point.
+
+    Input, double Y[2], U and the flux A U'.
+
+    Output, double YP[2], their derivatives.
+
+    Input, void *DATA, the fem1d_coef.
+*/
+{
+  fem1d_coef *coef = ( fem1d_coef * ) data;
+
+  yp[0] = y[1] / coef->a ( x );
+  yp[1] = coef->c ( x ) * y[0] - coef->f ( x );
+
+  return;
+}
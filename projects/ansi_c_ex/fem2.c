@@ -1,31 +1,150 @@
 # include <stdlib.h>
 # include <stdio.h>
+# include <math.h>
+# include <string.h>
 # include <time.h>
 
-int main ( void );
+# include "mol.h"
+# include "ode.h"
+# include "rkc.h"
+# include "sink.h"
+
+/*
+  INCR_DATA holds the state of the incremental solver.  See INCR_CREATE.
+*/
+typedef struct
+{
+  double *coef;
+  double *h;
+  int *indx;
+  int nl;
+  int *node;
+  int nu;
+  int nquad;
+  int nsub;
+  double ul;
+  double ur;
+  double *xn;
+  double *xquad;
+/*
+  The current system, and the base system whose factors are kept.
+*/
+  double *adiag;
+  double *aleft;
+  double *arite;
+  double *f;
+  double *adiag0;
+  double *aleft0;
+  double *arite0;
+  double *f0;
+/*
+  Forward and backward Thomas factors of the base matrix, and the
+  base solution.
+*/
+  double *dpiv;
+  double *rfac;
+  double *epiv;
+  double *lfac;
+  double *u0;
+/*
+  The diagonal of the inverse of the base matrix, and the running
+  products of the factors, kept as mantissa and exponent, that give
+  its other entries.
+*/
+  double *gdiag;
+  double *pman;
+  double *qman;
+  int *pexp;
+  int *qexp;
+  int *pseg;
+  int *qseg;
+/*
+  The stored contribution of each element, and the list of changed
+  elements, each flagged in DIRTY so that it is listed once.
+*/
+  double *elem;
+  int *dirty;
+  int *list;
+  int ndirty;
+/*
+  The M unknowns of S in increasing order, the position of each unknown
+  in S or -1, and the coefficients W of the correction.
+*/
+  int m;
+  int mmax;
+  int mcap;
+  int *pos;
+  int *set;
+  double *w;
+} incr_data;
+
+int main ( int argc, char *argv[] );
 void assemble ( double adiag[], double aleft[], double arite[], double f[], 
-  double h[], int indx[], int nl, int node[], int nu, int nquad, int nsub, 
-  double ul, double ur, double xn[], double xquad[] );
+  double coef[], double h[], int indx[], int nl, int node[], int nu, 
+  int nquad, int nsub, double ul, double ur, double xn[], double xquad[] );
+void assemble_add ( double adiag[], double aleft[], double arite[], double f[], 
+  double ae[], int ie, int indx[], int nl, int node[] );
+void assemble_block ( int nb, double adiag[], double aleft[], double arite[], 
+  double f[], double h[], int indx[], int nl, int node[], int nu, int nquad, 
+  int nsub, double ul[], double ur[], double xn[], double xquad[] );
+void assemble_element ( double ae[], double coef[], double h[], int ie, 
+  int indx[], int nl, int node[], int nquad, int nsub, double ul, double ur, 
+  double xn[], double xquad[] );
+static inline int block_lu ( int nb, double a[], int piv[] );
+static inline void block_lu_solve ( int nb, double a[], int piv[], double x[] );
+static inline int block_thomas ( int nb, int nu, double adiag[], 
+  double aleft[], double arite[], double f[], int piv[] );
 double ff ( double x );
+void ffb ( double x, int nb, double f[] );
 void geometry ( double h[], int ibc, int indx[], int nl, int node[], int nsub, 
   int *nu, double xl, double xn[], double xquad[], double xr );
+void geometry_print ( double h[], int indx[], int node[], int nsub, int nu, 
+  double xn[], double xquad[] );
+incr_data *incr_create ( double coef[], double h[], int indx[], int nl, 
+  int node[], int nu, int nquad, int nsub, double ul, double ur, double xn[], 
+  double xquad[] );
+int incr_design ( int niter, double h[], int indx[], int nl, int node[], 
+  int nu, int nquad, int nsub, double ul, double ur, double xn[], 
+  double xquad[], int verbose, double u[] );
+int incr_factor ( incr_data *s );
+void incr_free ( incr_data *s );
+double incr_inverse ( incr_data *s, int i, int j );
+void incr_mark ( incr_data *s, int ie_lo, int ie_hi );
+void incr_product ( double man, int ex, int seg, double factor, double *man2, 
+  int *ex2, int *seg2 );
+void incr_solution ( incr_data *s, double u[] );
+int incr_solve ( incr_data *s );
+double incr_value ( incr_data *s, int iu );
 void init ( int *ibc, int *nquad, double *ul, double *ur, double *xl, 
   double *xr );
+void init_print ( int ibc, int nquad, double ul, double ur, double xl, 
+  double xr );
 void output ( double f[], int ibc, int indx[], int nsub, int nu, double ul, 
   double ur, double xn[] );
+void output_block ( sink *s, int nb, double f[], int ibc, int indx[], 
+  int nsub, double ul[], double ur[], double xn[] );
+void output_sink ( sink *s, double f[], int ibc, int indx[], int nsub, 
+  double ul, double ur, double xn[] );
+double output_value ( double f[], int ibc, int indx[], int i, int nsub, 
+  double ul, double ur );
 void phi ( int il, double x, double *phii, double *phiix, double xleft, 
   double xrite );
 double pp ( double x );
+void ppb ( double x, int nb, double p[] );
 void prsys ( double adiag[], double aleft[], double arite[], double f[], 
   int nu );
 double qq ( double x );
+void qqb ( double x, int nb, double q[] );
+int r8mat_fs ( int n, double a[], double x[] );
 void solve ( double adiag[], double aleft[], double arite[], double f[], 
   int nu );
+int solve_block ( int nb, int nu, double adiag[], double aleft[], 
+  double arite[], double f[] );
 void timestamp ( void );
 
 /******************************************************************************/
 
-int main ( void )
+int main ( int argc, char *argv[] )
 
 /******************************************************************************/
 /*
@@ -57,6 +176,45 @@ int main ( void )
     having endpoints XN(0) and XN(1), and so on up to interval
     NSUB, which has endpoints XN(NSUB-1) and XN(NSUB).
 
+  Usage:
+
+    fem2 [-n NSUB] [-block NB] [-mol T [-rkc NSTEP]] [-incr NITER]
+         [-table | -quiet | -summary | -csv FILE | -bin FILE | -traj FILE]
+
+    -n NSUB    the number of subintervals, 5 by default.
+    -block NB  solve the system of NB coupled equations defined by
+               PPB, QQB and FFB instead; see ASSEMBLE_BLOCK.
+    -table     print the geometry, the linear system and the solution
+               as tables.  This is the default.
+    -quiet     print nothing, not even the reports of -mol and -incr.
+    -summary   print only the range of the solution.
+    -csv FILE  write node, X and U to FILE as comma separated text.
+    -bin FILE  write node, X and U to FILE as little-endian doubles.
+    -traj FILE write node, X and U to FILE as a chunked binary file, with
+               its column names, that TRAJ_OPEN reads in place; TRAJ_FIND
+               then looks nodes up by X.
+    -mol T     solve the transient problem M U' = F - K U instead, with
+               the lumped mass matrix M, from U = 0 to time T, by the
+               method of lines: MOL_RHS is stepped by RK4 at the
+               largest stable step, from the Gershgorin bound on the
+               spectral radius.  The solution at T is reported, with its
+               distance from the steady solution.
+    -rkc NSTEP with -mol, take NSTEP steps of RKC instead, each with as
+               many stages as its stability needs.
+    -incr NITER run a design loop of NITER iterations, each changing PP
+               and QQ over a few elements and updating the solution by
+               INCR_SOLVE, checked against a full solve; see INCR_DESIGN.
+               The solution for the final coefficients is reported.
+
+    Only the -table mode prints the linear system, so the other modes
+    can be used on meshes with millions of nodes.
+
+    The program is built with
+
+      gcc -O3 -o fem2 fem2.c mol.c ode.c rkc.c sink.c -lm -lpthread
+
+    where -O3 lets the compiler unroll the block kernels of SOLVE_BLOCK.
+
   Licensing:
 
     This code is distributed under the GNU LGPL license. 
@@ -174,84 +332,446 @@ int main ( void )
     differential equation is being solved.
 */
 {
-# define NSUB 5
 # define NL 2
 
-  double adiag[NSUB+1];
-  double aleft[NSUB+1];
-  double arite[NSUB+1];
-  double f[NSUB+1];
-  double h[NSUB];
+  double *adiag;
+  double *aleft;
+  double *arite;
+  double *f;
+  char *filename;
+  double *h;
+  int i;
   int ibc;
-  int indx[NSUB+1];
-  int node[NL*NSUB];
+  int ie;
+  int *indx;
+  int mode;
+  double *mass;
+  int niter;
+  mol *ml;
+  long nfev;
+  int nrkc;
+  int nstep;
+  int nstage;
+  char **names;
+  char *namebuf;
+  int nb;
+  int *node;
   int nquad;
+  int nsub;
   int nu;
+  sink *results;
+  int table;
+  double tmol;
+  int verbose;
   double ul;
+  double *u;
+  double *ulb;
   double ur;
+  double *urb;
   double xl;
-  double xn[NSUB+1];
-  double xquad[NSUB];
+  double *xn;
+  double *xquad;
   double xr;
+  double *work;
+  double rho;
+  double rhop;
+  double step;
+  double err;
+/*
+  Read the options.
+*/
+  nsub = 5;
+  nb = 1;
+  tmol = 0.0;
+  nrkc = 0;
+  niter = 0;
+  table = 1;
+  mode = SINK_OFF;
+  filename = NULL;
+
+  for ( i = 1; i < argc; i++ )
+  {
+    if ( strcmp ( argv[i], "-n" ) == 0 && i + 1 < argc )
+    {
+      nsub = atoi ( argv[++i] );
+    }
+    else if ( strcmp ( argv[i], "-block" ) == 0 && i + 1 < argc )
+    {
+      nb = atoi ( argv[++i] );
+    }
+    else if ( strcmp ( argv[i], "-mol" ) == 0 && i + 1 < argc )
+    {
+      tmol = atof ( argv[++i] );
+    }
+    else if ( strcmp ( argv[i], "-rkc" ) == 0 && i + 1 < argc )
+    {
+      nrkc = atoi ( argv[++i] );
+    }
+    else if ( strcmp ( argv[i], "-incr" ) == 0 && i + 1 < argc )
+    {
+      niter = atoi ( argv[++i] );
+    }
+    else if ( strcmp ( argv[i], "-table" ) == 0 )
+    {
+      table = 1;
+    }
+    else if ( strcmp ( argv[i], "-quiet" ) == 0 )
+    {
+      table = 0;
+      mode = SINK_OFF;
+    }
+    else if ( strcmp ( argv[i], "-summary" ) == 0 )
+    {
+      table = 0;
+      mode = SINK_SUMMARY;
+    }
+    else if ( strcmp ( argv[i], "-csv" ) == 0 && i + 1 < argc )
+    {
+      table = 0;
+      mode = SINK_CSV;
+      filename = argv[++i];
+    }
+    else if ( strcmp ( argv[i], "-bin" ) == 0 && i + 1 < argc )
+    {
+      table = 0;
+      mode = SINK_BINARY;
+      filename = argv[++i];
+    }
+    else if ( strcmp ( argv[i], "-traj" ) == 0 && i + 1 < argc )
+    {
+      table = 0;
+      mode = SINK_TRAJ;
+      filename = argv[++i];
+    }
+    else
+    {
+      fprintf ( stderr, "\n" );
+      fprintf ( stderr, "FEM1D - Fatal error!\n" );
+      fprintf ( stderr, "  Unrecognized option \"%s\".\n", argv[i] );
+      return 1;
+    }
+  }
 
-  timestamp ( );
+  if ( nsub < 1 )
+  {
+    fprintf ( stderr, "\n" );
+    fprintf ( stderr, "FEM1D - Fatal error!\n" );
+    fprintf ( stderr, "  NSUB must be at least 1.\n" );
+    return 1;
+  }
 
-  printf ( "\n" );
-  printf ( "FEM1D\n" );
-  printf ( "  C version\n" );
-  printf ( "\n" );
-  printf ( "  Solve the two-point boundary value problem\n" );
-  printf ( "\n" );
-  printf ( "  - d/dX (P dU/dX) + Q U  =  F\n" );
-  printf ( "\n" );
-  printf ( "  on the interval [XL,XR], specifying\n" );
-  printf ( "  the value of U or U' at each end.\n" );
-  printf ( "\n" );
-  printf ( "  The interval [XL,XR] is broken into NSUB = %d subintervals\n", NSUB );
-  printf ( "  Number of basis functions per element is NL = %d\n", NL );
+  if ( nb < 1 )
+  {
+    fprintf ( stderr, "\n" );
+    fprintf ( stderr, "FEM1D - Fatal error!\n" );
+    fprintf ( stderr, "  NB must be at least 1.\n" );
+    return 1;
+  }
+
+  if ( 0.0 < tmol && 1 < nb )
+  {
+    fprintf ( stderr, "\n" );
+    fprintf ( stderr, "FEM1D - Fatal error!\n" );
+    fprintf ( stderr, "  -mol is only available for NB = 1.\n" );
+    return 1;
+  }
+
+  if ( 0 < niter && ( 1 < nb || 0.0 < tmol ) )
+  {
+    fprintf ( stderr, "\n" );
+    fprintf ( stderr, "FEM1D - Fatal error!\n" );
+    fprintf ( stderr, "  -incr is only available for NB = 1, without -mol.\n" );
+    return 1;
+  }
+/*
+  Reports of the other modes are printed unless -quiet was given.
+*/
+  verbose = ( table || mode != SINK_OFF );
+
+  adiag = ( double * ) malloc ( ( 3 * nb * nb + nb ) * ( nsub + 1 ) 
+    * sizeof ( double ) );
+  aleft = adiag + nb * nb * ( nsub + 1 );
+  arite = adiag + 2 * nb * nb * ( nsub + 1 );
+  f     = adiag + 3 * nb * nb * ( nsub + 1 );
+  h = ( double * ) malloc ( nsub * sizeof ( double ) );
+  indx = ( int * ) malloc ( ( nsub + 1 ) * sizeof ( int ) );
+  node = ( int * ) malloc ( NL * nsub * sizeof ( int ) );
+  xn = ( double * ) malloc ( ( nsub + 1 ) * sizeof ( double ) );
+  xquad = ( double * ) malloc ( nsub * sizeof ( double ) );
+
+  if ( table )
+  {
+    timestamp ( );
+
+    printf ( "\n" );
+    printf ( "FEM1D\n" );
+    printf ( "  C version\n" );
+    printf ( "\n" );
+    printf ( "  Solve the two-point boundary value problem\n" );
+    printf ( "\n" );
+    printf ( "  - d/dX (P dU/dX) + Q U  =  F\n" );
+    printf ( "\n" );
+    printf ( "  on the interval [XL,XR], specifying\n" );
+    printf ( "  the value of U or U' at each end.\n" );
+    printf ( "\n" );
+    printf ( "  The interval [XL,XR] is broken into NSUB = %d subintervals\n", nsub );
+    printf ( "  Number of basis functions per element is NL = %d\n", NL );
+    if ( 1 < nb )
+    {
+      printf ( "  Number of coupled fields is NB = %d\n", nb );
+    }
+  }
 /*
   Initialize the data that defines the problem.
 */
   init ( &ibc, &nquad, &ul, &ur, &xl, &xr );
+  if ( table )
+  {
+    init_print ( ibc, nquad, ul, ur, xl, xr );
+  }
 /*
   Compute the quantities which define the geometry of the
   problem.
 */
-  geometry ( h, ibc, indx, NL, node, NSUB, &nu, xl, xn, xquad, xr );
+  geometry ( h, ibc, indx, NL, node, nsub, &nu, xl, xn, xquad, xr );
+  if ( table )
+  {
+    geometry_print ( h, indx, node, nsub, nu, xn, xquad );
+  }
+/*
+  Column names for the results sink.
+*/
+  names = ( char ** ) malloc ( ( nb + 2 ) * sizeof ( char * ) );
+  namebuf = ( char * ) malloc ( ( nb + 2 ) * 16 );
+  for ( i = 0; i < nb + 2; i++ )
+  {
+    names[i] = namebuf + 16 * i;
+  }
+  strcpy ( names[0], "node" );
+  strcpy ( names[1], "x" );
+  if ( nb == 1 )
+  {
+    strcpy ( names[2], "u" );
+  }
+  else
+  {
+    for ( i = 0; i < nb; i++ )
+    {
+      sprintf ( names[i+2], "u%d", i + 1 );
+    }
+  }
+
+  results = NULL;
+  if ( !table )
+  {
+    results = sink_open ( mode, filename, nb + 2, names );
+    if ( results == NULL )
+    {
+      fprintf ( stderr, "\n" );
+      fprintf ( stderr, "FEM1D - Fatal error!\n" );
+      fprintf ( stderr, "  Could not open \"%s\".\n", filename );
+      return 1;
+    }
+/*
+  X increases along the rows, so it is the key of a trajectory file.
+*/
+    results->key = 1;
+  }
+
+  if ( nb == 1 )
+  {
 /*
   Assemble the linear system.
 */
-  assemble ( adiag, aleft, arite, f, h, indx, NL, node, nu, nquad, 
-    NSUB, ul, ur, xn, xquad );
+    assemble ( adiag, aleft, arite, f, NULL, h, indx, NL, node, nu, nquad, 
+      nsub, ul, ur, xn, xquad );
 /*
   Print out the linear system.
 */
-  prsys ( adiag, aleft, arite, f, nu );
+    if ( table )
+    {
+      prsys ( adiag, aleft, arite, f, nu );
+    }
+/*
+  For -mol, step the semi-discrete system, before SOLVE overwrites it.
+*/
+    u = NULL;
+    if ( 0.0 < tmol )
+    {
+      mass = ( double * ) malloc ( 7 * nu * sizeof ( double ) );
+      u = mass + nu;
+      work = u + nu;
+      for ( i = 0; i < nu; i++ )
+      {
+        mass[i] = 0.0;
+        u[i] = 0.0;
+        work[i] = 0.0;
+      }
+      for ( ie = 0; ie < nsub; ie++ )
+      {
+        for ( i = 0; i < NL; i++ )
+        {
+          if ( 0 < indx[node[i+ie*2]] )
+          {
+            mass[indx[node[i+ie*2]]-1] += 0.5 * h[ie];
+          }
+        }
+      }
+      ml = mol_create ( nu, aleft, adiag, arite, f, mass );
+      rho = mol_gershgorin ( ml );
+      nfev = 0;
+      rhop = rkc_rho ( mol_rhs, nu, 0.0, u, work, 100, 0.001, work + nu, 
+        ml, &nfev );
+      for ( i = 0; i < nu; i++ )
+      {
+        u[i] = 0.0;
+      }
+      ml->nfev = 0;
+      if ( 0 < nrkc )
+      {
+        nstep = nrkc;
+        step = tmol / nstep;
+        nstage = rkc_stages ( step, rho );
+        for ( i = 0; i < nstep; i++ )
+        {
+          rkc_step ( mol_rhs, nu, i * step, step, nstage, u, work, ml );
+        }
+      }
+      else
+      {
+        nstep = ( int ) ceil ( tmol * rho / 2.78 );
+        step = tmol / nstep;
+        nstage = 4;
+        for ( i = 0; i < nstep; i++ )
+        {
+          rk4_step ( mol_rhs, nu, i * step, step, u, work, ml );
+        }
+      }
+      if ( verbose )
+      {
+        printf ( "\n" );
+        printf ( "  Method of lines to T = %g by %s\n", tmol, 
+          ( 0 < nrkc ) ? "RKC" : "RK4" );
+        printf ( "  Spectral radius: Gershgorin %g, power iteration %g\n", 
+          rho, rhop );
+        printf ( "  (the latter with the 20%% margin of RKC_RHO, %ld evaluations)\n", 
+          nfev );
+        printf ( "  Steps %d of size %g, %d stages, H * RHO = %g\n", 
+          nstep, step, nstage, step * rho );
+        printf ( "  Right hand side evaluations = %ld\n", ml->nfev );
+      }
+      mol_free ( ml );
+    }
+/*
+  Solve the linear system, or, for -incr, a sequence of them.
+*/
+    if ( 0 < niter )
+    {
+      if ( incr_design ( niter, h, indx, NL, node, nu, nquad, nsub, ul, ur, 
+        xn, xquad, verbose, f ) != 0 )
+      {
+        fprintf ( stderr, "\n" );
+        fprintf ( stderr, "FEM1D - Fatal error!\n" );
+        fprintf ( stderr, "  A design system is singular.\n" );
+        return 1;
+      }
+    }
+    else
+    {
+      solve ( adiag, aleft, arite, f, nu );
+    }
 /*
-  Solve the linear system.
+  The transient solution replaces the steady one.
 */
-  solve ( adiag, aleft, arite, f, nu );
+    if ( u != NULL )
+    {
+      err = 0.0;
+      for ( i = 0; i < nu; i++ )
+      {
+        err = fmax ( err, fabs ( u[i] - f[i] ) );
+        f[i] = u[i];
+      }
+      if ( verbose )
+      {
+        printf ( "  Largest difference from the steady solution = %g\n", 
+          err );
+      }
+      free ( mass );
+    }
 /*
   Print out the solution.
 */
-  output ( f, ibc, indx, NSUB, nu, ul, ur, xn );
+    if ( table )
+    {
+      output ( f, ibc, indx, nsub, nu, ul, ur, xn );
+    }
+    else
+    {
+      output_sink ( results, f, ibc, indx, nsub, ul, ur, xn );
+    }
+  }
+  else
+  {
+/*
+  Every field has the same boundary values.
+*/
+    ulb = ( double * ) malloc ( 2 * nb * sizeof ( double ) );
+    urb = ulb + nb;
+    for ( i = 0; i < nb; i++ )
+    {
+      ulb[i] = ul;
+      urb[i] = ur;
+    }
+/*
+  Assemble and solve the block tridiagonal system.
+*/
+    assemble_block ( nb, adiag, aleft, arite, f, h, indx, NL, node, nu, 
+      nquad, nsub, ulb, urb, xn, xquad );
 
-  printf ( "\n" );
-  printf ( "FEM1D:\n" );
-  printf ( "  Normal end of execution.\n" );
+    if ( solve_block ( nb, nu, adiag, aleft, arite, f ) != 0 )
+    {
+      fprintf ( stderr, "\n" );
+      fprintf ( stderr, "FEM1D - Fatal error!\n" );
+      fprintf ( stderr, "  The block system is singular.\n" );
+      return 1;
+    }
 
-  printf ( "\n" );
-  timestamp ( );
+    output_block ( results, nb, f, ibc, indx, nsub, ulb, urb, xn );
+
+    free ( ulb );
+  }
+
+  if ( table )
+  {
+    printf ( "\n" );
+    printf ( "FEM1D:\n" );
+    printf ( "  Normal end of execution.\n" );
+
+    printf ( "\n" );
+    timestamp ( );
+  }
+  else
+  {
+    sink_close ( results );
+  }
+
+  free ( names );
+  free ( namebuf );
+  free ( adiag );
+  free ( h );
+  free ( indx );
+  free ( node );
+  free ( xn );
+  free ( xquad );
 
   return 0;
 # undef NL
-# undef NSUB
 }
 /******************************************************************************/
 
 void assemble ( double adiag[], double aleft[], double arite[], double f[], 
-  double h[], int indx[], int nl, int node[], int nu, int nquad, int nsub, 
-  double ul, double ur, double xn[], double xquad[] )
+  double coef[], double h[], int indx[], int nl, int node[], int nu, 
+  int nquad, int nsub, double ul, double ur, double xn[], double xquad[] )
 
 /******************************************************************************/
 /*
@@ -304,6 +824,10 @@ void assemble ( double adiag[], double aleft[], double arite[], double f[],
     SOLVE replaces those values of F by the solution of the
     linear equations.
 
+    Input, double COEF[2*NSUB], factors by which PP and QQ are multiplied
+    on each element: COEF[0+IE*2] for PP and COEF[1+IE*2] for QQ on
+    element IE.  If COEF is NULL, PP and QQ are used as they are.
+
     Input, double H(NSUB)
     H(I) is the length of subinterval I.  This code uses
     equal spacing for all the subintervals.
@@ -367,25 +891,9 @@ void assemble ( double adiag[], double aleft[], double arite[], double f[],
     differential equation is being solved.
 */
 {
-  double aij;
-  double he;
+  double ae[6];
   int i;
   int ie;
-  int ig;
-  int il;
-  int iq;
-  int iu;
-  int jg;
-  int jl;
-  int ju;
-  double phii;
-  double phiix;
-  double phij;
-  double phijx;
-  double x;
-  double xleft;
-  double xquade;
-  double xrite;
 /*
   Zero out the arrays that hold the coefficients of the matrix
   and the right hand side.
@@ -407,119 +915,33 @@ void assemble ( double adiag[], double aleft[], double arite[], double f[],
     arite[i] = 0.0;
   }
 /*
-  For interval number IE,
+  For interval number IE, compute the local contributions and add
+  them into the global system.
 */
   for ( ie = 0; ie < nsub; ie++ )
   {
-    he = h[ie];
-    xleft = xn[node[0+ie*2]];
-    xrite = xn[node[1+ie*2]];
-/*
-  consider each quadrature point IQ,
-*/
-    for ( iq = 0; iq < nquad; iq++ )
-    {
-      xquade = xquad[ie];
-/*
-  and evaluate the integrals associated with the basis functions
-  for the left, and for the right nodes.
-*/
-      for ( il = 1; il <= nl; il++ )
-      {
-        ig = node[il-1+ie*2];
-        iu = indx[ig] - 1;
-
-        if ( 0 <= iu )
-        {
-          phi ( il, xquade, &phii, &phiix, xleft, xrite );
-          f[iu] = f[iu] + he * ff ( xquade ) * phii;
-/*
-  Take care of boundary nodes at which U' was specified.
-*/
-          if ( ig == 0 )
-          {
-            x = 0.0;
-            f[iu] = f[iu] - pp ( x ) * ul;
-          }
-          else if ( ig == nsub )
-          {
-            x = 1.0;
-            f[iu] = f[iu] + pp ( x ) * ur;
-          }
-/*
-  Evaluate the integrals that take a product of the basis
-  function times itself, or times the other basis function
-  that is nonzero in this interval.
-*/
-          for ( jl = 1; jl <= nl; jl++ )
-          {
-            jg = node[jl-1+ie*2];
-            ju = indx[jg] - 1;
-
-            phi ( jl, xquade, &phij, &phijx, xleft, xrite );
-
-            aij = he * ( pp ( xquade ) * phiix * phijx 
-                       + qq ( xquade ) * phii  * phij   );
-/*
-  If there is no variable associated with the node, then it's
-  a specified boundary value, so we multiply the coefficient
-  times the specified boundary value and subtract it from the
-  right hand side.
-*/
-            if ( ju < 0 )
-            {
-              if ( jg == 0 )
-              {
-                f[iu] = f[iu] - aij * ul;
-              }
-              else if ( jg == nsub )
-              {               
-                f[iu] = f[iu] - aij * ur;
-              }
-            }
-/*
-  Otherwise, we add the coefficient we've just computed to the
-  diagonal, or left or right entries of row IU of the matrix.
-*/
-            else
-            {
-              if ( iu == ju )
-              {
-                adiag[iu] = adiag[iu] + aij;
-              }
-              else if ( ju < iu )
-              {
-                aleft[iu] = aleft[iu] + aij;
-              }
-              else
-              {
-                arite[iu] = arite[iu] + aij;
-              }
-            }
-          }
-        }
-      }
-    }
+    assemble_element ( ae, coef, h, ie, indx, nl, node, nquad, nsub, ul, ur, 
+      xn, xquad );
+    assemble_add ( adiag, aleft, arite, f, ae, ie, indx, nl, node );
   }
   return;
 }
 /******************************************************************************/
 
-double ff ( double x )
+void assemble_add ( double adiag[], double aleft[], double arite[], double f[], 
+  double ae[], int ie, int indx[], int nl, int node[] )
 
 /******************************************************************************/
 /*
   Purpose:
 
-    FF evaluates the right hand side function.
+    ASSEMBLE_ADD adds the contribution of one element to the linear system.
 
   Discussion:
 
-    This routine evaluates the function F(X) in the differential equation.
-
-      -d/dx (p du/dx) + q u  =  f
-
-    at the point X.
+    The contribution is the array AE computed by ASSEMBLE_ELEMENT, or
+    the difference of two such arrays.  Rows belonging to nodes with no
+    unknown are skipped.
 
   Licensing:
 
@@ -527,214 +949,2057 @@ double ff ( double x )
 
   Modified:
 
-    29 May 2009
+    18 October 2026
 
-  Author:
+  Parameters:
 
-    John Burkardt
+    Input/output, double ADIAG(NU), ALEFT(NU), ARITE(NU), F(NU), the
+    linear system, to which the contribution is added.
 
-  Parameters:
+    Input, double AE[NL*NL+NL], the element contribution.  AE[IL+JL*NL]
+    couples local basis functions IL and JL, and AE[NL*NL+IL] is the
+    right hand side entry of local basis function IL.
+
+    Input, int IE, the index of the element.
+
+    Input, int INDX[NSUB+1], the index of the unknown associated with 
+    each node, or -1.
+
+    Input, int NL, the number of basis functions used in a single
+    subinterval.
+
+    Input, int NODE[NL*NSUB], the left and right node of each subinterval.
+*/
+{
+  int il;
+  int iu;
+  int jl;
+  int ju;
+
+  for ( il = 0; il < nl; il++ )
+  {
+    iu = indx[node[il+ie*2]] - 1;
+    if ( iu < 0 )
+    {
+      continue;
+    }
+    f[iu] = f[iu] + ae[nl*nl+il];
+    for ( jl = 0; jl < nl; jl++ )
+    {
+      ju = indx[node[jl+ie*2]] - 1;
+      if ( ju < 0 )
+      {
+        continue;
+      }
+      if ( iu == ju )
+      {
+        adiag[iu] = adiag[iu] + ae[il+jl*nl];
+      }
+      else if ( ju < iu )
+      {
+        aleft[iu] = aleft[iu] + ae[il+jl*nl];
+      }
+      else
+      {
+        arite[iu] = arite[iu] + ae[il+jl*nl];
+      }
+    }
+  }
+  return;
+}
+/******************************************************************************/
+
+void assemble_block ( int nb, double adiag[], double aleft[], double arite[], 
+  double f[], double h[], int indx[], int nl, int node[], int nu, int nquad, 
+  int nsub, double ul[], double ur[], double xn[], double xquad[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ASSEMBLE_BLOCK assembles a block tridiagonal system for NB coupled fields.
+
+  Discussion:
+
+    The differential equation is now a system
+
+      - d/dX (P dU/dX) + Q U  =  F
+
+    where U and F are vectors of NB components, and P and Q are NB by NB
+    matrices, evaluated by PPB and QQB.  The assembly is that of ASSEMBLE,
+    except that every coefficient becomes a dense NB by NB block.  P, Q
+    and F are evaluated once per quadrature point, and each pair of basis
+    functions then adds the block
+
+      HE * ( P * PHIIX * PHIJX + Q * PHII * PHIJ ).
+
+    Blocks are stored one after another, each in column-major order, so 
+    entry (R,C) of the block in row I of ADIAG is ADIAG[I*NB*NB+R+C*NB].
+    Component R of unknown I of F is F[I*NB+R].
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int NB, the number of fields at each node.
+
+    Output, double ADIAG[NU*NB*NB], ALEFT[NU*NB*NB], ARITE[NU*NB*NB],
+    the diagonal, left and right blocks of the matrix.
+
+    Output, double F[NU*NB], the right hand side.
+
+    Input, double H(NSUB), the length of each subinterval.
+
+    Input, int INDX[NSUB+1], the index of the unknown associated with 
+    each node, or -1.
+
+    Input, int NL, the number of basis functions used in a single
+    subinterval.
+
+    Input, int NODE[NL*NSUB], the left and right node of each subinterval.
+
+    Input, int NU, the number of unknowns, that is, of block rows.
+
+    Input, int NQUAD, the number of quadrature points used in a subinterval.
+
+    Input, int NSUB, the number of subintervals.
+
+    Input, double UL[NB], UR[NB], the boundary values at XL and XR.
+
+    Input, double XN(0:NSUB), the location of the nodes.
+
+    Input, double XQUAD(NSUB), the quadrature point in each interval.
+*/
+{
+  double *a;
+  double cp;
+  double cq;
+  double *fx;
+  double he;
+  int i;
+  int ie;
+  int ig;
+  int il;
+  int iq;
+  int iu;
+  int jg;
+  int jl;
+  int ju;
+  int k;
+  int nbb;
+  double *p;
+  double *pb;
+  double phii;
+  double phiix;
+  double phij;
+  double phijx;
+  double *q;
+  int r;
+  double *ub;
+  double xleft;
+  double xquade;
+  double xrite;
+
+  nbb = nb * nb;
+
+  for ( i = 0; i < nu * nbb; i++ )
+  {
+    adiag[i] = 0.0;
+    aleft[i] = 0.0;
+    arite[i] = 0.0;
+  }
+  for ( i = 0; i < nu * nb; i++ )
+  {
+    f[i] = 0.0;
+  }
+
+  p = ( double * ) malloc ( ( 3 * nbb + nb ) * sizeof ( double ) );
+  q = p + nbb;
+  pb = q + nbb;
+  fx = pb + nbb;
+
+  for ( ie = 0; ie < nsub; ie++ )
+  {
+    he = h[ie];
+    xleft = xn[node[0+ie*2]];
+    xrite = xn[node[1+ie*2]];
+
+    for ( iq = 0; iq < nquad; iq++ )
+    {
+      xquade = xquad[ie];
+/*
+  The coupling blocks at this quadrature point.
+*/
+      ppb ( xquade, nb, p );
+      qqb ( xquade, nb, q );
+      ffb ( xquade, nb, fx );
+
+      for ( il = 1; il <= nl; il++ )
+      {
+        ig = node[il-1+ie*2];
+        iu = indx[ig] - 1;
+        if ( iu < 0 )
+        {
+          continue;
+        }
+        phi ( il, xquade, &phii, &phiix, xleft, xrite );
+        for ( r = 0; r < nb; r++ )
+        {
+          f[iu*nb+r] = f[iu*nb+r] + he * fx[r] * phii;
+        }
+/*
+  Take care of boundary nodes at which U' was specified.
+*/
+        if ( ig == 0 || ig == nsub )
+        {
+          ppb ( ( ig == 0 ) ? 0.0 : 1.0, nb, pb );
+          ub = ( ig == 0 ) ? ul : ur;
+          for ( r = 0; r < nb; r++ )
+          {
+            for ( k = 0; k < nb; k++ )
+            {
+              if ( ig == 0 )
+              {
+                f[iu*nb+r] = f[iu*nb+r] - pb[r+k*nb] * ub[k];
+              }
+              else
+              {
+                f[iu*nb+r] = f[iu*nb+r] + pb[r+k*nb] * ub[k];
+              }
+            }
+          }
+        }
+
+        for ( jl = 1; jl <= nl; jl++ )
+        {
+          jg = node[jl-1+ie*2];
+          ju = indx[jg] - 1;
+          phi ( jl, xquade, &phij, &phijx, xleft, xrite );
+          cp = he * phiix * phijx;
+          cq = he * phii  * phij;
+/*
+  A specified boundary value moves to the right hand side.
+*/
+          if ( ju < 0 )
+          {
+            ub = ( jg == 0 ) ? ul : ur;
+            for ( r = 0; r < nb; r++ )
+            {
+              for ( k = 0; k < nb; k++ )
+              {
+                f[iu*nb+r] = f[iu*nb+r] 
+                  - ( cp * p[r+k*nb] + cq * q[r+k*nb] ) * ub[k];
+              }
+            }
+          }
+          else
+          {
+            if ( iu == ju )
+            {
+              a = adiag + iu * nbb;
+            }
+            else if ( ju < iu )
+            {
+              a = aleft + iu * nbb;
+            }
+            else
+            {
+              a = arite + iu * nbb;
+            }
+            for ( k = 0; k < nbb; k++ )
+            {
+              a[k] = a[k] + cp * p[k] + cq * q[k];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  free ( p );
+
+  return;
+}
+/******************************************************************************/
+
+void assemble_element ( double ae[], double coef[], double h[], int ie, 
+  int indx[], int nl, int node[], int nquad, int nsub, double ul, double ur, 
+  double xn[], double xquad[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ASSEMBLE_ELEMENT computes the contribution of one element.
+
+  Discussion:
+
+    This is the body of the element loop of ASSEMBLE.  Keeping it
+    separate lets the incremental solver recompute only those elements
+    whose coefficients have changed.
+
+    Coefficients which multiply a specified boundary value are moved
+    to the right hand side, exactly as in ASSEMBLE.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Output, double AE[NL*NL+NL], the element contribution.  AE[IL+JL*NL]
+    couples local basis functions IL and JL, and AE[NL*NL+IL] is the
+    right hand side entry of local basis function IL.
+
+    Input, double COEF[2*NSUB], the factors of PP and QQ on each element,
+    as in ASSEMBLE, or NULL.
+
+    Input, double H(NSUB), the length of each subinterval.
+
+    Input, int IE, the index of the element.
+
+    Input, int INDX[NSUB+1], the index of the unknown associated with 
+    each node, or -1.
+
+    Input, int NL, the number of basis functions used in a single
+    subinterval.
+
+    Input, int NODE[NL*NSUB], the left and right node of each subinterval.
+
+    Input, int NQUAD, the number of quadrature points used in a subinterval.
+
+    Input, int NSUB, the number of subintervals.
+
+    Input, double UL, UR, the boundary values at XL and XR.
+
+    Input, double XN(0:NSUB), the location of the nodes.
+
+    Input, double XQUAD(NSUB), the quadrature point in each interval.
+*/
+{
+  double aij;
+  double cp;
+  double cq;
+  double he;
+  int i;
+  int ig;
+  int il;
+  int iq;
+  int iu;
+  int jg;
+  int jl;
+  int ju;
+  double phii;
+  double phiix;
+  double phij;
+  double phijx;
+  double x;
+  double xleft;
+  double xquade;
+  double xrite;
+
+  for ( i = 0; i < nl * nl + nl; i++ )
+  {
+    ae[i] = 0.0;
+  }
+
+  he = h[ie];
+  cp = 1.0;
+  cq = 1.0;
+  if ( coef != NULL )
+  {
+    cp = coef[0+ie*2];
+    cq = coef[1+ie*2];
+  }
+  xleft = xn[node[0+ie*2]];
+  xrite = xn[node[1+ie*2]];
+/*
+  Consider each quadrature point IQ,
+*/
+  for ( iq = 0; iq < nquad; iq++ )
+  {
+    xquade = xquad[ie];
+/*
+  and evaluate the integrals associated with the basis functions
+  for the left, and for the right nodes.
+*/
+    for ( il = 1; il <= nl; il++ )
+    {
+      ig = node[il-1+ie*2];
+      iu = indx[ig] - 1;
+      if ( 0 <= iu )
+      {
+        phi ( il, xquade, &phii, &phiix, xleft, xrite );
+        ae[nl*nl+il-1] = ae[nl*nl+il-1] + he * ff ( xquade ) * phii;
+/*
+  Take care of boundary nodes at which U' was specified.
+*/
+        if ( ig == 0 )
+        {
+          x = 0.0;
+          ae[nl*nl+il-1] = ae[nl*nl+il-1] - cp * pp ( x ) * ul;
+        }
+        else if ( ig == nsub )
+        {
+          x = 1.0;
+          ae[nl*nl+il-1] = ae[nl*nl+il-1] + cp * pp ( x ) * ur;
+        }
+/*
+  Evaluate the integrals that take a product of the basis
+  function times itself, or times the other basis function
+  that is nonzero in this interval.
+*/
+        for ( jl = 1; jl <= nl; jl++ )
+        {
+          jg = node[jl-1+ie*2];
+          ju = indx[jg] - 1;
+          phi ( jl, xquade, &phij, &phijx, xleft, xrite );
+          aij = he * ( cp * pp ( xquade ) * phiix * phijx 
+                     + cq * qq ( xquade ) * phii  * phij   );
+/*
+  If there is no variable associated with the node, then it's
+  a specified boundary value, so we multiply the coefficient
+  times the specified boundary value and subtract it from the
+  right hand side.
+*/
+          if ( ju < 0 )
+          {
+            if ( jg == 0 )
+            {
+              ae[nl*nl+il-1] = ae[nl*nl+il-1] - aij * ul;
+            }
+            else if ( jg == nsub )
+            {
+              ae[nl*nl+il-1] = ae[nl*nl+il-1] - aij * ur;
+            }
+          }
+/*
+  Otherwise, we add the coefficient we've just computed to the
+  element matrix.
+*/
+          else
+          {
+            ae[il-1+(jl-1)*nl] = ae[il-1+(jl-1)*nl] + aij;
+          }
+        }
+      }
+    }
+  }
+  return;
+}
+/******************************************************************************/
+
+static inline int block_lu ( int nb, double a[], int piv[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    BLOCK_LU factors one NB by NB block, with partial pivoting.
+
+  Discussion:
+
+    This routine and the next two are "static inline" so that, when they
+    are called with a constant NB, the compiler can unroll their loops.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int NB, the order of the block.
+
+    Input/output, double A[NB*NB].  On input, the block.  On output,
+    its L and U factors.
+
+    Output, int PIV[NB], the pivot rows.
+
+    Output, int BLOCK_LU, is 0 on success, or 1 if the block is singular.
+*/
+{
+  int c;
+  int k;
+  int p;
+  int r;
+  double t;
+
+  for ( k = 0; k < nb; k++ )
+  {
+    p = k;
+    for ( r = k + 1; r < nb; r++ )
+    {
+      if ( fabs ( a[p+k*nb] ) < fabs ( a[r+k*nb] ) )
+      {
+        p = r;
+      }
+    }
+    piv[k] = p;
+    if ( a[p+k*nb] == 0.0 )
+    {
+      return 1;
+    }
+    if ( p != k )
+    {
+      for ( c = 0; c < nb; c++ )
+      {
+        t = a[k+c*nb];
+        a[k+c*nb] = a[p+c*nb];
+        a[p+c*nb] = t;
+      }
+    }
+    t = 1.0 / a[k+k*nb];
+    for ( r = k + 1; r < nb; r++ )
+    {
+      a[r+k*nb] = a[r+k*nb] * t;
+    }
+    for ( c = k + 1; c < nb; c++ )
+    {
+      for ( r = k + 1; r < nb; r++ )
+      {
+        a[r+c*nb] = a[r+c*nb] - a[r+k*nb] * a[k+c*nb];
+      }
+    }
+  }
+  return 0;
+}
+/******************************************************************************/
+
+static inline void block_lu_solve ( int nb, double a[], int piv[], double x[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    BLOCK_LU_SOLVE solves a system with a block factored by BLOCK_LU.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int NB, the order of the block.
+
+    Input, double A[NB*NB], the factors computed by BLOCK_LU.
+
+    Input, int PIV[NB], the pivot rows computed by BLOCK_LU.
+
+    Input/output, double X[NB].  On input, the right hand side.
+    On output, the solution.
+*/
+{
+  int k;
+  int r;
+  double t;
+/*
+  Apply the row interchanges, then solve L and U by columns, so that
+  the innermost loops run down contiguous entries of A.
+*/
+  for ( k = 0; k < nb; k++ )
+  {
+    t = x[k];
+    x[k] = x[piv[k]];
+    x[piv[k]] = t;
+  }
+  for ( k = 0; k < nb; k++ )
+  {
+    for ( r = k + 1; r < nb; r++ )
+    {
+      x[r] = x[r] - a[r+k*nb] * x[k];
+    }
+  }
+  for ( k = nb - 1; 0 <= k; k-- )
+  {
+    x[k] = x[k] / a[k+k*nb];
+    for ( r = 0; r < k; r++ )
+    {
+      x[r] = x[r] - a[r+k*nb] * x[k];
+    }
+  }
+  return;
+}
+/******************************************************************************/
+
+static inline int block_thomas ( int nb, int nu, double adiag[], 
+  double aleft[], double arite[], double f[], int piv[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    BLOCK_THOMAS solves a block tridiagonal system.
+
+  Discussion:
+
+    This is the algorithm of SOLVE, with each division replaced by the
+    solution of an NB by NB system:
+
+      D(0) = ADIAG(0)
+      D(I) = ADIAG(I) - ALEFT(I) * C(I-1)
+      C(I) = inverse ( D(I) ) * ARITE(I)
+      G(I) = inverse ( D(I) ) * ( F(I) - ALEFT(I) * G(I-1) )
+
+    followed by the back substitution U(I) = G(I) - C(I) * U(I+1).
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int NB, the order of the blocks.
+
+    Input, int NU, the number of block rows.
+
+    Input/output, double ADIAG[NU*NB*NB], ALEFT[NU*NB*NB], ARITE[NU*NB*NB],
+    the blocks of the matrix, which are overwritten.
+
+    Input/output, double F[NU*NB].  On input, the right hand side.
+    On output, the solution.
+
+    Workspace, int PIV[NB].
+
+    Output, int BLOCK_THOMAS, is 0 on success, or 1 if a diagonal block 
+    was singular.
+*/
+{
+  double *c;
+  double *cm;
+  double *d;
+  double *g;
+  double *gm;
+  int i;
+  int j;
+  int k;
+  double *l;
+  int nbb;
+  int r;
+
+  nbb = nb * nb;
+
+  for ( i = 0; i < nu; i++ )
+  {
+    d = adiag + i * nbb;
+    c = arite + i * nbb;
+    g = f + i * nb;
+    if ( 0 < i )
+    {
+      l = aleft + i * nbb;
+      cm = arite + ( i - 1 ) * nbb;
+      gm = f + ( i - 1 ) * nb;
+      for ( j = 0; j < nb; j++ )
+      {
+        for ( k = 0; k < nb; k++ )
+        {
+          for ( r = 0; r < nb; r++ )
+          {
+            d[r+j*nb] = d[r+j*nb] - l[r+k*nb] * cm[k+j*nb];
+          }
+        }
+      }
+      for ( k = 0; k < nb; k++ )
+      {
+        for ( r = 0; r < nb; r++ )
+        {
+          g[r] = g[r] - l[r+k*nb] * gm[k];
+        }
+      }
+    }
+
+    if ( block_lu ( nb, d, piv ) != 0 )
+    {
+      return 1;
+    }
+    if ( i < nu - 1 )
+    {
+      for ( j = 0; j < nb; j++ )
+      {
+        block_lu_solve ( nb, d, piv, c + j * nb );
+      }
+    }
+    block_lu_solve ( nb, d, piv, g );
+  }
+
+  for ( i = nu - 2; 0 <= i; i-- )
+  {
+    c = arite + i * nbb;
+    g = f + i * nb;
+    gm = f + ( i + 1 ) * nb;
+    for ( k = 0; k < nb; k++ )
+    {
+      for ( r = 0; r < nb; r++ )
+      {
+        g[r] = g[r] - c[r+k*nb] * gm[k];
+      }
+    }
+  }
+  return 0;
+}
+/******************************************************************************/
+
+double ff ( double x )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FF evaluates the right hand side function.
+
+  Discussion:
+
+    This routine evaluates the function F(X) in the differential equation.
+
+      -d/dx (p du/dx) + q u  =  f
+
+    at the point X.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    29 May 2009
+
+  Author:
+
+    John Burkardt
+
+  Parameters:
+
+    Input, double X, the argument of the function.
+
+    Output, double FF, the value of the function.
+*/
+{
+  double value;
+
+  value = 0.0;
+
+  return value;
+}
+/******************************************************************************/
+
+void ffb ( double x, int nb, double f[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FFB evaluates the right hand side of a system of NB coupled equations.
+
+  Discussion:
+
+    This is the vector F(X) in the system
+
+      -d/dx (P du/dx) + Q u  =  f
+
+    solved by ASSEMBLE_BLOCK and SOLVE_BLOCK.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
 
     Input, double X, the argument of the function.
 
-    Output, double FF, the value of the function.
+    Input, int NB, the number of fields.
+
+    Output, double F[NB], the value of the function.
+*/
+{
+  int r;
+
+  for ( r = 0; r < nb; r++ )
+  {
+    f[r] = 0.0;
+  }
+  return;
+}
+/******************************************************************************/
+
+void geometry ( double h[], int ibc, int indx[], int nl, int node[], int nsub, 
+  int *nu, double xl, double xn[], double xquad[], double xr )
+
+/******************************************************************************/
+/*
+  Purpose: 
+
+    GEOMETRY sets up the geometry for the interval [XL,XR].
+
+  Modified:
+
+    29 May 2009
+
+  Author:
+
+    C version by John Burkardt
+
+  Parameters:
+
+    Output, double H(NSUB)
+    H(I) is the length of subinterval I.  This code uses
+    equal spacing for all the subintervals.
+
+    Input, int IBC.
+    IBC declares what the boundary conditions are.
+    1, at the left endpoint, U has the value UL,
+       at the right endpoint, U' has the value UR.
+    2, at the left endpoint, U' has the value UL,
+       at the right endpoint, U has the value UR.
+    3, at the left endpoint, U has the value UL,
+       and at the right endpoint, U has the value UR.
+    4, at the left endpoint, U' has the value UL,
+       at the right endpoint U' has the value UR.
+
+    Output, int INDX[NSUB+1].
+    For a node I, INDX(I) is the index of the unknown
+    associated with node I.
+    If INDX(I) is equal to -1, then no unknown is associated
+    with the node, because a boundary condition fixing the
+    value of U has been applied at the node instead.
+    Unknowns are numbered beginning with 1.
+    If IBC is 2 or 4, then there is an unknown value of U
+    at node 0, which will be unknown number 1.  Otherwise,
+    unknown number 1 will be associated with node 1.
+    If IBC is 1 or 4, then there is an unknown value of U
+    at node NSUB, which will be unknown NSUB or NSUB+1,
+    depending on whether there was an unknown at node 0.
+
+    Input, int NL.
+    The number of basis functions used in a single
+    subinterval.  (NL-1) is the degree of the polynomials
+    used.  For this code, NL is fixed at 2, meaning that
+    piecewise linear functions are used as the basis.
+
+    Output, int NODE[NL*NSUB].
+    For each subinterval I:
+    NODE[0+I*2] is the number of the left node, and
+    NODE[1+I*2] is the number of the right node.
+
+    Input, int NSUB.
+    The number of subintervals into which the interval [XL,XR] is broken.
+
+    Output, int *NU.
+    NU is the number of unknowns in the linear system.
+    Depending on the value of IBC, there will be NSUB-1,
+    NSUB, or NSUB+1 unknown values, which are the coefficients
+    of basis functions.
+
+    Input, double XL.
+    XL is the left endpoint of the interval over which the
+    differential equation is being solved.
+
+    Output, double XN(0:NSUB).
+    XN(I) is the location of the I-th node.  XN(0) is XL,
+    and XN(NSUB) is XR.
+
+    Output, double XQUAD(NSUB)
+    XQUAD(I) is the location of the single quadrature point
+    in interval I.
+
+    Input, double XR.
+    XR is the right endpoint of the interval over which the
+    differential equation is being solved.
+*/
+{
+  int i;
+/*
+  Set the value of XN, the locations of the nodes.
+*/
+  for ( i = 0; i <= nsub; i++ )
+  {
+    xn[i]  =  ( ( double ) ( nsub - i ) * xl 
+              + ( double )          i   * xr ) 
+              / ( double ) ( nsub );
+  }
+/*
+  Set the lengths of each subinterval.
+*/
+  for ( i = 0; i < nsub; i++ )
+  {
+    h[i] = xn[i+1] - xn[i];
+  }
+/*
+  Set the quadrature points, each of which is the midpoint
+  of its subinterval.
+*/
+  for ( i = 0; i < nsub; i++ )
+  {
+    xquad[i] = 0.5 * ( xn[i] + xn[i+1] );
+  }
+/*
+  Set the value of NODE, which records, for each interval,
+  the node numbers at the left and right.
+*/
+  for ( i = 0; i < nsub; i++ )
+  {
+    node[0+i*2] = i;
+    node[1+i*2] = i + 1;
+  }
+/*
+  Starting with node 0, see if an unknown is associated with
+  the node.  If so, give it an index.
+*/
+  *nu = 0;
+/*
+  Handle first node.
+*/
+  i = 0;
+  if ( ibc == 1 || ibc == 3 )
+  {
+    indx[i] = -1;
+  }
+  else
+  {
+    *nu = *nu + 1;
+    indx[i] = *nu;
+  }
+/*
+  Handle nodes 1 through nsub-1
+*/
+  for ( i = 1; i < nsub; i++ )
+  {
+    *nu = *nu + 1;
+    indx[i] = *nu;
+  }
+/*
+  Handle the last node.
+/*/
+  i = nsub;
+
+  if ( ibc == 2 || ibc == 3 )
+  {
+    indx[i] = -1;
+  }
+  else
+  {
+    *nu = *nu + 1;
+    indx[i] = *nu;
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void geometry_print ( double h[], int indx[], int node[], int nsub, int nu, 
+  double xn[], double xquad[] )
+
+/******************************************************************************/
+/*
+  Purpose: 
+
+    GEOMETRY_PRINT prints the geometry set up by GEOMETRY.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double H(NSUB), the length of each subinterval.
+
+    Input, int INDX[NSUB+1], the index of the unknown associated with 
+    each node, or -1.
+
+    Input, int NODE[NL*NSUB], the left and right node of each subinterval.
+
+    Input, int NSUB, the number of subintervals.
+
+    Input, int NU, the number of unknowns.
+
+    Input, double XN(0:NSUB), the location of the nodes.
+
+    Input, double XQUAD(NSUB), the quadrature point in each interval.
+*/
+{
+  int i;
+
+  printf ( "\n" );
+  printf ( "  Node      Location\n" );
+  printf ( "\n" );
+  for ( i = 0; i <= nsub; i++ )
+  {
+    printf ( "  %8d  %14f \n", i, xn[i] );
+  }
+
+  printf ( "\n" );
+  printf ( "Subint    Length\n" );
+  printf ( "\n" );
+  for ( i = 0; i < nsub; i++ )
+  {
+    printf ( "  %8d  %14f\n", i+1, h[i] );
+  }
+
+  printf ( "\n" );
+  printf ( "Subint    Quadrature point\n" );
+  printf ( "\n" );
+  for ( i = 0; i < nsub; i++ )
+  {
+    printf ( "  %8d  %14f\n", i+1, xquad[i] );
+  }
+
+  printf ( "\n" );
+  printf ( "Subint  Left Node  Right Node\n" );
+  printf ( "\n" );
+  for ( i = 0; i < nsub; i++ )
+  {
+    printf ( "  %8d  %8d  %8d\n", i+1, node[0+i*2], node[1+i*2] );
+  }
+
+  printf ( "\n" );
+  printf ( "  Number of unknowns NU = %8d\n", nu );
+  printf ( "\n" );
+  printf ( "  Node  Unknown\n" );
+  printf ( "\n" );
+  for ( i = 0; i <= nsub; i++ )
+  {
+    printf ( "  %8d  %8d\n", i, indx[i] );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+incr_data *incr_create ( double coef[], double h[], int indx[], int nl, 
+  int node[], int nu, int nquad, int nsub, double ul, double ur, double xn[], 
+  double xquad[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    INCR_CREATE sets up the incremental solver for a problem.
+
+  Discussion:
+
+    The incremental solver is meant for design loops in which PP and QQ
+    change only over a few elements between solves.  It keeps the
+    contribution of every element, so that only the changed elements
+    need to be evaluated again, and it keeps the factors of a "base"
+    matrix A0, so that the new system need not be factored again.
+
+    If the current matrix differs from A0 only in the rows and columns
+    of a set S of M unknowns, we can write
+
+      A = A0 + P * D * P'
+
+    where P selects the unknowns in S and D is a small M by M matrix.
+    By the Sherman-Morrison-Woodbury formula, the solution is
+
+      U = U0 + inverse(A0) * P * W
+
+    where U0 is the base solution and W solves the M by M system
+
+      ( I + D * G ) * W = ( F - F0 )(S) - D * U0(S)
+
+    with G = P' * inverse(A0) * P.  Since A0 is tridiagonal, each
+    entry of its inverse is a product of Thomas factors between its row
+    and column, and INCR_FACTOR keeps running products of the factors,
+    so any entry of G costs a division.  The work of INCR_SOLVE depends
+    on the number of changed elements and on M, and not on NU.
+
+    On return, the system has been assembled, factored and solved, and
+    no element is marked as changed.  The geometry arrays are not
+    copied, and must not be freed before the solver is.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double COEF[2*NSUB], the factors of PP and QQ on each element,
+    as in ASSEMBLE, or NULL.  COEF is where the caller changes the
+    coefficients between solves.
+
+    Input, double H(NSUB), the length of each subinterval.
+
+    Input, int INDX[NSUB+1], the index of the unknown associated with 
+    each node, or -1.
+
+    Input, int NL, the number of basis functions used in a single
+    subinterval.
+
+    Input, int NODE[NL*NSUB], the left and right node of each subinterval.
+
+    Input, int NU, the number of unknowns.
+
+    Input, int NQUAD, the number of quadrature points used in a subinterval.
+
+    Input, int NSUB, the number of subintervals.
+
+    Input, double UL, UR, the boundary values at XL and XR.
+
+    Input, double XN(0:NSUB), the location of the nodes.
+
+    Input, double XQUAD(NSUB), the quadrature point in each interval.
+
+    Output, incr_data *INCR_CREATE, the incremental solver, or NULL
+    if the base matrix is singular.
+*/
+{
+  int i;
+  int ie;
+  int ne;
+  incr_data *s;
+
+  ne = nl * nl + nl;
+
+  s = ( incr_data * ) malloc ( sizeof ( incr_data ) );
+
+  s->coef = coef;
+  s->h = h;
+  s->indx = indx;
+  s->nl = nl;
+  s->node = node;
+  s->nu = nu;
+  s->nquad = nquad;
+  s->nsub = nsub;
+  s->ul = ul;
+  s->ur = ur;
+  s->xn = xn;
+  s->xquad = xquad;
+
+  s->adiag = ( double * ) malloc ( 4 * nu * sizeof ( double ) );
+  s->aleft = s->adiag + nu;
+  s->arite = s->adiag + 2 * nu;
+  s->f     = s->adiag + 3 * nu;
+  s->adiag0 = ( double * ) malloc ( 4 * nu * sizeof ( double ) );
+  s->aleft0 = s->adiag0 + nu;
+  s->arite0 = s->adiag0 + 2 * nu;
+  s->f0     = s->adiag0 + 3 * nu;
+  s->dpiv = ( double * ) malloc ( 8 * nu * sizeof ( double ) );
+  s->rfac  = s->dpiv + nu;
+  s->epiv  = s->dpiv + 2 * nu;
+  s->lfac  = s->dpiv + 3 * nu;
+  s->u0    = s->dpiv + 4 * nu;
+  s->gdiag = s->dpiv + 5 * nu;
+  s->pman  = s->dpiv + 6 * nu;
+  s->qman  = s->dpiv + 7 * nu;
+  s->pexp = ( int * ) malloc ( 4 * nu * sizeof ( int ) );
+  s->qexp = s->pexp + nu;
+  s->pseg = s->pexp + 2 * nu;
+  s->qseg = s->pexp + 3 * nu;
+  s->elem = ( double * ) malloc ( ne * nsub * sizeof ( double ) );
+  s->dirty = ( int * ) malloc ( 2 * nsub * sizeof ( int ) );
+  s->list = s->dirty + nsub;
+  s->ndirty = 0;
+  s->pos = ( int * ) malloc ( nu * sizeof ( int ) );
+  s->set = ( int * ) malloc ( nu * sizeof ( int ) );
+  s->m = 0;
+  s->w = NULL;
+  s->mcap = 0;
+/*
+  The work of an update grows like M*M*M, so past the cube root
+  of NU it is cheaper to factor the whole matrix again.
+*/
+  s->mmax = 4;
+  while ( s->mmax * s->mmax * s->mmax < nu )
+  {
+    s->mmax = s->mmax + 1;
+  }
+
+  for ( i = 0; i < nu; i++ )
+  {
+    s->adiag[i] = 0.0;
+    s->aleft[i] = 0.0;
+    s->arite[i] = 0.0;
+    s->f[i] = 0.0;
+    s->pos[i] = -1;
+  }
+
+  for ( ie = 0; ie < nsub; ie++ )
+  {
+    s->dirty[ie] = 0;
+    assemble_element ( s->elem + ie * ne, coef, h, ie, indx, nl, node, 
+      nquad, nsub, ul, ur, xn, xquad );
+    assemble_add ( s->adiag, s->aleft, s->arite, s->f, s->elem + ie * ne, ie, 
+      indx, nl, node );
+  }
+
+  if ( incr_factor ( s ) != 0 )
+  {
+    incr_free ( s );
+    return NULL;
+  }
+  return s;
+}
+/******************************************************************************/
+
+int incr_design ( int niter, double h[], int indx[], int nl, int node[], 
+  int nu, int nquad, int nsub, double ul, double ur, double xn[], 
+  double xquad[], int verbose, double u[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    INCR_DESIGN runs a design loop on the incremental solver.
+
+  Discussion:
+
+    Each iteration changes the factors of PP and QQ over a window of 1
+    to 3 elements, at a position that moves about the mesh, marks the
+    window and calls INCR_SOLVE.  The new solution is then checked
+    against a full ASSEMBLE and SOLVE of the same coefficients.
+
+    One line is printed per iteration: the window, the number M of
+    unknowns in the correction (0 after a refactorization), and the
+    largest difference from the full solve.  The times of INCR_SOLVE
+    and of the full solves are added up separately; neither includes
+    INCR_SOLUTION, the check, or the printing.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, int NITER, the number of design iterations.
+
+    Input, double H(NSUB), the length of each subinterval.
+
+    Input, int INDX[NSUB+1], the index of the unknown associated with 
+    each node, or -1.
+
+    Input, int NL, the number of basis functions used in a single
+    subinterval.
+
+    Input, int NODE[NL*NSUB], the left and right node of each subinterval.
+
+    Input, int NU, the number of unknowns.
+
+    Input, int NQUAD, the number of quadrature points used in a subinterval.
+
+    Input, int NSUB, the number of subintervals.
+
+    Input, double UL, UR, the boundary values at XL and XR.
+
+    Input, double XN(0:NSUB), the location of the nodes.
+
+    Input, double XQUAD(NSUB), the quadrature point in each interval.
+
+    Input, int VERBOSE, is 1 to print the report.
+
+    Output, double U[NU], the solution for the final coefficients.
+
+    Output, int INCR_DESIGN, is 0, or 1 if a system was singular.
+*/
+{
+  double *adiag;
+  double *aleft;
+  double *arite;
+  double *coef;
+  double err;
+  double errmax;
+  double *f;
+  int i;
+  int ie;
+  int ie_hi;
+  int ie_lo;
+  int iter;
+  unsigned int seed;
+  incr_data *s;
+  clock_t t0;
+  double tfull;
+  double tincr;
+
+  coef = ( double * ) malloc ( 2 * nsub * sizeof ( double ) );
+  adiag = ( double * ) malloc ( 4 * nu * sizeof ( double ) );
+  aleft = adiag + nu;
+  arite = adiag + 2 * nu;
+  f     = adiag + 3 * nu;
+
+  for ( ie = 0; ie < nsub; ie++ )
+  {
+    coef[0+ie*2] = 1.0;
+    coef[1+ie*2] = 1.0;
+  }
+
+  s = incr_create ( coef, h, indx, nl, node, nu, nquad, nsub, ul, ur, xn, 
+    xquad );
+  if ( s == NULL )
+  {
+    free ( coef );
+    free ( adiag );
+    return 1;
+  }
+
+  if ( verbose )
+  {
+    printf ( "\n" );
+    printf ( "  Design loop of %d iterations on the incremental solver,\n", 
+      niter );
+    printf ( "  NU = %d, refactoring past M = %d.\n", nu, s->mmax );
+    printf ( "\n" );
+    printf ( "  Iter  Elements          M  Difference from full solve\n" );
+    printf ( "\n" );
+  }
+
+  seed = 12345;
+  errmax = 0.0;
+  tincr = 0.0;
+  tfull = 0.0;
+
+  for ( iter = 1; iter <= niter; iter++ )
+  {
+/*
+  Change the coefficients over a window of 1 to 3 elements.
+*/
+    seed = 1103515245 * seed + 12345;
+    ie_lo = ( int ) ( ( seed >> 8 ) % ( unsigned int ) nsub );
+    ie_hi = ie_lo + iter % 3;
+    if ( nsub - 1 < ie_hi )
+    {
+      ie_hi = nsub - 1;
+    }
+    for ( ie = ie_lo; ie <= ie_hi; ie++ )
+    {
+      coef[0+ie*2] = 1.0 + 0.5 * sin ( ( double ) ( iter + ie ) );
+      coef[1+ie*2] = 1.0 + 0.5 * cos ( ( double ) ( 2 * iter + ie ) );
+    }
+    incr_mark ( s, ie_lo, ie_hi );
+
+    t0 = clock ( );
+    if ( incr_solve ( s ) != 0 )
+    {
+      incr_free ( s );
+      free ( coef );
+      free ( adiag );
+      return 1;
+    }
+    tincr = tincr + ( double ) ( clock ( ) - t0 ) / CLOCKS_PER_SEC;
+/*
+  The same system, assembled and solved from scratch.
+*/
+    t0 = clock ( );
+    assemble ( adiag, aleft, arite, f, coef, h, indx, nl, node, nu, nquad, 
+      nsub, ul, ur, xn, xquad );
+    solve ( adiag, aleft, arite, f, nu );
+    tfull = tfull + ( double ) ( clock ( ) - t0 ) / CLOCKS_PER_SEC;
+
+    incr_solution ( s, u );
+    err = 0.0;
+    for ( i = 0; i < nu; i++ )
+    {
+      err = fmax ( err, fabs ( u[i] - f[i] ) );
+    }
+    errmax = fmax ( errmax, err );
+
+    if ( verbose )
+    {
+      printf ( "  %4d  %8d  %8d  %3d  %g\n", iter, ie_lo, ie_hi, s->m, err );
+    }
+  }
+
+  if ( verbose )
+  {
+    printf ( "\n" );
+    printf ( "  Largest difference from the full solves = %g\n", errmax );
+    printf ( "  Seconds in INCR_SOLVE %g, in full ASSEMBLE and SOLVE %g\n", 
+      tincr, tfull );
+  }
+
+  incr_free ( s );
+  free ( coef );
+  free ( adiag );
+
+  return 0;
+}
+/******************************************************************************/
+
+int incr_factor ( incr_data *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    INCR_FACTOR makes the current matrix the base matrix of the solver.
+
+  Discussion:
+
+    The current system is copied to the base system, and both the
+    forward (top to bottom) and the backward (bottom to top) Thomas
+    factors are computed.  The forward factors are those of SOLVE:
+
+      D(0) = ADIAG(0),
+      D(I) = ADIAG(I) - ALEFT(I) * R(I-1),  R(I) = ARITE(I) / D(I)
+
+    and the backward factors are their mirror image:
+
+      E(NU-1) = ADIAG(NU-1),
+      E(I) = ADIAG(I) - ARITE(I) * L(I+1),  L(I) = ALEFT(I) / E(I)
+
+    Together they give any entry of the inverse of A0:
+
+      inverse(A0)(J,J) = 1 / ( D(J) + E(J) - ADIAG(J) )
+      inverse(A0)(I,J) = - R(I) * inverse(A0)(I+1,J),  for I < J
+      inverse(A0)(I,J) = - L(I) * inverse(A0)(I-1,J),  for J < I
+
+    The last two are kept as the running products
+
+      P(J) = product ( 0 <= K < J ) - R(K)
+      Q(I) = product ( 0 < K <= I ) - L(K)
+
+    so that inverse(A0)(I,J) = P(J) / P(I) * inverse(A0)(J,J) for I < J,
+    and Q(I) / Q(J) * inverse(A0)(J,J) for J < I.  The products are
+    stored as a mantissa and a binary exponent, so they do not underflow
+    however long the mesh, and they start again from 1 after a zero
+    factor, which splits the matrix into independent blocks; PSEG and
+    QSEG number the blocks.  A quotient inside one block then has the
+    same rounding as the walk through the factors that it replaces.
+
+    This costs work proportional to NU, and is done by INCR_CREATE, 
+    and by INCR_SOLVE when too many unknowns have changed.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, incr_data *S, the incremental solver.
+
+    Output, int INCR_FACTOR, is 0 on success, or 1 if a zero pivot
+    was encountered.
+*/
+{
+  int i;
+  int nu;
+
+  nu = s->nu;
+
+  for ( i = 0; i < 4 * nu; i++ )
+  {
+    s->adiag0[i] = s->adiag[i];
+  }
+/*
+  Forward factors, and the forward elimination of F.
+*/
+  for ( i = 0; i < nu; i++ )
+  {
+    s->dpiv[i] = s->adiag0[i];
+    s->u0[i] = s->f0[i];
+    if ( 0 < i )
+    {
+      s->dpiv[i] = s->dpiv[i] - s->aleft0[i] * s->rfac[i-1];
+      s->u0[i] = s->u0[i] - s->aleft0[i] * s->u0[i-1];
+    }
+    if ( s->dpiv[i] == 0.0 )
+    {
+      return 1;
+    }
+    s->rfac[i] = s->arite0[i] / s->dpiv[i];
+    s->u0[i] = s->u0[i] / s->dpiv[i];
+  }
+  s->rfac[nu-1] = 0.0;
+/*
+  Back substitution gives the base solution.
+*/
+  for ( i = nu - 2; 0 <= i; i-- )
+  {
+    s->u0[i] = s->u0[i] - s->rfac[i] * s->u0[i+1];
+  }
+/*
+  Backward factors.
+*/
+  for ( i = nu - 1; 0 <= i; i-- )
+  {
+    s->epiv[i] = s->adiag0[i];
+    if ( i < nu - 1 )
+    {
+      s->epiv[i] = s->epiv[i] - s->arite0[i] * s->lfac[i+1];
+    }
+    if ( s->epiv[i] == 0.0 )
+    {
+      return 1;
+    }
+    s->lfac[i] = s->aleft0[i] / s->epiv[i];
+  }
+  s->lfac[0] = 0.0;
+/*
+  The diagonal of the inverse, and the running products.
+*/
+  for ( i = 0; i < nu; i++ )
+  {
+    s->gdiag[i] = 1.0 / ( s->dpiv[i] + s->epiv[i] - s->adiag0[i] );
+  }
+  s->pman[0] = 1.0;
+  s->pexp[0] = 0;
+  s->pseg[0] = 0;
+  s->qman[0] = 1.0;
+  s->qexp[0] = 0;
+  s->qseg[0] = 0;
+  for ( i = 1; i < nu; i++ )
+  {
+    incr_product ( s->pman[i-1], s->pexp[i-1], s->pseg[i-1], - s->rfac[i-1],
+      s->pman + i, s->pexp + i, s->pseg + i );
+    incr_product ( s->qman[i-1], s->qexp[i-1], s->qseg[i-1], - s->lfac[i],
+      s->qman + i, s->qexp + i, s->qseg + i );
+  }
+/*
+  The current system is now the base system.
+*/
+  for ( i = 0; i < s->m; i++ )
+  {
+    s->pos[s->set[i]] = -1;
+  }
+  s->m = 0;
+
+  return 0;
+}
+/******************************************************************************/
+
+void incr_free ( incr_data *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    INCR_FREE frees the memory used by the incremental solver.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, incr_data *S, the incremental solver.
+*/
+{
+  free ( s->adiag );
+  free ( s->adiag0 );
+  free ( s->dpiv );
+  free ( s->pexp );
+  free ( s->elem );
+  free ( s->dirty );
+  free ( s->pos );
+  free ( s->set );
+  free ( s->w );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+double incr_inverse ( incr_data *s, int i, int j )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    INCR_INVERSE returns one entry of the inverse of the base matrix.
+
+  Discussion:
+
+    The entry is a quotient of the running products of INCR_FACTOR, so
+    the work does not depend on the distance between I and J.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, incr_data *S, the incremental solver.
+
+    Input, int I, J, the row and column of the entry.
+
+    Output, double INCR_INVERSE, the entry (I,J) of inverse(A0).
+*/
+{
+  double value;
+
+  if ( i < j )
+  {
+    if ( s->pseg[i] != s->pseg[j] )
+    {
+      return 0.0;
+    }
+    value = ldexp ( s->pman[j] / s->pman[i], s->pexp[j] - s->pexp[i] );
+  }
+  else if ( j < i )
+  {
+    if ( s->qseg[i] != s->qseg[j] )
+    {
+      return 0.0;
+    }
+    value = ldexp ( s->qman[i] / s->qman[j], s->qexp[i] - s->qexp[j] );
+  }
+  else
+  {
+    value = 1.0;
+  }
+  return value * s->gdiag[j];
+}
+/******************************************************************************/
+
+void incr_mark ( incr_data *s, int ie_lo, int ie_hi )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    INCR_MARK marks a range of elements as changed.
+
+  Discussion:
+
+    The caller should mark every element over which PP or QQ has
+    changed since the last call to INCR_SOLVE.  Nothing is computed
+    until INCR_SOLVE is called.  An element marked more than once is
+    listed, and counted in S->NDIRTY, once.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, incr_data *S, the incremental solver.
+
+    Input, int IE_LO, IE_HI, the first and last elements to mark.
+    Elements are numbered from 0 to NSUB-1.
 */
 {
-  double value;
+  int ie;
 
-  value = 0.0;
+  if ( ie_lo < 0 )
+  {
+    ie_lo = 0;
+  }
+  if ( s->nsub - 1 < ie_hi )
+  {
+    ie_hi = s->nsub - 1;
+  }
 
-  return value;
+  for ( ie = ie_lo; ie <= ie_hi; ie++ )
+  {
+    if ( !s->dirty[ie] )
+    {
+      s->dirty[ie] = 1;
+      s->list[s->ndirty] = ie;
+      s->ndirty = s->ndirty + 1;
+    }
+  }
+
+  return;
 }
 /******************************************************************************/
 
-void geometry ( double h[], int ibc, int indx[], int nl, int node[], int nsub, 
-  int *nu, double xl, double xn[], double xquad[], double xr )
+void incr_product ( double man, int ex, int seg, double factor, double *man2, 
+  int *ex2, int *seg2 )
 
 /******************************************************************************/
 /*
-  Purpose: 
+  Purpose:
 
-    GEOMETRY sets up the geometry for the interval [XL,XR].
+    INCR_PRODUCT extends a running product by one factor.
+
+  Discussion:
+
+    The product is MAN * 2^EX, with MAN normalized by FREXP.  A zero
+    factor starts a new block SEG+1 whose product is 1; see INCR_FACTOR.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
 
   Modified:
 
-    29 May 2009
+    19 October 2026
 
-  Author:
+  Parameters:
 
-    C version by John Burkardt
+    Input, double MAN, int EX, int SEG, the product so far, and its block.
+
+    Input, double FACTOR, the next factor.
+
+    Output, double *MAN2, int *EX2, int *SEG2, the extended product, and
+    its block.
+*/
+{
+  int e;
+
+  if ( factor == 0.0 )
+  {
+    *man2 = 1.0;
+    *ex2 = 0;
+    *seg2 = seg + 1;
+    return;
+  }
+
+  *man2 = frexp ( man * factor, &e );
+  *ex2 = ex + e;
+  *seg2 = seg;
+
+  return;
+}
+/******************************************************************************/
+
+void incr_solution ( incr_data *s, double u[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    INCR_SOLUTION returns the whole solution vector.
+
+  Discussion:
+
+    The correction inverse(A0) * P * W is computed with the stored
+    forward factors.  Since P * W is zero above the first unknown of S,
+    the forward elimination starts there.  The work is proportional to
+    NU, so callers who need only a few values should use INCR_VALUE.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
 
   Parameters:
 
-    Output, double H(NSUB)
-    H(I) is the length of subinterval I.  This code uses
-    equal spacing for all the subintervals.
+    Input, incr_data *S, the incremental solver.
 
-    Input, int IBC.
-    IBC declares what the boundary conditions are.
-    1, at the left endpoint, U has the value UL,
-       at the right endpoint, U' has the value UR.
-    2, at the left endpoint, U' has the value UL,
-       at the right endpoint, U has the value UR.
-    3, at the left endpoint, U has the value UL,
-       and at the right endpoint, U has the value UR.
-    4, at the left endpoint, U' has the value UL,
-       at the right endpoint U' has the value UR.
+    Output, double U[NU], the solution of the current system.
+*/
+{
+  int i;
+  int k;
+  int nu;
 
-    Output, int INDX[NSUB+1].
-    For a node I, INDX(I) is the index of the unknown
-    associated with node I.
-    If INDX(I) is equal to -1, then no unknown is associated
-    with the node, because a boundary condition fixing the
-    value of U has been applied at the node instead.
-    Unknowns are numbered beginning with 1.
-    If IBC is 2 or 4, then there is an unknown value of U
-    at node 0, which will be unknown number 1.  Otherwise,
-    unknown number 1 will be associated with node 1.
-    If IBC is 1 or 4, then there is an unknown value of U
-    at node NSUB, which will be unknown NSUB or NSUB+1,
-    depending on whether there was an unknown at node 0.
+  nu = s->nu;
 
-    Input, int NL.
-    The number of basis functions used in a single
-    subinterval.  (NL-1) is the degree of the polynomials
-    used.  For this code, NL is fixed at 2, meaning that
-    piecewise linear functions are used as the basis.
+  if ( s->m == 0 )
+  {
+    for ( i = 0; i < nu; i++ )
+    {
+      u[i] = s->u0[i];
+    }
+    return;
+  }
 
-    Output, int NODE[NL*NSUB].
-    For each subinterval I:
-    NODE[0+I*2] is the number of the left node, and
-    NODE[1+I*2] is the number of the right node.
+  for ( i = 0; i < s->set[0]; i++ )
+  {
+    u[i] = 0.0;
+  }
+  k = 0;
+  for ( i = s->set[0]; i < nu; i++ )
+  {
+    u[i] = 0.0;
+    if ( k < s->m && s->set[k] == i )
+    {
+      u[i] = s->w[k];
+      k = k + 1;
+    }
+    if ( 0 < i )
+    {
+      u[i] = u[i] - s->aleft0[i] * u[i-1];
+    }
+    u[i] = u[i] / s->dpiv[i];
+  }
+  for ( i = nu - 2; 0 <= i; i-- )
+  {
+    u[i] = u[i] - s->rfac[i] * u[i+1];
+  }
+  for ( i = 0; i < nu; i++ )
+  {
+    u[i] = s->u0[i] + u[i];
+  }
+  return;
+}
+/******************************************************************************/
 
-    Input, int NSUB.
-    The number of subintervals into which the interval [XL,XR] is broken.
+int incr_solve ( incr_data *s )
 
-    Output, int *NU.
-    NU is the number of unknowns in the linear system.
-    Depending on the value of IBC, there will be NSUB-1,
-    NSUB, or NSUB+1 unknown values, which are the coefficients
-    of basis functions.
+/******************************************************************************/
+/*
+  Purpose:
 
-    Input, double XL.
-    XL is the left endpoint of the interval over which the
-    differential equation is being solved.
+    INCR_SOLVE updates the solution after some elements have changed.
 
-    Output, double XN(0:NSUB).
-    XN(I) is the location of the I-th node.  XN(0) is XL,
-    and XN(NSUB) is XR.
+  Discussion:
 
-    Output, double XQUAD(NSUB)
-    XQUAD(I) is the location of the single quadrature point
-    in interval I.
+    Each element on the list kept by INCR_MARK is evaluated again, and
+    the difference from its stored contribution is added to the current
+    system.  The unknowns
+    of the element join the set S of unknowns whose rows differ from
+    the base system.
 
-    Input, double XR.
-    XR is the right endpoint of the interval over which the
-    differential equation is being solved.
+    If S has grown past S->MMAX unknowns, the current matrix is simply
+    factored again.  Otherwise the small system of the Sherman-Morrison-
+    Woodbury formula is formed and solved; see INCR_CREATE.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, incr_data *S, the incremental solver.
+
+    Output, int INCR_SOLVE, is 0 on success, or 1 if the system
+    is singular.
 */
 {
+  double ae[6];
+  double *d;
+  int a;
+  int b;
   int i;
+  int ie;
+  int il;
+  int iu;
+  int k;
+  int l;
+  int m;
+  int ne;
+  double *g;
+  double *r;
+  double value;
+
+  ne = s->nl * s->nl + s->nl;
 /*
-  Set the value of XN, the locations of the nodes.
+  Reassemble the changed elements, and collect their unknowns in S,
+  which is kept in increasing order.
 */
-  printf ( "\n" );
-  printf ( "  Node      Location\n" );
-  printf ( "\n" );
-  for ( i = 0; i <= nsub; i++ )
+  if ( 0 < s->ndirty )
   {
-    xn[i]  =  ( ( double ) ( nsub - i ) * xl 
-              + ( double )          i   * xr ) 
-              / ( double ) ( nsub );
-    printf ( "  %8d  %14f \n", i, xn[i] );
+    for ( l = 0; l < s->ndirty; l++ )
+    {
+      ie = s->list[l];
+      s->dirty[ie] = 0;
+
+      assemble_element ( ae, s->coef, s->h, ie, s->indx, s->nl, s->node, 
+        s->nquad, s->nsub, s->ul, s->ur, s->xn, s->xquad );
+      for ( i = 0; i < ne; i++ )
+      {
+        value = ae[i];
+        ae[i] = ae[i] - s->elem[i+ie*ne];
+        s->elem[i+ie*ne] = value;
+      }
+      assemble_add ( s->adiag, s->aleft, s->arite, s->f, ae, ie, s->indx, 
+        s->nl, s->node );
+
+      for ( il = 0; il < s->nl; il++ )
+      {
+        iu = s->indx[s->node[il+ie*2]] - 1;
+        if ( iu < 0 || 0 <= s->pos[iu] )
+        {
+          continue;
+        }
+        for ( k = s->m; 0 < k && iu < s->set[k-1]; k-- )
+        {
+          s->set[k] = s->set[k-1];
+          s->pos[s->set[k]] = k;
+        }
+        s->set[k] = iu;
+        s->pos[iu] = k;
+        s->m = s->m + 1;
+      }
+    }
+    s->ndirty = 0;
   }
-/*
-  Set the lengths of each subinterval.
-*/
-  printf ( "\n" );
-  printf ( "Subint    Length\n" );
-  printf ( "\n" );
-  for ( i = 0; i < nsub; i++ )
+
+  m = s->m;
+
+  if ( m == 0 )
   {
-    h[i] = xn[i+1] - xn[i];
-    printf ( "  %8d  %14f\n", i+1, h[i] );
+    return 0;
   }
-/*
-  Set the quadrature points, each of which is the midpoint
-  of its subinterval.
-*/
-  printf ( "\n" );
-  printf ( "Subint    Quadrature point\n" );
-  printf ( "\n" );
-  for ( i = 0; i < nsub; i++ )
+
+  if ( s->mmax < m )
   {
-    xquad[i] = 0.5 * ( xn[i] + xn[i+1] );
-    printf ( "  %8d  %14f\n", i+1, xquad[i] );
+    return incr_factor ( s );
   }
-/*
-  Set the value of NODE, which records, for each interval,
-  the node numbers at the left and right.
-*/
-  printf ( "\n" );
-  printf ( "Subint  Left Node  Right Node\n" );
-  printf ( "\n" );
-  for ( i = 0; i < nsub; i++ )
+
+  if ( s->mcap < m )
   {
-    node[0+i*2] = i;
-    node[1+i*2] = i + 1;
-    printf ( "  %8d  %8d  %8d\n", i+1, node[0+i*2], node[1+i*2] );
+    free ( s->w );
+    s->mcap = s->mmax;
+    s->w = ( double * ) malloc ( ( 2 * s->mcap * s->mcap + 2 * s->mcap ) 
+      * sizeof ( double ) );
   }
+  d = s->w + s->mcap;
+  g = d + s->mcap * s->mcap;
+  r = g + s->mcap * s->mcap;
 /*
-  Starting with node 0, see if an unknown is associated with
-  the node.  If so, give it an index.
+  D = ( A - A0 )(S,S), which is tridiagonal in the numbering of A.
 */
-  *nu = 0;
+  for ( k = 0; k < m * m; k++ )
+  {
+    d[k] = 0.0;
+  }
+  for ( a = 0; a < m; a++ )
+  {
+    i = s->set[a];
+    d[a+a*m] = s->adiag[i] - s->adiag0[i];
+    if ( a + 1 < m && s->set[a+1] == i + 1 )
+    {
+      d[a+(a+1)*m] = s->arite[i] - s->arite0[i];
+      d[a+1+a*m] = s->aleft[i+1] - s->aleft0[i+1];
+    }
+  }
 /*
-  Handle first node.
+  G = inverse(A0)(S,S), one quotient per entry.
 */
-  i = 0;
-  if ( ibc == 1 || ibc == 3 )
+  for ( b = 0; b < m; b++ )
   {
-    indx[i] = -1;
+    for ( a = 0; a < m; a++ )
+    {
+      g[a+b*m] = incr_inverse ( s, s->set[a], s->set[b] );
+    }
   }
-  else
+/*
+  Right hand side ( F - F0 )(S) - D * U0(S).
+*/
+  for ( a = 0; a < m; a++ )
   {
-    *nu = *nu + 1;
-    indx[i] = *nu;
+    i = s->set[a];
+    r[a] = s->f[i] - s->f0[i];
+    for ( b = 0; b < m; b++ )
+    {
+      r[a] = r[a] - d[a+b*m] * s->u0[s->set[b]];
+    }
   }
 /*
-  Handle nodes 1 through nsub-1
+  Overwrite G with I + D * G, using D's band structure.
 */
-  for ( i = 1; i < nsub; i++ )
+  for ( b = 0; b < m; b++ )
   {
-    *nu = *nu + 1;
-    indx[i] = *nu;
+    for ( a = 0; a < m; a++ )
+    {
+      s->w[a] = d[a+a*m] * g[a+b*m];
+      if ( 0 < a )
+      {
+        s->w[a] = s->w[a] + d[a+(a-1)*m] * g[a-1+b*m];
+      }
+      if ( a < m - 1 )
+      {
+        s->w[a] = s->w[a] + d[a+(a+1)*m] * g[a+1+b*m];
+      }
+    }
+    for ( a = 0; a < m; a++ )
+    {
+      g[a+b*m] = s->w[a];
+    }
+    g[b+b*m] = g[b+b*m] + 1.0;
   }
-/*
-  Handle the last node.
-/*/
-  i = nsub;
 
-  if ( ibc == 2 || ibc == 3 )
+  if ( r8mat_fs ( m, g, r ) != 0 )
   {
-    indx[i] = -1;
+    return 1;
   }
-  else
+  for ( a = 0; a < m; a++ )
   {
-    *nu = *nu + 1;
-    indx[i] = *nu;
+    s->w[a] = r[a];
   }
+  return 0;
+}
+/******************************************************************************/
 
-  printf ( "\n" );
-  printf ( "  Number of unknowns NU = %8d\n", *nu );
-  printf ( "\n" );
-  printf ( "  Node  Unknown\n" );
-  printf ( "\n" );
-  for ( i = 0; i <= nsub; i++ )
+double incr_value ( incr_data *s, int iu )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    INCR_VALUE returns one entry of the solution vector.
+
+  Discussion:
+
+    The work is proportional to M.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, incr_data *S, the incremental solver.
+
+    Input, int IU, the index of the unknown, between 0 and NU-1.
+
+    Output, double INCR_VALUE, the value of the unknown.
+*/
+{
+  int a;
+  double value;
+
+  value = s->u0[iu];
+
+  for ( a = 0; a < s->m; a++ )
   {
-    printf ( "  %8d  %8d\n", i, indx[i] );
+    value = value + incr_inverse ( s, iu, s->set[a] ) * s->w[a];
   }
-
-  return;
+  return value;
 }
 /******************************************************************************/
 
@@ -817,37 +3082,67 @@ void init ( int *ibc, int *nquad, double *ul, double *ur, double *xl,
 */
   *xl = 0.0;
   *xr = 1.0;
+
+  return;
+}
+/******************************************************************************/
+
+void init_print ( int ibc, int nquad, double ul, double ur, double xl, 
+  double xr )
+
+/******************************************************************************/
 /*
-  Print out the values that have been set.
+  Purpose: 
+
+    INIT_PRINT prints the values assigned by INIT.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int IBC, the boundary conditions.
+
+    Input, int NQUAD, the number of quadrature points per subinterval.
+
+    Input, double UL, UR, the boundary values at XL and XR.
+
+    Input, double XL, XR, the endpoints of the interval.
 */
+{
   printf ( "\n" );
   printf ( "  The equation is to be solved for\n" );
-  printf ( "  X greater than XL = %f\n", *xl );
-  printf ( "  and less than XR = %f\n", *xr );
+  printf ( "  X greater than XL = %f\n", xl );
+  printf ( "  and less than XR = %f\n", xr );
   printf ( "\n" );
   printf ( "  The boundary conditions are:\n" );
   printf ( "\n" );
 
-  if ( *ibc == 1 || *ibc == 3 )
+  if ( ibc == 1 || ibc == 3 )
   {
-    printf ( "  At X = XL, U = %f\n", *ul );
+    printf ( "  At X = XL, U = %f\n", ul );
   }
   else
   {
-    printf ( "  At X = XL, U' = %f\n", *ul );
+    printf ( "  At X = XL, U' = %f\n", ul );
   }
 
-  if ( *ibc == 2 || *ibc == 3 )
+  if ( ibc == 2 || ibc == 3 )
   {
-    printf ( "  At X = XR, U = %f\n", *ur );
+    printf ( "  At X = XR, U = %f\n", ur );
   }
   else
   {
-    printf ( "  At X = XR, U' = %f\n", *ur );
+    printf ( "  At X = XR, U' = %f\n", ur );
   }
 
   printf ( "\n" );
-  printf ( "  Number of quadrature points per element is %d\n", *nquad );
+  printf ( "  Number of quadrature points per element is %d\n", nquad );
 
   return;
 }
@@ -900,97 +3195,311 @@ void output ( double f[], int ibc, int indx[], int nsub, int nu, double ul,
     4, at the left endpoint, U' has the value UL,
        at the right endpoint U' has the value UR.
 
-    Input, int INDX[NSUB+1].
-    For a node I, INDX(I) is the index of the unknown
-    associated with node I.
-    If INDX(I) is equal to -1, then no unknown is associated
-    with the node, because a boundary condition fixing the
-    value of U has been applied at the node instead.
-    Unknowns are numbered beginning with 1.
-    If IBC is 2 or 4, then there is an unknown value of U
-    at node 0, which will be unknown number 1.  Otherwise,
-    unknown number 1 will be associated with node 1.
-    If IBC is 1 or 4, then there is an unknown value of U
-    at node NSUB, which will be unknown NSUB or NSUB+1,
-    depending on whether there was an unknown at node 0.
+    Input, int INDX[NSUB+1].
+    For a node I, INDX(I) is the index of the unknown
+    associated with node I.
+    If INDX(I) is equal to -1, then no unknown is associated
+    with the node, because a boundary condition fixing the
+    value of U has been applied at the node instead.
+    Unknowns are numbered beginning with 1.
+    If IBC is 2 or 4, then there is an unknown value of U
+    at node 0, which will be unknown number 1.  Otherwise,
+    unknown number 1 will be associated with node 1.
+    If IBC is 1 or 4, then there is an unknown value of U
+    at node NSUB, which will be unknown NSUB or NSUB+1,
+    depending on whether there was an unknown at node 0.
+
+    Input, int NSUB.
+    The number of subintervals into which the interval [XL,XR] is broken.
+
+    Input, int NU.
+    NU is the number of unknowns in the linear system.
+    Depending on the value of IBC, there will be NSUB-1,
+    NSUB, or NSUB+1 unknown values, which are the coefficients
+    of basis functions.
+
+    Input, double UL.
+    If IBC is 1 or 3, UL is the value that U is required
+    to have at X = XL.
+    If IBC is 2 or 4, UL is the value that U' is required
+    to have at X = XL.
+
+    Input, double UR.
+    If IBC is 2 or 3, UR is the value that U is required
+    to have at X = XR.
+    If IBC is 1 or 4, UR is the value that U' is required
+    to have at X = XR.
+
+    Input, double XN(0:NSUB).
+    XN(I) is the location of the I-th node.  XN(0) is XL,
+    and XN(NSUB) is XR.
+*/
+{
+  int i;
+  double u;
+
+  printf ( "\n" );
+  printf ( "  Computed solution coefficients:\n" );
+  printf ( "\n" );
+  printf ( "  Node    X(I)        U(X(I))\n" );
+  printf ( "\n" );
+
+  for ( i = 0; i <= nsub; i++ )
+  {
+    u = output_value ( f, ibc, indx, i, nsub, ul, ur );
+
+    printf ( "  %8d  %8f  %14f\n", i, xn[i], u );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void output_block ( sink *s, int nb, double f[], int ibc, int indx[], 
+  int nsub, double ul[], double ur[], double xn[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    OUTPUT_BLOCK writes the computed solution of a coupled system.
+
+  Discussion:
+
+    If S is NULL, the solution is printed as a table, like OUTPUT.
+    Otherwise each row written to S holds the node number, its location,
+    and the NB components of the solution there.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, sink *S, a sink with NB+2 columns, or NULL.
+
+    Input, int NB, the number of fields.
+
+    Input, double F[NU*NB], the solution computed by SOLVE_BLOCK.
+
+    Input, int IBC, the boundary conditions.
+
+    Input, int INDX[NSUB+1], the index of the unknown associated with 
+    each node, or -1.
+
+    Input, int NSUB, the number of subintervals.
+
+    Input, double UL[NB], UR[NB], the boundary values at XL and XR.
+
+    Input, double XN(0:NSUB), the location of the nodes.
+*/
+{
+  int i;
+  int r;
+  double *row;
+  double *u;
+
+  if ( s != NULL && s->mode == SINK_OFF )
+  {
+    return;
+  }
+
+  if ( s == NULL )
+  {
+    printf ( "\n" );
+    printf ( "  Computed solution coefficients:\n" );
+    printf ( "\n" );
+    printf ( "  Node    X(I)        U(X(I))\n" );
+    printf ( "\n" );
+  }
+
+  row = ( double * ) malloc ( ( nb + 2 ) * sizeof ( double ) );
+
+  for ( i = 0; i <= nsub; i++ )
+  {
+    if ( i == 0 && ( ibc == 1 || ibc == 3 ) )
+    {
+      u = ul;
+    }
+    else if ( i == nsub && ( ibc == 2 || ibc == 3 ) )
+    {
+      u = ur;
+    }
+    else
+    {
+      u = f + ( indx[i] - 1 ) * nb;
+    }
+
+    if ( s == NULL )
+    {
+      printf ( "  %8d  %8f", i, xn[i] );
+      for ( r = 0; r < nb; r++ )
+      {
+        printf ( "  %14f", u[r] );
+      }
+      printf ( "\n" );
+    }
+    else
+    {
+      row[0] = ( double ) i;
+      row[1] = xn[i];
+      for ( r = 0; r < nb; r++ )
+      {
+        row[r+2] = u[r];
+      }
+      sink_row ( s, row );
+    }
+  }
+
+  free ( row );
+
+  return;
+}
+/******************************************************************************/
+
+void output_sink ( sink *s, double f[], int ibc, int indx[], int nsub, 
+  double ul, double ur, double xn[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    OUTPUT_SINK writes the computed solution to a results sink.
+
+  Discussion:
+
+    Each row holds the node number, its location, and the value of
+    the solution there.  Unlike OUTPUT, nothing is printed unless the
+    sink was opened for standard output.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, sink *S, a sink with three columns.
+
+    Input, double F(NU), the solution of the linear equations.
+
+    Input, int IBC, the boundary conditions.
+
+    Input, int INDX[NSUB+1], the index of the unknown associated with 
+    each node, or -1.
+
+    Input, int NSUB, the number of subintervals.
+
+    Input, double UL, UR, the boundary values at XL and XR.
+
+    Input, double XN(0:NSUB), the location of the nodes.
+*/
+{
+  int i;
+  double row[3];
+
+  if ( s->mode == SINK_OFF )
+  {
+    return;
+  }
+
+  for ( i = 0; i <= nsub; i++ )
+  {
+    row[0] = ( double ) i;
+    row[1] = xn[i];
+    row[2] = output_value ( f, ibc, indx, i, nsub, ul, ur );
+    sink_row ( s, row );
+  }
+  return;
+}
+/******************************************************************************/
+
+double output_value ( double f[], int ibc, int indx[], int i, int nsub, 
+  double ul, double ur )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    OUTPUT_VALUE returns the computed solution at one node.
+
+  Discussion:
+
+    For most nodes, the value is stored in F, but at a node where U
+    was specified, it is the boundary value.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
 
-    Input, int NSUB.
-    The number of subintervals into which the interval [XL,XR] is broken.
+    18 October 2026
 
-    Input, int NU.
-    NU is the number of unknowns in the linear system.
-    Depending on the value of IBC, there will be NSUB-1,
-    NSUB, or NSUB+1 unknown values, which are the coefficients
-    of basis functions.
+  Parameters:
 
-    Input, double UL.
-    If IBC is 1 or 3, UL is the value that U is required
-    to have at X = XL.
-    If IBC is 2 or 4, UL is the value that U' is required
-    to have at X = XL.
+    Input, double F(NU), the solution of the linear equations.
 
-    Input, double UR.
-    If IBC is 2 or 3, UR is the value that U is required
-    to have at X = XR.
-    If IBC is 1 or 4, UR is the value that U' is required
-    to have at X = XR.
+    Input, int IBC, the boundary conditions.
 
-    Input, double XN(0:NSUB).
-    XN(I) is the location of the I-th node.  XN(0) is XL,
-    and XN(NSUB) is XR.
+    Input, int INDX[NSUB+1], the index of the unknown associated with 
+    each node, or -1.
+
+    Input, int I, the node, between 0 and NSUB.
+
+    Input, int NSUB, the number of subintervals.
+
+    Input, double UL, UR, the boundary values at XL and XR.
+
+    Output, double OUTPUT_VALUE, the value of the solution at node I.
 */
 {
-  int i;
   double u;
 
-  printf ( "\n" );
-  printf ( "  Computed solution coefficients:\n" );
-  printf ( "\n" );
-  printf ( "  Node    X(I)        U(X(I))\n" );
-  printf ( "\n" );
-
-  for ( i = 0; i <= nsub; i++ )
-  {
 /*
   If we're at the first node, check the boundary condition.
 */
-    if ( i == 0 )
+  if ( i == 0 )
+  {
+    if ( ibc == 1 || ibc == 3 )
     {
-      if ( ibc == 1 || ibc == 3 )
-      {
-        u = ul;
-      }
-      else
-      {
-        u = f[indx[i]-1];
-      }
+      u = ul;
+    }
+    else
+    {
+      u = f[indx[i]-1];
     }
+  }
 /*
   If we're at the last node, check the boundary condition.
 */
-    else if ( i == nsub )
+  else if ( i == nsub )
+  {
+    if ( ibc == 2 || ibc == 3 )
     {
-      if ( ibc == 2 || ibc == 3 )
-      {
-        u = ur;
-      }
-      else
-      {
-        u = f[indx[i]-1];
-      }
+      u = ur;
     }
-/*
-  Any other node, we're sure the value is stored in F.
-*/
     else
     {
       u = f[indx[i]-1];
     }
-
-    printf ( "  %8d  %8f  %14f\n", i, xn[i], u );
+  }
+/*
+  Any other node, we're sure the value is stored in F.
+*/
+  else
+  {
+    u = f[indx[i]-1];
   }
 
-  return;
+  return u;
 }
 /******************************************************************************/
 
@@ -1106,6 +3615,53 @@ double pp ( double x )
 }
 /******************************************************************************/
 
+void ppb ( double x, int nb, double p[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PPB evaluates the matrix P of a system of NB coupled equations.
+
+  Discussion:
+
+    The matrix P appears in the system as:
+
+      - d/dx (P du/dx) + Q u  =  f
+
+    Here the fields diffuse independently, so P is the identity.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double X, the argument of the function.
+
+    Input, int NB, the number of fields.
+
+    Output, double P[NB*NB], the value of the matrix, in column-major order.
+*/
+{
+  int c;
+  int r;
+
+  for ( c = 0; c < nb; c++ )
+  {
+    for ( r = 0; r < nb; r++ )
+    {
+      p[r+c*nb] = ( r == c ) ? 1.0 : 0.0;
+    }
+  }
+  return;
+}
+/******************************************************************************/
+
 void prsys ( double adiag[], double aleft[], double arite[], double f[], 
   int nu )
 
@@ -1216,6 +3772,181 @@ double qq ( double x )
 }
 /******************************************************************************/
 
+void qqb ( double x, int nb, double q[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    QQB evaluates the matrix Q of a system of NB coupled equations.
+
+  Discussion:
+
+    The matrix Q appears in the system as:
+
+      - d/dx (P du/dx) + Q u  =  f
+
+    Here each field decays, and exchanges with its neighbors:
+
+      Q(I,I) = 1,  Q(I,I-1) = Q(I,I+1) = -1/2.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double X, the argument of the function.
+
+    Input, int NB, the number of fields.
+
+    Output, double Q[NB*NB], the value of the matrix, in column-major order.
+*/
+{
+  int c;
+  int r;
+
+  for ( c = 0; c < nb; c++ )
+  {
+    for ( r = 0; r < nb; r++ )
+    {
+      if ( r == c )
+      {
+        q[r+c*nb] = 1.0;
+      }
+      else if ( r == c - 1 || r == c + 1 )
+      {
+        q[r+c*nb] = -0.5;
+      }
+      else
+      {
+        q[r+c*nb] = 0.0;
+      }
+    }
+  }
+  return;
+}
+/******************************************************************************/
+
+int r8mat_fs ( int n, double a[], double x[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    R8MAT_FS factors and solves a system with one right hand side.
+
+  Discussion:
+
+    An R8MAT is a doubly dimensioned array of R8 values, stored as a vector 
+    in column-major order.
+
+    Gauss elimination with partial pivoting is used.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int N, the order of the matrix.
+
+    Input/output, double A[N*N].  On input, the coefficient matrix.
+    On output, it has been overwritten by its factors.
+
+    Input/output, double X[N].  On input, the right hand side.
+    On output, the solution.
+
+    Output, int R8MAT_FS, is 0 on success, or 1 if the matrix is singular.
+*/
+{
+  int i;
+  int ipiv;
+  int j;
+  int jcol;
+  double piv;
+  double t;
+
+  for ( jcol = 0; jcol < n; jcol++ )
+  {
+/*
+  Find the maximum element in column JCOL, and swap it into place.
+*/
+    piv = fabs ( a[jcol+jcol*n] );
+    ipiv = jcol;
+    for ( i = jcol + 1; i < n; i++ )
+    {
+      if ( piv < fabs ( a[i+jcol*n] ) )
+      {
+        piv = fabs ( a[i+jcol*n] );
+        ipiv = i;
+      }
+    }
+
+    if ( piv == 0.0 )
+    {
+      return 1;
+    }
+
+    if ( ipiv != jcol )
+    {
+      for ( j = 0; j < n; j++ )
+      {
+        t = a[jcol+j*n];
+        a[jcol+j*n] = a[ipiv+j*n];
+        a[ipiv+j*n] = t;
+      }
+      t = x[jcol];
+      x[jcol] = x[ipiv];
+      x[ipiv] = t;
+    }
+/*
+  Scale the pivot row, and eliminate below it.
+*/
+    t = a[jcol+jcol*n];
+    a[jcol+jcol*n] = 1.0;
+    for ( j = jcol + 1; j < n; j++ )
+    {
+      a[jcol+j*n] = a[jcol+j*n] / t;
+    }
+    x[jcol] = x[jcol] / t;
+
+    for ( i = jcol + 1; i < n; i++ )
+    {
+      if ( a[i+jcol*n] != 0.0 )
+      {
+        t = - a[i+jcol*n];
+        a[i+jcol*n] = 0.0;
+        for ( j = jcol + 1; j < n; j++ )
+        {
+          a[i+j*n] = a[i+j*n] + t * a[jcol+j*n];
+        }
+        x[i] = x[i] + t * x[jcol];
+      }
+    }
+  }
+/*
+  Back solve.
+*/
+  for ( jcol = n - 1; 1 <= jcol; jcol-- )
+  {
+    for ( i = 0; i < jcol; i++ )
+    {
+      x[i] = x[i] - a[i+jcol*n] * x[jcol];
+    }
+  }
+  return 0;
+}
+/******************************************************************************/
+
 void solve ( double adiag[], double aleft[], double arite[], double f[], 
   int nu )
 
@@ -1290,6 +4021,97 @@ void solve ( double adiag[], double aleft[], double arite[], double f[],
   return;
 }
 /******************************************************************************/
+/*
+  SOLVE_BLOCK_NB defines SOLVE_BLOCK_2 through SOLVE_BLOCK_8, copies of
+  BLOCK_THOMAS in which the order of the blocks is a constant, so that
+  the small LU factorizations and products are unrolled.
+*/
+# define SOLVE_BLOCK_NB(NB) \
+int solve_block_ ## NB ( int nu, double adiag[], double aleft[], \
+  double arite[], double f[] ) \
+{ \
+  int piv[NB]; \
+  return block_thomas ( NB, nu, adiag, aleft, arite, f, piv ); \
+}
+
+SOLVE_BLOCK_NB ( 2 )
+SOLVE_BLOCK_NB ( 3 )
+SOLVE_BLOCK_NB ( 4 )
+SOLVE_BLOCK_NB ( 5 )
+SOLVE_BLOCK_NB ( 6 )
+SOLVE_BLOCK_NB ( 7 )
+SOLVE_BLOCK_NB ( 8 )
+
+# undef SOLVE_BLOCK_NB
+/******************************************************************************/
+
+int solve_block ( int nb, int nu, double adiag[], double aleft[], 
+  double arite[], double f[] )
+
+/******************************************************************************/
+/*
+  Purpose: 
+
+    SOLVE_BLOCK solves a block tridiagonal system.
+
+  Discussion:
+
+    The system is the one assembled by ASSEMBLE_BLOCK.  Block orders 
+    2 through 8 are handled by specialized copies of BLOCK_THOMAS; other
+    orders use the general code.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int NB, the order of the blocks.
+
+    Input, int NU, the number of block rows.
+
+    Input/output, double ADIAG[NU*NB*NB], ALEFT[NU*NB*NB], ARITE[NU*NB*NB],
+    the blocks of the matrix, which are overwritten.
+
+    Input/output, double F[NU*NB].  On input, the right hand side.
+    On output, the solution.
+
+    Output, int SOLVE_BLOCK, is 0 on success, or 1 if a diagonal block 
+    was singular.
+*/
+{
+  int *piv;
+  int value;
+
+  switch ( nb )
+  {
+    case 2:
+      return solve_block_2 ( nu, adiag, aleft, arite, f );
+    case 3:
+      return solve_block_3 ( nu, adiag, aleft, arite, f );
+    case 4:
+      return solve_block_4 ( nu, adiag, aleft, arite, f );
+    case 5:
+      return solve_block_5 ( nu, adiag, aleft, arite, f );
+    case 6:
+      return solve_block_6 ( nu, adiag, aleft, arite, f );
+    case 7:
+      return solve_block_7 ( nu, adiag, aleft, arite, f );
+    case 8:
+      return solve_block_8 ( nu, adiag, aleft, arite, f );
+  }
+
+  piv = ( int * ) malloc ( nb * sizeof ( int ) );
+  value = block_thomas ( nb, nu, adiag, aleft, arite, f, piv );
+  free ( piv );
+
+  return value;
+}
+/******************************************************************************/
 
 void timestamp ( void )
 
@@ -0,0 +1,794 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <math.h>
+
+# include "fit.h"
+# include "pool.h"
+
+typedef struct
+{
+  fit *ft;
+  double *starts;
+  double *p;
+  double *cost;
+  double *cov;
+  int *iter;
+  int *status;
+  long *nfev;
+} fit_job;
+
+static int fit_chol ( int n, double a[] );
+static void fit_cholsolve ( int n, double l[], double b[] );
+static int fit_lm ( fit *ft, double p[], double *cost, double cov[],
+  int *iter, long *nfev );
+static double fit_residual ( fit *ft, double p[], double r[], double jac[],
+  long *nfev );
+static void fit_task ( int i, int thread, void *arg );
+
+/******************************************************************************/
+
+static int fit_chol ( int n, double a[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FIT_CHOL computes the Cholesky factor of a symmetric matrix.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int N, the order of the matrix.
+
+    Input/output, double A[N*N], the matrix, by rows; on output its lower
+    triangle holds L, with A = L L'.
+
+    Output, int FIT_CHOL, is 0, or 1 if A is not positive definite.
+*/
+{
+  int i;
+  int j;
+  int k;
+  double s;
+
+  for ( j = 0; j < n; j++ )
+  {
+    s = a[j*n+j];
+    for ( k = 0; k < j; k++ )
+    {
+      s = s - a[j*n+k] * a[j*n+k];
+    }
+    if ( !( 0.0 < s ) )
+    {
+      return 1;
+    }
+    a[j*n+j] = sqrt ( s );
+    for ( i = j + 1; i < n; i++ )
+    {
+      s = a[i*n+j];
+      for ( k = 0; k < j; k++ )
+      {
+        s = s - a[i*n+k] * a[j*n+k];
+      }
+      a[i*n+j] = s / a[j*n+j];
+    }
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+static void fit_cholsolve ( int n, double l[], double b[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FIT_CHOLSOLVE solves L L' X = B with the factor from FIT_CHOL.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int N, the order of the matrix.
+
+    Input, double L[N*N], the factor, in the lower triangle.
+
+    Input/output, double B[N], the right hand side, replaced by X.
+*/
+{
+  int i;
+  int k;
+
+  for ( i = 0; i < n; i++ )
+  {
+    for ( k = 0; k < i; k++ )
+    {
+      b[i] = b[i] - l[i*n+k] * b[k];
+    }
+    b[i] = b[i] / l[i*n+i];
+  }
+  for ( i = n - 1; 0 <= i; i-- )
+  {
+    for ( k = i + 1; k < n; k++ )
+    {
+      b[i] = b[i] - l[k*n+i] * b[k];
+    }
+    b[i] = b[i] / l[i*n+i];
+  }
+
+  return;
+}
+/******************************************************************************/
+
+fit *fit_create ( ode_rhs *f, sens_jvp *jvp, int n, double t0, double x0[],
+  int np, double p[], int nfit, int which[], int m, double tobs[],
+  double yobs[], int comp )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FIT_CREATE sets up a parameter estimation problem.
+
+  Discussion:
+
+    X0, P and WHICH are copied; TOBS and YOBS are not, and must stay
+    valid.  The defaults are HMAX = 0.05, MAXITER = 100 and TOL = 1.0E-10.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, sens_jvp *JVP, its Jacobian vector products.
+
+    Input, int N, the number of components.
+
+    Input, double T0, X0[N], the starting point.
+
+    Input, int NP, double P[NP], the parameter vector.
+
+    Input, int NFIT, int WHICH[NFIT], the entries of P to fit.
+
+    Input, int M, double TOBS[M], YOBS[M], the observations, with
+    T0 <= TOBS[0] <= TOBS[1] <= ...
+
+    Input, int COMP, the component observed.
+
+    Output, fit *FIT_CREATE, the estimation problem.
+*/
+{
+  fit *ft;
+  int i;
+
+  ft = ( fit * ) malloc ( sizeof ( fit ) );
+  ft->f = f;
+  ft->jvp = jvp;
+  ft->n = n;
+  ft->t0 = t0;
+  ft->x0 = ( double * ) malloc ( ( n + np + nfit * nfit ) * sizeof ( double ) );
+  ft->p = ft->x0 + n;
+  ft->cov = ft->p + np;
+  ft->np = np;
+  ft->nfit = nfit;
+  ft->which = ( int * ) malloc ( nfit * sizeof ( int ) );
+  ft->m = m;
+  ft->tobs = tobs;
+  ft->yobs = yobs;
+  ft->comp = comp;
+  ft->hmax = 0.05;
+  ft->maxiter = 100;
+  ft->tol = 1.0E-10;
+  ft->cost = 0.0;
+  ft->iter = 0;
+  ft->best = -1;
+  ft->nfev = 0;
+
+  for ( i = 0; i < n; i++ )
+  {
+    ft->x0[i] = x0[i];
+  }
+  for ( i = 0; i < np; i++ )
+  {
+    ft->p[i] = p[i];
+  }
+  for ( i = 0; i < nfit; i++ )
+  {
+    ft->which[i] = which[i];
+  }
+
+  return ft;
+}
+/******************************************************************************/
+
+void fit_free ( fit *ft )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FIT_FREE frees a parameter estimation problem.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, fit *FT, the estimation problem.
+*/
+{
+  free ( ft->x0 );
+  free ( ft->which );
+  free ( ft );
+
+  return;
+}
+/******************************************************************************/
+
+static int fit_lm ( fit *ft, double p[], double *cost, double cov[],
+  int *iter, long *nfev )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FIT_LM runs Levenberg-Marquardt from one starting point.
+
+  Discussion:
+
+    It only reads FT, so several can run at once.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, fit *FT, the estimation problem.
+
+    Input/output, double P[NP], the starting parameters, replaced by the
+    estimate.
+
+    Output, double *COST, half the sum of squares of the residuals.
+
+    Output, double COV[NFIT*NFIT], the covariance estimate, or zeros if
+    J'J is singular.
+
+    Output, int *ITER, the number of steps taken.
+
+    Output, long *NFEV, the number of right hand side evaluations.
+
+    Output, int FIT_LM, is 0 if the iteration converged, or 1 if not.
+*/
+{
+  double *a;
+  double *b;
+  double c;
+  double *dp;
+  double *g;
+  int i;
+  double *jac;
+  double *jt;
+  int j;
+  int k;
+  double lambda;
+  int m = ft->m;
+  int nfit = ft->nfit;
+  int np = ft->np;
+  double *pt;
+  double *r;
+  double *rt;
+  double s2;
+  int status;
+  double *w;
+
+  r = ( double * ) malloc ( ( 2 * m * ( nfit + 1 ) + 3 * nfit * nfit
+    + 3 * nfit + np ) * sizeof ( double ) );
+  jac = r + m;
+  rt = jac + m * nfit;
+  jt = rt + m;
+  a = jt + m * nfit;
+  b = a + nfit * nfit;
+  g = b + nfit * nfit;
+  dp = g + nfit;
+  w = dp + nfit;
+  pt = w + nfit + nfit * nfit;
+
+  *nfev = 0;
+  *cost = fit_residual ( ft, p, r, jac, nfev );
+  lambda = 1.0E-03;
+  status = 1;
+
+  for ( *iter = 0; *iter < ft->maxiter && status != 0; *iter = *iter + 1 )
+  {
+/*
+  The normal equations.
+*/
+    for ( j = 0; j < nfit; j++ )
+    {
+      g[j] = 0.0;
+      for ( i = 0; i < m; i++ )
+      {
+        g[j] = g[j] + jac[i*nfit+j] * r[i];
+      }
+      for ( k = 0; k <= j; k++ )
+      {
+        a[j*nfit+k] = 0.0;
+        for ( i = 0; i < m; i++ )
+        {
+          a[j*nfit+k] = a[j*nfit+k] + jac[i*nfit+j] * jac[i*nfit+k];
+        }
+        a[k*nfit+j] = a[j*nfit+k];
+      }
+    }
+/*
+  Raise LAMBDA until a step lowers the cost.
+*/
+    for ( ; ; )
+    {
+      for ( j = 0; j < nfit * nfit; j++ )
+      {
+        b[j] = a[j];
+      }
+      for ( j = 0; j < nfit; j++ )
+      {
+        b[j*nfit+j] = a[j*nfit+j] * ( 1.0 + lambda );
+        dp[j] = -g[j];
+      }
+      if ( fit_chol ( nfit, b ) == 0 )
+      {
+        fit_cholsolve ( nfit, b, dp );
+        for ( j = 0; j < np; j++ )
+        {
+          pt[j] = p[j];
+        }
+        for ( j = 0; j < nfit; j++ )
+        {
+          pt[ft->which[j]] = p[ft->which[j]] + dp[j];
+        }
+        c = fit_residual ( ft, pt, rt, jt, nfev );
+        if ( c < *cost )
+        {
+          break;
+        }
+      }
+      lambda = 10.0 * lambda;
+      if ( 1.0E+16 < lambda )
+      {
+        break;
+      }
+    }
+    if ( 1.0E+16 < lambda )
+    {
+      break;
+    }
+
+    status = 0;
+    for ( j = 0; j < nfit; j++ )
+    {
+      if ( ft->tol * ( fabs ( p[ft->which[j]] ) + ft->tol ) < fabs ( dp[j] ) )
+      {
+        status = 1;
+      }
+    }
+    for ( j = 0; j < np; j++ )
+    {
+      p[j] = pt[j];
+    }
+    for ( i = 0; i < m; i++ )
+    {
+      r[i] = rt[i];
+    }
+    for ( i = 0; i < m * nfit; i++ )
+    {
+      jac[i] = jt[i];
+    }
+    *cost = c;
+    lambda = fmax ( lambda / 10.0, 1.0E-12 );
+  }
+/*
+  No step lowers the cost any more: the minimum is as good as the
+  rounding allows.
+*/
+  if ( 1.0E+16 < lambda )
+  {
+    status = 0;
+  }
+/*
+  The covariance, S^2 ( J'J )^-1, at the solution.
+*/
+  for ( j = 0; j < nfit; j++ )
+  {
+    for ( k = 0; k < nfit; k++ )
+    {
+      a[j*nfit+k] = 0.0;
+      for ( i = 0; i < m; i++ )
+      {
+        a[j*nfit+k] = a[j*nfit+k] + jac[i*nfit+j] * jac[i*nfit+k];
+      }
+    }
+  }
+  s2 = ( nfit < m ) ? 2.0 * *cost / ( m - nfit ) : 0.0;
+  if ( fit_chol ( nfit, a ) == 0 )
+  {
+    for ( k = 0; k < nfit; k++ )
+    {
+      for ( j = 0; j < nfit; j++ )
+      {
+        w[j] = ( j == k ) ? 1.0 : 0.0;
+      }
+      fit_cholsolve ( nfit, a, w );
+      for ( j = 0; j < nfit; j++ )
+      {
+        cov[j*nfit+k] = s2 * w[j];
+      }
+    }
+  }
+  else
+  {
+    for ( j = 0; j < nfit * nfit; j++ )
+    {
+      cov[j] = 0.0;
+    }
+  }
+
+  free ( r );
+
+  return status;
+}
+/******************************************************************************/
+
+int fit_multistart ( fit *ft, int nstart, double starts[], int nthread )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FIT_MULTISTART runs fits from several starting points in parallel.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, fit *FT, the estimation problem.  On output FT->P,
+    FT->COST, FT->COV and FT->ITER are those of the best fit, FT->BEST
+    its starting point and FT->NFEV the evaluations of all of them.
+
+    Input, int NSTART, the number of starting points.
+
+    Input, double STARTS[NSTART*NFIT], the starting values of the fitted
+    parameters, one point after another.
+
+    Input, int NTHREAD, the number of threads.
+
+    Output, int FIT_MULTISTART, is 0 if the best fit converged, or 1 if
+    not.
+*/
+{
+  int i;
+  fit_job job;
+  int j;
+  int nfit = ft->nfit;
+  int np = ft->np;
+
+  job.ft = ft;
+  job.starts = starts;
+  job.p = ( double * ) malloc ( nstart * ( np + 1 + nfit * nfit )
+    * sizeof ( double ) );
+  job.cost = job.p + nstart * np;
+  job.cov = job.cost + nstart;
+  job.iter = ( int * ) malloc ( 2 * nstart * sizeof ( int ) );
+  job.status = job.iter + nstart;
+  job.nfev = ( long * ) malloc ( nstart * sizeof ( long ) );
+
+  if ( pool_run ( nthread, nstart, fit_task, &job ) != 0 )
+  {
+    fprintf ( stderr, "FIT_MULTISTART: some threads could not be started.\n" );
+  }
+
+  ft->best = 0;
+  ft->nfev = 0;
+  for ( i = 0; i < nstart; i++ )
+  {
+    if ( job.cost[i] < job.cost[ft->best] )
+    {
+      ft->best = i;
+    }
+    ft->nfev = ft->nfev + job.nfev[i];
+  }
+  i = ft->best;
+  for ( j = 0; j < np; j++ )
+  {
+    ft->p[j] = job.p[i*np+j];
+  }
+  for ( j = 0; j < nfit * nfit; j++ )
+  {
+    ft->cov[j] = job.cov[i*nfit*nfit+j];
+  }
+  ft->cost = job.cost[i];
+  ft->iter = job.iter[i];
+  j = job.status[i];
+
+  free ( job.p );
+  free ( job.iter );
+  free ( job.nfev );
+
+  return j;
+}
+/******************************************************************************/
+
+int fit_read ( char *filename, int *m, double **t, double **y )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FIT_READ reads observations from a text file.
+
+  Discussion:
+
+    Each line that starts with two numbers, such as the lines of osc.dat,
+    gives a time and a value; other lines and further columns are
+    ignored.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, char *FILENAME, the file.
+
+    Output, int *M, the number of observations.
+
+    Output, double **T, **Y, the times and values, to be freed by the
+    caller.
+
+    Output, int FIT_READ, is 0, or 1 if the file could not be read or
+    holds no observations.
+*/
+{
+  FILE *fp;
+  char line[1024];
+  int size;
+  double tv;
+  double yv;
+
+  fp = fopen ( filename, "r" );
+  if ( fp == NULL )
+  {
+    return 1;
+  }
+
+  *m = 0;
+  size = 1024;
+  *t = ( double * ) malloc ( size * sizeof ( double ) );
+  *y = ( double * ) malloc ( size * sizeof ( double ) );
+  while ( fgets ( line, sizeof ( line ), fp ) != NULL )
+  {
+    if ( sscanf ( line, "%lf %lf", &tv, &yv ) != 2 )
+    {
+      continue;
+    }
+    if ( *m == size )
+    {
+      size = 2 * size;
+      *t = ( double * ) realloc ( *t, size * sizeof ( double ) );
+      *y = ( double * ) realloc ( *y, size * sizeof ( double ) );
+    }
+    ( *t )[*m] = tv;
+    ( *y )[*m] = yv;
+    *m = *m + 1;
+  }
+  fclose ( fp );
+
+  if ( *m == 0 )
+  {
+    free ( *t );
+    free ( *y );
+    return 1;
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+static double fit_residual ( fit *ft, double p[], double r[], double jac[],
+  long *nfev )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FIT_RESIDUAL integrates the model and forms the residuals and their
+    Jacobian.
+
+  Discussion:
+
+    Each gap between observations is covered by equal RK4 steps of at
+    most FT->HMAX, so every observation time is met exactly.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, fit *FT, the estimation problem.
+
+    Input, double P[NP], the parameters.
+
+    Output, double R[M], the model minus the observations.
+
+    Output, double JAC[M*NFIT], dR(I)/dP(WHICH(J)) in JAC[I*NFIT+J].
+
+    Input/output, long *NFEV, the count of right hand side evaluations.
+
+    Output, double FIT_RESIDUAL, half the sum of the squares of R, or
+    HUGE_VAL if the model could not be integrated.
+*/
+{
+  double cost;
+  double dt;
+  double h;
+  int i;
+  int j;
+  int k;
+  int n = ft->n;
+  int nsub;
+  sens *s;
+
+  s = sens_create ( ft->f, ft->jvp, n, ft->nfit, ft->which, ft->t0, ft->x0,
+    p );
+  cost = 0.0;
+  for ( i = 0; i < ft->m; i++ )
+  {
+    dt = ft->tobs[i] - s->t;
+    if ( 0.0 < dt )
+    {
+      nsub = ( int ) ceil ( dt / ft->hmax - 1.0E-09 );
+      h = dt / nsub;
+      for ( k = 0; k < nsub; k++ )
+      {
+        sens_step ( s, h );
+      }
+      s->t = ft->tobs[i];
+    }
+    r[i] = s->y[ft->comp] - ft->yobs[i];
+    for ( j = 0; j < ft->nfit; j++ )
+    {
+      jac[i*ft->nfit+j] = s->y[(j+1)*n+ft->comp];
+    }
+    cost = cost + 0.5 * r[i] * r[i];
+  }
+  *nfev = *nfev + s->nfev;
+  sens_free ( s );
+
+  if ( !( cost < HUGE_VAL ) )
+  {
+    return HUGE_VAL;
+  }
+  return cost;
+}
+/******************************************************************************/
+
+int fit_run ( fit *ft, double start[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FIT_RUN fits from one starting point.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, fit *FT, the estimation problem, with the results as
+    for FIT_MULTISTART.
+
+    Input, double START[NFIT], the starting values of the fitted
+    parameters.
+
+    Output, int FIT_RUN, is 0 if the fit converged, or 1 if not.
+*/
+{
+  return fit_multistart ( ft, 1, start, 1 );
+}
+/******************************************************************************/
+
+static void fit_task ( int i, int thread, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    FIT_TASK runs the fit from starting point I, as a pool task.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int I, the starting point.
+
+    Input, int THREAD, the calling thread, not used.
+
+    Input, void *ARG, the fit_job.
+*/
+{
+  fit_job *job = ( fit_job * ) arg;
+  fit *ft = job->ft;
+  int j;
+  int nfit = ft->nfit;
+  int np = ft->np;
+  double *p = job->p + i * np;
+
+  for ( j = 0; j < np; j++ )
+  {
+    p[j] = ft->p[j];
+  }
+  for ( j = 0; j < nfit; j++ )
+  {
+    p[ft->which[j]] = job->starts[i*nfit+j];
+  }
+  job->status[i] = fit_lm ( ft, p, job->cost + i, job->cov + i * nfit * nfit,
+    job->iter + i, job->nfev + i );
+
+  return;
+}
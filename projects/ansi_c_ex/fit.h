@@ -0,0 +1,69 @@
+/*
+  FIT estimates parameters of an ODE model X' = F(T,X,P) from measured
+  values of one component, Y(I) ~ X(COMP) at times TOBS(I), by
+  Levenberg-Marquardt least squares:
+
+    fit_read ( "osc.dat", &m, &tobs, &yobs );
+    ft = fit_create ( f, jvp, n, t0, x0, np, p, nfit, which, m, tobs,
+      yobs, comp );
+    fit_multistart ( ft, nstart, starts, nthread );
+    ... ft->p, ft->cost, ft->cov ...
+    fit_free ( ft );
+
+  P[0:NP-1] is the parameter vector F and JVP receive as their DATA, and
+  P[WHICH[0:NFIT-1]] are the entries fitted; the others stay fixed.
+
+  Each residual evaluation is one integration by RK4 steps of at most
+  FT->HMAX, landing exactly on every observation time, carrying the
+  sensitivities dX/dP(WHICH[J]) through SENS, so the Jacobian of the
+  residuals costs NFIT products per stage and no extra integrations.
+
+  The steps solve ( J'J + LAMBDA diag ( J'J ) ) DP = -J'R, LAMBDA going
+  down by 10 after a step that lowers the cost and up by 10 after one
+  that does not.  The iteration stops when the relative change of every
+  parameter is below FT->TOL, or after FT->MAXITER steps.
+
+  FIT_MULTISTART runs independent fits from NSTART starting points on
+  the threads of POOL_RUN and keeps the best.  With S^2 = 2 COST / ( M -
+  NFIT ), the covariance of the fitted parameters is estimated as
+  S^2 ( J'J )^-1 at the solution.
+*/
+# ifndef FIT_H
+# define FIT_H
+
+# include "sens.h"
+
+typedef struct
+{
+  ode_rhs *f;
+  sens_jvp *jvp;
+  int n;
+  double t0;
+  double *x0;
+  int np;
+  double *p;
+  int nfit;
+  int *which;
+  int m;
+  double *tobs;
+  double *yobs;
+  int comp;
+  double hmax;
+  int maxiter;
+  double tol;
+  double cost;
+  double *cov;
+  int iter;
+  int best;
+  long nfev;
+} fit;
+
+fit *fit_create ( ode_rhs *f, sens_jvp *jvp, int n, double t0, double x0[],
+  int np, double p[], int nfit, int which[], int m, double tobs[],
+  double yobs[], int comp );
+void fit_free ( fit *ft );
+int fit_multistart ( fit *ft, int nstart, double starts[], int nthread );
+int fit_read ( char *filename, int *m, double **t, double **y );
+int fit_run ( fit *ft, double start[] );
+
+# endif
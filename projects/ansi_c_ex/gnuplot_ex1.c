@@ -1,19 +1,20 @@
 #include <stdio.h>
+#include "plot.h"
 
-main(){
+// build: gcc -o gnuplot_ex1 gnuplot_ex1.c plot.c
+int main(void){
     
   // 利用 pipe 呼叫 gnuplot 繪圖
-  FILE *pipe;
-  pipe = popen("gnuplot -persist","w");
-  //fprintf(pipe,"set term png enhanced font \"v:/fireflysung.ttf\" 18 \n");
-  fprintf(pipe,"set term png enhanced font \"y:/wqy-microhei.ttc\" 12 \n");
-  //fprintf(pipe,"set yrange [68:70]\n");
-  fprintf(pipe,"set output \"ex1_3d.png\"\n");
-  //fprintf(pipe, "plot \"osc.dat\" title \"Runge-Kutta 解微分方程式\" with lines\n");
-  //fprintf(pipe, "plot [0:3.14159*2] sin(x) with linespoints\n");
-  fprintf(pipe,"set hidden3d\n");
-  fprintf(pipe,"set isosamples 30\n");
-  fprintf(pipe, "splot [-2:2][-2:2] exp(-(x**2 + y**2))*cos(x/4)\n");
-  fprintf(pipe,"quit\n");
-  pclose(pipe);
-}
\ No newline at end of file
+  plot *gp;
+  gp = plot_open(NULL, "gnuplot_ex1.plotcache");
+  if(gp == NULL) return 1;
+  //plot_cmd(gp, "set term png enhanced font \"v:/fireflysung.ttf\" 18");
+  plot_cmd(gp, "set term png enhanced font \"y:/wqy-microhei.ttc\" 12");
+  //plot_cmd(gp, "set yrange [68:70]");
+  //plot_draw(gp, "ex1_3d.png", "plot '-' title \"Runge-Kutta 解微分方程式\" with lines", n, 2, xy);
+  //plot_draw(gp, "ex1_3d.png", "plot [0:3.14159*2] sin(x) with linespoints", 0, 0, NULL);
+  plot_cmd(gp, "set hidden3d");
+  plot_cmd(gp, "set isosamples 30");
+  plot_draw(gp, "ex1_3d.png", "splot [-2:2][-2:2] exp(-(x**2 + y**2))*cos(x/4)", 0, 0, NULL);
+  return plot_close(gp);
+}
@@ -0,0 +1,786 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <math.h>
+# include <float.h>
+
+# include "lti.h"
+
+# define LTI_PADE 6
+# define LTI_MAXREJECT 20
+
+static void lti_mm ( int n, double a[], double b[], double c[] );
+static int lti_solve ( int n, double a[], double b[], int nrhs );
+
+/******************************************************************************/
+
+lti *lti_create ( int n, double a[], double g[], double h, double t,
+  double x[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    LTI_CREATE sets up the exact stepper for X' = A X + G.
+
+  Discussion:
+
+    exp ( M ) for the N+1 by N+1 matrix M = [ A G ; 0 0 ] H is
+    [ E D ; 0 1 ], with E = exp ( A H ) and D the exact change of X over
+    one step due to G, H * phi1 ( A H ) G.  This also holds for singular
+    A, where phi1 ( A H ) = ( E - I ) / ( A H ) cannot be formed.
+
+    The cost is O(N^3), once.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Cleve Moler, Charles Van Loan,
+    Nineteen dubious ways to compute the exponential of a matrix,
+    twenty-five years later,
+    SIAM Review,
+    Volume 45, Number 1, 2003, pages 3-49.
+
+  Parameters:
+
+    Input, int N, the number of components.
+
+    Input, double A[N*N], the system matrix.
+
+    Input, double G[N], the forcing, or NULL for none.
+
+    Input, double H, the step size.
+
+    Input, double T, X[N], the initial time and state.
+
+    Output, lti *LTI_CREATE, the stepper, or NULL if memory ran out.
+*/
+{
+  int i;
+  int j;
+  lti *l;
+  double *m;
+  double *em;
+  int n1 = n + 1;
+
+  l = ( lti * ) malloc ( sizeof ( lti ) );
+  if ( l == NULL )
+  {
+    return NULL;
+  }
+  l->e = ( double * ) malloc ( ( n * n + 3 * n ) * sizeof ( double ) );
+  m = ( double * ) malloc ( 2 * n1 * n1 * sizeof ( double ) );
+  if ( l->e == NULL || m == NULL )
+  {
+    free ( l->e );
+    free ( m );
+    free ( l );
+    return NULL;
+  }
+  l->d = l->e + n * n;
+  l->x = l->d + n;
+  l->y = l->x + n;
+  em = m + n1 * n1;
+
+  for ( j = 0; j < n1; j++ )
+  {
+    for ( i = 0; i < n1; i++ )
+    {
+      if ( i < n && j < n )
+      {
+        m[i+j*n1] = a[i+j*n] * h;
+      }
+      else if ( i < n && g != NULL )
+      {
+        m[i+j*n1] = g[i] * h;
+      }
+      else
+      {
+        m[i+j*n1] = 0.0;
+      }
+    }
+  }
+
+  if ( lti_expm ( n1, m, em ) != 0 )
+  {
+    free ( m );
+    lti_free ( l );
+    return NULL;
+  }
+
+  for ( j = 0; j < n; j++ )
+  {
+    for ( i = 0; i < n; i++ )
+    {
+      l->e[i+j*n] = em[i+j*n1];
+    }
+  }
+  for ( i = 0; i < n; i++ )
+  {
+    l->d[i] = em[i+n*n1];
+    l->x[i] = x[i];
+  }
+  free ( m );
+
+  l->n = n;
+  l->h = h;
+  l->t = t;
+  l->nstep = 0;
+
+  return l;
+}
+/******************************************************************************/
+
+int lti_expm ( int n, double a[], double e[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    LTI_EXPM computes the exponential of a dense matrix.
+
+  Discussion:
+
+    A is scaled by 2^(-S) so that its infinity norm is at most 1/2, the
+    (6,6) diagonal Pade approximant R = D^(-1) N of the scaled matrix is
+    formed, and R is squared S times.  For norms up to 1/2 the Pade
+    error is below the unit roundoff, as in EXPOKIT's PADM.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Roger Sidje,
+    EXPOKIT: Software package for computing matrix exponentials,
+    ACM Transactions on Mathematical Software,
+    Volume 24, Number 1, 1998, pages 130-156.
+
+  Parameters:
+
+    Input, int N, the order of the matrix.
+
+    Input, double A[N*N], the matrix.
+
+    Output, double E[N*N], exp ( A ).
+
+    Output, int LTI_EXPM, is 0 on success, or 1 if memory ran out or
+    the Pade denominator was singular.
+*/
+{
+  double c;
+  double *den;
+  int i;
+  int k;
+  double norm;
+  double *num;
+  double *p;
+  double *q;
+  double row;
+  int s;
+  double scale;
+  double *w;
+  double *x;
+
+  w = ( double * ) malloc ( 5 * n * n * sizeof ( double ) );
+  if ( w == NULL )
+  {
+    return 1;
+  }
+  x = w;
+  p = x + n * n;
+  q = p + n * n;
+  num = q + n * n;
+  den = num + n * n;
+
+  norm = 0.0;
+  for ( i = 0; i < n; i++ )
+  {
+    row = 0.0;
+    for ( k = 0; k < n; k++ )
+    {
+      row = row + fabs ( a[i+k*n] );
+    }
+    norm = fmax ( norm, row );
+  }
+  s = 0;
+  if ( 0.5 < norm )
+  {
+    s = ( int ) ceil ( log2 ( norm / 0.5 ) );
+  }
+  scale = ldexp ( 1.0, -s );
+
+  for ( i = 0; i < n * n; i++ )
+  {
+    x[i] = a[i] * scale;
+    p[i] = 0.0;
+    num[i] = 0.0;
+    den[i] = 0.0;
+  }
+  for ( i = 0; i < n; i++ )
+  {
+    p[i+i*n] = 1.0;
+    num[i+i*n] = 1.0;
+    den[i+i*n] = 1.0;
+  }
+/*
+  N = sum C(K) X^K, D = sum (-1)^K C(K) X^K.
+*/
+  c = 1.0;
+  for ( k = 1; k <= LTI_PADE; k++ )
+  {
+    c = c * ( double ) ( LTI_PADE - k + 1 )
+      / ( double ) ( k * ( 2 * LTI_PADE - k + 1 ) );
+    lti_mm ( n, p, x, q );
+    for ( i = 0; i < n * n; i++ )
+    {
+      p[i] = q[i];
+      num[i] = num[i] + c * p[i];
+      den[i] = den[i] + ( ( k % 2 ) ? - c : c ) * p[i];
+    }
+  }
+
+  if ( lti_solve ( n, den, num, n ) != 0 )
+  {
+    free ( w );
+    return 1;
+  }
+
+  for ( k = 0; k < s; k++ )
+  {
+    lti_mm ( n, num, num, q );
+    for ( i = 0; i < n * n; i++ )
+    {
+      num[i] = q[i];
+    }
+  }
+  for ( i = 0; i < n * n; i++ )
+  {
+    e[i] = num[i];
+  }
+
+  free ( w );
+
+  return 0;
+}
+/******************************************************************************/
+
+int lti_expv ( ode_rhs *f, int n, double t, double v[], double w[], int m,
+  double tol, long *nmv, void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    LTI_EXPV computes exp ( A T ) V for a matrix given by products.
+
+  Discussion:
+
+    This follows Sidje's EXPV.  From the current vector W, M steps of
+    Arnoldi give an orthonormal basis V(1:M+1) and the Hessenberg matrix
+    H with A V(1:M) = V(1:M+1) H.  Then exp ( A TAU ) W is approximated by
+    |W| times V(1:M+1) times the first column of the exponential of the
+    small augmented matrix TAU * [ H 0 ; e_M' h(M+1,M) 0 ; 0 1 0 ], whose
+    last two entries also give the error estimate.  TAU is cut until the
+    estimated error is at most TOL * |W| * TAU / T, and the steps repeat
+    from the new W until T is covered.  If the Arnoldi process breaks
+    down, the subspace is invariant and the rest of the interval is
+    done in one step.  Breakdown is declared when the new basis vector
+    is below 1.0E-12 times the largest |A V(J)| so far, an estimate of
+    |A|.  A test relative to |A V(J)| alone, or to the step, would take
+    a slowly changing W for an invariant one.
+
+    Each step costs M+1 products with A and O(N M^2) other work, and
+    only W and the basis, N*(M+1) numbers, are stored.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Roger Sidje,
+    EXPOKIT: Software package for computing matrix exponentials,
+    ACM Transactions on Mathematical Software,
+    Volume 24, Number 1, 1998, pages 130-156.
+
+  Parameters:
+
+    Input, ode_rhs *F, computes A X as F ( 0, X, AX, DATA ).
+
+    Input, int N, the number of components.
+
+    Input, double T, the time, positive.
+
+    Input, double V[N], the vector.
+
+    Output, double W[N], exp ( A T ) V.  W may be V.
+
+    Input, int M, the dimension of the Krylov subspaces, 30 is typical.
+
+    Input, double TOL, the relative accuracy wanted.
+
+    Input/output, long *NMV, incremented by the number of products.
+
+    Input, void *DATA, passed to F.
+
+    Output, int LTI_EXPV, is 0 on success, or 1 if memory ran out or
+    the steps became too small.
+*/
+{
+  double anorm;
+  double avnorm;
+  double beta;
+  double *ex;
+  double err;
+  double *hm;
+  double *hs;
+  int happy;
+  int i;
+  int j;
+  int k;
+  int mb;
+  int mh = m + 2;
+  int mx;
+  double p1;
+  double p2;
+  double *p;
+  int reject;
+  double s;
+  double tau;
+  double tk;
+  double *vv;
+
+  vv = ( double * ) malloc ( ( n * ( m + 2 ) + 3 * mh * mh )
+    * sizeof ( double ) );
+  if ( vv == NULL )
+  {
+    return 1;
+  }
+  p = vv + n * ( m + 1 );
+  hm = p + n;
+  hs = hm + mh * mh;
+  ex = hs + mh * mh;
+
+  for ( i = 0; i < n; i++ )
+  {
+    w[i] = v[i];
+  }
+
+  tk = 0.0;
+  tau = t;
+
+  while ( tk < t )
+  {
+    beta = 0.0;
+    for ( i = 0; i < n; i++ )
+    {
+      beta = beta + w[i] * w[i];
+    }
+    beta = sqrt ( beta );
+    if ( beta == 0.0 )
+    {
+      break;
+    }
+    for ( i = 0; i < n; i++ )
+    {
+      vv[i] = w[i] / beta;
+    }
+    for ( i = 0; i < mh * mh; i++ )
+    {
+      hm[i] = 0.0;
+    }
+/*
+  Arnoldi, by modified Gram-Schmidt.
+*/
+    happy = 0;
+    mb = m;
+    anorm = 0.0;
+    avnorm = 0.0;
+    for ( j = 0; j < m; j++ )
+    {
+      f ( 0.0, vv + j * n, p, data );
+      *nmv = *nmv + 1;
+      s = 0.0;
+      for ( i = 0; i < n; i++ )
+      {
+        s = s + p[i] * p[i];
+      }
+      anorm = fmax ( anorm, sqrt ( s ) );
+      for ( k = 0; k <= j; k++ )
+      {
+        s = 0.0;
+        for ( i = 0; i < n; i++ )
+        {
+          s = s + vv[i+k*n] * p[i];
+        }
+        hm[k+j*mh] = s;
+        for ( i = 0; i < n; i++ )
+        {
+          p[i] = p[i] - s * vv[i+k*n];
+        }
+      }
+      s = 0.0;
+      for ( i = 0; i < n; i++ )
+      {
+        s = s + p[i] * p[i];
+      }
+      s = sqrt ( s );
+      if ( s <= 1.0E-12 * anorm )
+      {
+        happy = 1;
+        mb = j + 1;
+        tau = t - tk;
+        break;
+      }
+      hm[j+1+j*mh] = s;
+      for ( i = 0; i < n; i++ )
+      {
+        vv[i+(j+1)*n] = p[i] / s;
+      }
+    }
+    if ( !happy )
+    {
+      f ( 0.0, vv + m * n, p, data );
+      *nmv = *nmv + 1;
+      for ( i = 0; i < n; i++ )
+      {
+        avnorm = avnorm + p[i] * p[i];
+      }
+      avnorm = sqrt ( avnorm );
+      hm[m+1+m*mh] = 1.0;
+    }
+/*
+  Exponentiate TAU times the small matrix, cutting TAU until the
+  estimated error is small enough.
+*/
+    mx = happy ? mb : m + 2;
+    for ( reject = 0; ; reject++ )
+    {
+      for ( j = 0; j < mx; j++ )
+      {
+        for ( i = 0; i < mx; i++ )
+        {
+          hs[i+j*mx] = tau * hm[i+j*mh];
+        }
+      }
+      if ( lti_expm ( mx, hs, ex ) != 0 )
+      {
+        free ( vv );
+        return 1;
+      }
+      if ( happy )
+      {
+        err = 0.0;
+        break;
+      }
+      p1 = fabs ( ex[m] ) * beta;
+      p2 = fabs ( ex[m+1] ) * beta * avnorm;
+      if ( 10.0 * p2 < p1 )
+      {
+        err = p2;
+      }
+      else if ( p2 < p1 )
+      {
+        err = p1 * p2 / ( p1 - p2 );
+      }
+      else
+      {
+        err = p1;
+      }
+      if ( err <= tol * beta * tau / t )
+      {
+        break;
+      }
+      if ( LTI_MAXREJECT <= reject || tau <= DBL_EPSILON * t )
+      {
+        free ( vv );
+        return 1;
+      }
+      tau = tau * fmax ( 0.2, 0.9 * pow ( tol * beta * tau / ( t * err ),
+        1.0 / m ) );
+    }
+/*
+  W = BETA * V(1:M+1) * EX(1:M+1,1), the last term being the correction
+  along V(M+1).
+*/
+    mx = happy ? mb : m + 1;
+    for ( i = 0; i < n; i++ )
+    {
+      w[i] = 0.0;
+    }
+    for ( j = 0; j < mx; j++ )
+    {
+      s = beta * ex[j];
+      for ( i = 0; i < n; i++ )
+      {
+        w[i] = w[i] + s * vv[i+j*n];
+      }
+    }
+
+    tk = tk + tau;
+    if ( 0.0 < err )
+    {
+      tau = tau * fmin ( 5.0, 0.9 * pow ( tol * beta * tau / ( t * err ),
+        1.0 / m ) );
+    }
+    else
+    {
+      tau = 5.0 * tau;
+    }
+    tau = fmin ( tau, t - tk );
+  }
+
+  free ( vv );
+
+  return 0;
+}
+/******************************************************************************/
+
+void lti_free ( lti *l )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    LTI_FREE frees an LTI stepper.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, lti *L, the stepper.
+*/
+{
+  free ( l->e );
+  free ( l );
+
+  return;
+}
+/******************************************************************************/
+
+static void lti_mm ( int n, double a[], double b[], double c[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    LTI_MM multiplies two square matrices, C = A * B.
+
+  Discussion:
+
+    The inner loop runs down a column of A, so it has unit stride.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int N, the order of the matrices.
+
+    Input, double A[N*N], B[N*N], the factors.
+
+    Output, double C[N*N], the product.  C must not be A or B.
+*/
+{
+  int i;
+  int j;
+  int k;
+  double bkj;
+
+  for ( j = 0; j < n; j++ )
+  {
+    for ( i = 0; i < n; i++ )
+    {
+      c[i+j*n] = 0.0;
+    }
+    for ( k = 0; k < n; k++ )
+    {
+      bkj = b[k+j*n];
+      for ( i = 0; i < n; i++ )
+      {
+        c[i+j*n] = c[i+j*n] + a[i+k*n] * bkj;
+      }
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static int lti_solve ( int n, double a[], double b[], int nrhs )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    LTI_SOLVE solves A X = B by Gauss elimination with partial pivoting.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int N, the order of A.
+
+    Input/output, double A[N*N], the matrix, destroyed.
+
+    Input/output, double B[N*NRHS], the right hand sides, replaced by
+    the solutions.
+
+    Input, int NRHS, the number of right hand sides.
+
+    Output, int LTI_SOLVE, is 0 on success, or 1 if A is singular.
+*/
+{
+  int i;
+  int j;
+  int k;
+  int piv;
+  double r;
+  double temp;
+
+  for ( k = 0; k < n; k++ )
+  {
+    piv = k;
+    for ( i = k + 1; i < n; i++ )
+    {
+      if ( fabs ( a[piv+k*n] ) < fabs ( a[i+k*n] ) )
+      {
+        piv = i;
+      }
+    }
+    if ( a[piv+k*n] == 0.0 )
+    {
+      return 1;
+    }
+    if ( piv != k )
+    {
+      for ( j = k; j < n; j++ )
+      {
+        temp = a[k+j*n];
+        a[k+j*n] = a[piv+j*n];
+        a[piv+j*n] = temp;
+      }
+      for ( j = 0; j < nrhs; j++ )
+      {
+        temp = b[k+j*n];
+        b[k+j*n] = b[piv+j*n];
+        b[piv+j*n] = temp;
+      }
+    }
+    for ( i = k + 1; i < n; i++ )
+    {
+      a[i+k*n] = a[i+k*n] / a[k+k*n];
+    }
+    for ( j = k + 1; j < n; j++ )
+    {
+      for ( i = k + 1; i < n; i++ )
+      {
+        a[i+j*n] = a[i+j*n] - a[i+k*n] * a[k+j*n];
+      }
+    }
+    for ( j = 0; j < nrhs; j++ )
+    {
+      for ( i = k + 1; i < n; i++ )
+      {
+        b[i+j*n] = b[i+j*n] - a[i+k*n] * b[k+j*n];
+      }
+    }
+  }
+
+  for ( j = 0; j < nrhs; j++ )
+  {
+    for ( k = n - 1; 0 <= k; k-- )
+    {
+      b[k+j*n] = b[k+j*n] / a[k+k*n];
+      r = b[k+j*n];
+      for ( i = 0; i < k; i++ )
+      {
+        b[i+j*n] = b[i+j*n] - a[i+k*n] * r;
+      }
+    }
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+void lti_step ( lti *l )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    LTI_STEP advances an LTI stepper by one step, X = E X + D.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, lti *L, the stepper.  L->X and L->T advance by L->H.
+*/
+{
+  int i;
+  int j;
+  int n = l->n;
+  double xj;
+
+  for ( i = 0; i < n; i++ )
+  {
+    l->y[i] = l->d[i];
+  }
+  for ( j = 0; j < n; j++ )
+  {
+    xj = l->x[j];
+    for ( i = 0; i < n; i++ )
+    {
+      l->y[i] = l->y[i] + l->e[i+j*n] * xj;
+    }
+  }
+  for ( i = 0; i < n; i++ )
+  {
+    l->x[i] = l->y[i];
+  }
+  l->nstep = l->nstep + 1;
+  l->t = l->t + l->h;
+
+  return;
+}
@@ -0,0 +1,48 @@
+/*
+  LTI holds exact propagators for linear systems with constant
+  coefficients, X' = A X + G:
+
+    LTI_EXPM  the dense matrix exponential, by a (6,6) Pade approximant
+              with scaling and squaring;
+    LTI       a fixed step stepper: E = exp ( A H ) and the response D to
+              the constant forcing G over one step are formed once, by
+              LTI_EXPM of the augmented matrix [ A G ; 0 0 ] H, and then
+              each step is X = E X + D, one matrix vector product, exact
+              up to rounding whatever H is;
+    LTI_EXPV  the action exp ( A T ) V of the exponential on a vector, by
+              Krylov subspaces, for large sparse A that is only available
+              through products A X; A is never formed.
+
+  A is stored by columns, entry (I,J) in A[I+J*N], as in STIFF.
+
+  LTI_EXPV takes the products from a right hand side F ( T, X, XP, DATA )
+  that must be linear and homogeneous in X, with T ignored, so the right
+  hand side of an ODE can be passed unchanged.  A constant forcing can be
+  handled by appending a component that stays equal to 1.
+*/
+# ifndef LTI_H
+# define LTI_H
+
+# include "ode.h"
+
+typedef struct
+{
+  int n;
+  double h;
+  double t;
+  double *e;
+  double *d;
+  double *x;
+  double *y;
+  long nstep;
+} lti;
+
+lti *lti_create ( int n, double a[], double g[], double h, double t,
+  double x[] );
+int lti_expm ( int n, double a[], double e[] );
+int lti_expv ( ode_rhs *f, int n, double t, double v[], double w[], int m,
+  double tol, long *nmv, void *data );
+void lti_free ( lti *l );
+void lti_step ( lti *l );
+
+# endif
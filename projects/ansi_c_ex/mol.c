@@ -0,0 +1,190 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <math.h>
+
+# include "mol.h"
+
+/******************************************************************************/
+
+mol *mol_create ( int n, double aleft[], double adiag[], double arite[],
+  double f[], double mass[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    MOL_CREATE sets up the semi-discrete system M U' = F - K U.
+
+  Discussion:
+
+    The arrays are copied, so the caller may go on to solve the steady
+    system in place.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int N, the number of unknowns.
+
+    Input, double ALEFT[N], ADIAG[N], ARITE[N], the diagonals of K;
+    ALEFT[0] and ARITE[N-1] are not used.
+
+    Input, double F[N], the right hand side.
+
+    Input, double MASS[N], the lumped mass of each unknown.
+
+    Output, mol *MOL_CREATE, the system.
+*/
+{
+  int i;
+  mol *ml;
+
+  ml = ( mol * ) malloc ( sizeof ( mol ) );
+  ml->n = n;
+  ml->aleft = ( double * ) malloc ( 5 * n * sizeof ( double ) );
+  ml->adiag = ml->aleft + n;
+  ml->arite = ml->adiag + n;
+  ml->f = ml->arite + n;
+  ml->mass = ml->f + n;
+  ml->nfev = 0;
+
+  for ( i = 0; i < n; i++ )
+  {
+    ml->aleft[i] = ( 0 < i ) ? aleft[i] : 0.0;
+    ml->adiag[i] = adiag[i];
+    ml->arite[i] = ( i < n - 1 ) ? arite[i] : 0.0;
+    ml->f[i] = f[i];
+    ml->mass[i] = mass[i];
+  }
+
+  return ml;
+}
+/******************************************************************************/
+
+void mol_free ( mol *ml )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    MOL_FREE frees a semi-discrete system.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, mol *ML, the system.
+*/
+{
+  free ( ml->aleft );
+  free ( ml );
+
+  return;
+}
+/******************************************************************************/
+
+double mol_gershgorin ( mol *ml )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    MOL_GERSHGORIN bounds the spectral radius of M^-1 K.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, mol *ML, the system.
+
+    Output, double MOL_GERSHGORIN, the largest value of
+    ( |ALEFT[I]| + |ADIAG[I]| + |ARITE[I]| ) / MASS[I].
+*/
+{
+  int i;
+  double rho;
+
+  rho = 0.0;
+  for ( i = 0; i < ml->n; i++ )
+  {
+    rho = fmax ( rho, ( fabs ( ml->aleft[i] ) + fabs ( ml->adiag[i] )
+      + fabs ( ml->arite[i] ) ) / ml->mass[i] );
+  }
+
+  return rho;
+}
+/******************************************************************************/
+
+void mol_rhs ( double t, double u[], double up[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    MOL_RHS evaluates U' = M^-1 ( F - K U ).
+
+  Discussion:
+
+    It has the form of an ode_rhs, with DATA the mol system.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double T, the time, not used.
+
+    Input, double U[N], the unknowns.
+
+    Output, double UP[N], their derivatives.
+
+    Input, void *DATA, the mol system.
+*/
+{
+  int i;
+  mol *ml = ( mol * ) data;
+  int n = ml->n;
+
+  if ( n == 1 )
+  {
+    up[0] = ( ml->f[0] - ml->adiag[0] * u[0] ) / ml->mass[0];
+    ml->nfev = ml->nfev + 1;
+    return;
+  }
+
+  up[0] = ( ml->f[0] - ml->adiag[0] * u[0] - ml->arite[0] * u[1] )
+    / ml->mass[0];
+  for ( i = 1; i < n - 1; i++ )
+  {
+    up[i] = ( ml->f[i] - ml->aleft[i] * u[i-1] - ml->adiag[i] * u[i]
+      - ml->arite[i] * u[i+1] ) / ml->mass[i];
+  }
+  up[n-1] = ( ml->f[n-1] - ml->aleft[n-1] * u[n-2]
+    - ml->adiag[n-1] * u[n-1] ) / ml->mass[n-1];
+  ml->nfev = ml->nfev + 1;
+
+  return;
+}
@@ -0,0 +1,46 @@
+/*
+  MOL turns a tridiagonal finite element system K U = F, such as the one
+  ASSEMBLE builds in fem2, into the semi-discrete system of the method
+  of lines,
+
+    M U' = F - K U,
+
+  with a lumped, diagonal, mass matrix M, so that any of the explicit
+  integrators can step the transient problem:
+
+    ml = mol_create ( n, aleft, adiag, arite, f, mass );
+    rho = mol_gershgorin ( ml );
+    rk4_step ( mol_rhs, n, t, h, u, work, ml );     or RKC_STEP
+    mol_free ( ml );
+
+  Row I of K is ALEFT[I] U[I-1] + ADIAG[I] U[I] + ARITE[I] U[I+1].
+  MOL_RHS applies it without forming anything but the three diagonals,
+  in one pass over U.
+
+  MOL_GERSHGORIN bounds the spectral radius of M^-1 K by the largest
+  Gershgorin disc, at no cost; RKC_RHO estimates it by power iteration
+  through MOL_RHS, which is closer for graded meshes.  Either gives the
+  stable explicit step, 2.78 / RHO for RK4, and the number of RKC
+  stages for a larger one.
+*/
+# ifndef MOL_H
+# define MOL_H
+
+typedef struct
+{
+  int n;
+  double *aleft;
+  double *adiag;
+  double *arite;
+  double *f;
+  double *mass;
+  long nfev;
+} mol;
+
+mol *mol_create ( int n, double aleft[], double adiag[], double arite[],
+  double f[], double mass[] );
+void mol_free ( mol *ml );
+double mol_gershgorin ( mol *ml );
+void mol_rhs ( double t, double u[], double up[], void *data );
+
+# endif
@@ -0,0 +1,1169 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <math.h>
+# include <float.h>
+# include <stdint.h>
+
+# include "ode.h"
+
+static double dopri_error ( dopri *d, double h );
+
+/******************************************************************************/
+
+int dopri_advance ( dopri *d, double tout )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    DOPRI_ADVANCE integrates up to a given time.
+
+  Discussion:
+
+    Steps are taken with DOPRI_STEP until D->T reaches TOUT exactly.
+    The last step is shortened to land on TOUT, but the step size
+    proposed by the controller is kept for the next call.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, dopri *D, the integrator.
+
+    Input, double TOUT, the time to reach.
+
+    Output, int DOPRI_ADVANCE, is 0 on success, or 1 if the step size
+    underflowed.
+*/
+{
+  while ( d->t < tout )
+  {
+    if ( dopri_step ( d, tout ) != 0 )
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+/******************************************************************************/
+
+dopri *dopri_create ( ode_rhs *f, int n, double t, double x[], double atol,
+  double rtol, void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    DOPRI_CREATE sets up a Dormand-Prince 5(4) integrator.
+
+  Discussion:
+
+    The error of each step is measured as the root mean square of
+    E(I) / ( ATOL + RTOL * max ( |X(I)|, |XNEW(I)| ) ), and a step is
+    accepted when this is at most 1.
+
+    The first step size is chosen as in Hairer, Norsett and Wanner,
+    which costs one extra evaluation of F.  D->HMAX, the largest step
+    allowed, is initially unlimited and may be set by the caller.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Ernst Hairer, Syvert Norsett, Gerhard Wanner,
+    Solving Ordinary Differential Equations I: Nonstiff Problems,
+    Springer, 1993, section II.4.
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T, X[N], the initial time and state.
+
+    Input, double ATOL, RTOL, the absolute and relative tolerances.
+
+    Input, void *DATA, passed to F.
+
+    Output, dopri *DOPRI_CREATE, the integrator, or NULL if memory
+    ran out.
+*/
+{
+  dopri *d;
+  double d0;
+  double d1;
+  double d2;
+  double h0;
+  double h1;
+  int i;
+  int j;
+  double sk;
+
+  d = ( dopri * ) malloc ( sizeof ( dopri ) );
+  if ( d == NULL )
+  {
+    return NULL;
+  }
+  d->arena = ode_arena_create ( n, 14 );
+  if ( d->arena == NULL )
+  {
+    free ( d );
+    return NULL;
+  }
+  d->x = ode_arena_alloc ( d->arena, n );
+  d->y = ode_arena_alloc ( d->arena, n );
+  for ( j = 0; j < 7; j++ )
+  {
+    d->k[j] = ode_arena_alloc ( d->arena, n );
+  }
+  d->rcont = ode_arena_alloc ( d->arena, 5 * n );
+
+  d->f = f;
+  d->data = data;
+  d->n = n;
+  d->atol = atol;
+  d->rtol = rtol;
+  d->hmax = HUGE_VAL;
+  d->t = t;
+  d->told = t;
+  d->dense = 0;
+  d->facold = 1.0E-04;
+  d->nfev = 0;
+  d->naccept = 0;
+  d->nreject = 0;
+
+  for ( i = 0; i < n; i++ )
+  {
+    d->x[i] = x[i];
+    d->rcont[i] = x[i];
+  }
+  for ( i = n; i < 5 * n; i++ )
+  {
+    d->rcont[i] = 0.0;
+  }
+  f ( t, d->x, d->k[0], data );
+  d->nfev = d->nfev + 1;
+  d->fsal = 1;
+/*
+  Initial step: make the first Euler step change X by about 1% of the
+  tolerance scale, then check against the second derivative.
+*/
+  d0 = 0.0;
+  d1 = 0.0;
+  for ( i = 0; i < n; i++ )
+  {
+    sk = atol + rtol * fabs ( x[i] );
+    d0 = d0 + ( x[i] / sk ) * ( x[i] / sk );
+    d1 = d1 + ( d->k[0][i] / sk ) * ( d->k[0][i] / sk );
+  }
+  d0 = sqrt ( d0 / n );
+  d1 = sqrt ( d1 / n );
+
+  if ( d0 < 1.0E-10 || d1 < 1.0E-10 )
+  {
+    h0 = 1.0E-06;
+  }
+  else
+  {
+    h0 = 0.01 * d0 / d1;
+  }
+
+  for ( i = 0; i < n; i++ )
+  {
+    d->y[i] = x[i] + h0 * d->k[0][i];
+  }
+  f ( t + h0, d->y, d->k[1], data );
+  d->nfev = d->nfev + 1;
+
+  d2 = 0.0;
+  for ( i = 0; i < n; i++ )
+  {
+    sk = atol + rtol * fabs ( x[i] );
+    d2 = d2 + pow ( ( d->k[1][i] - d->k[0][i] ) / sk, 2 );
+  }
+  d2 = sqrt ( d2 / n ) / h0;
+
+  if ( fmax ( d1, d2 ) <= 1.0E-15 )
+  {
+    h1 = fmax ( 1.0E-06, h0 * 1.0E-03 );
+  }
+  else
+  {
+    h1 = pow ( 0.01 / fmax ( d1, d2 ), 0.2 );
+  }
+  d->h = fmin ( 100.0 * h0, h1 );
+
+  return d;
+}
+/******************************************************************************/
+
+void dopri_eval ( dopri *d, double t, double x[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    DOPRI_EVAL evaluates the dense output of the last step.
+
+  Discussion:
+
+    This is the fourth order continuous extension of Dormand and
+    Prince, as in Hairer's CONTD5.  It needs D->DENSE to have been set
+    during the last step, and is meant for D->TOLD <= T <= D->T, though
+    it will extrapolate.  The cost is 4 multiply-adds per component,
+    with no calls of F.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, dopri *D, the integrator.
+
+    Input, double T, the time.
+
+    Output, double X[N], the interpolated state.
+*/
+{
+  int i;
+  int n = d->n;
+  double *r = d->rcont;
+  double s;
+  double s1;
+
+  if ( d->t == d->told )
+  {
+    for ( i = 0; i < n; i++ )
+    {
+      x[i] = r[i];
+    }
+    return;
+  }
+
+  s = ( t - d->told ) / ( d->t - d->told );
+  s1 = 1.0 - s;
+
+  for ( i = 0; i < n; i++ )
+  {
+    x[i] = r[i] + s * ( r[i+n] + s1 * ( r[i+2*n] + s * ( r[i+3*n]
+      + s1 * r[i+4*n] ) ) );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void dopri_free ( dopri *d )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    DOPRI_FREE frees a Dormand-Prince integrator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, dopri *D, the integrator.
+*/
+{
+  ode_arena_free ( d->arena );
+  free ( d );
+
+  return;
+}
+/******************************************************************************/
+
+int dopri_grid ( dopri *d, int m, double tgrid[], double xgrid[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    DOPRI_GRID integrates and reports the solution on a time grid.
+
+  Discussion:
+
+    The integrator steps toward TGRID[M-1] with whatever steps the
+    error control allows, and each grid point is filled from the dense
+    output of the step that covers it.  The grid only decides what is
+    reported, not how many steps are taken.
+
+    D->DENSE is switched on.  On return D->T = TGRID[M-1].
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, dopri *D, the integrator.
+
+    Input, int M, the number of grid points.
+
+    Input, double TGRID[M], nondecreasing times, with D->T <= TGRID[0].
+
+    Output, double XGRID[M*N], the state at TGRID[I] in
+    XGRID[I*N+0:I*N+N-1].
+
+    Output, int DOPRI_GRID, is 0 on success, or 1 if the step size
+    underflowed.
+*/
+{
+  int i;
+  int j;
+  int n = d->n;
+
+  d->dense = 1;
+  i = 0;
+
+  while ( i < m )
+  {
+    if ( tgrid[i] == d->t )
+    {
+      for ( j = 0; j < n; j++ )
+      {
+        xgrid[i*n+j] = d->x[j];
+      }
+      i = i + 1;
+    }
+    else if ( tgrid[i] < d->t )
+    {
+      dopri_eval ( d, tgrid[i], xgrid + i * n );
+      i = i + 1;
+    }
+    else if ( dopri_step ( d, tgrid[m-1] ) != 0 )
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+static double dopri_error ( dopri *d, double h )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    DOPRI_ERROR is the scaled RMS norm of the local error estimate.
+
+  Discussion:
+
+    The estimate H * sum ( E(J) * K(J) ) is formed and measured in the
+    same pass over the stages, without storing it.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, dopri *D, the integrator, with the stages of the step in D->K,
+    the old state in D->X and the new one in D->Y.
+
+    Input, double H, the step size.
+
+    Output, double DOPRI_ERROR, the norm.
+*/
+{
+  const double e1 = 71.0 / 57600.0, e3 = -71.0 / 16695.0,
+    e4 = 71.0 / 1920.0, e5 = -17253.0 / 339200.0, e6 = 22.0 / 525.0,
+    e7 = -1.0 / 40.0;
+  double ei;
+  int i;
+  double **k = d->k;
+  int n = d->n;
+  double sk;
+  double value;
+  double *x = d->x;
+  double *y = d->y;
+
+  value = 0.0;
+  ODE_OMP ( parallel for private ( ei, sk ) reduction ( + : value )
+    if ( ODE_PAR_MIN <= n ) )
+  for ( i = 0; i < n; i++ )
+  {
+    ei = h * ( e1 * k[0][i] + e3 * k[2][i] + e4 * k[3][i]
+      + e5 * k[4][i] + e6 * k[5][i] + e7 * k[6][i] );
+    sk = d->atol + d->rtol * fmax ( fabs ( x[i] ), fabs ( y[i] ) );
+    value = value + ( ei / sk ) * ( ei / sk );
+  }
+  value = sqrt ( value / n );
+
+  return value;
+}
+/******************************************************************************/
+
+int dopri_step ( dopri *d, double tout )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    DOPRI_STEP takes one accepted Dormand-Prince 5(4) step.
+
+  Discussion:
+
+    The fifth order solution is propagated, and the difference from the
+    embedded fourth order solution is the error estimate.  The last
+    stage is evaluated at the new point, so on acceptance it becomes
+    the first stage of the next step (FSAL) and an accepted step costs
+    6 evaluations of F.
+
+    Step sizes follow the PI controller of Hairer's DOPRI5 code,
+    with safety factor 0.9 and a change of at most 1/5 to 10 times.
+    Rejected steps are retried inside this routine.
+
+    The step never goes past TOUT.
+
+    If D->DENSE is set, the interpolant for DOPRI_EVAL is formed from
+    the stages already computed, at a cost of O(N) and no calls of F.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    John Dormand, Peter Prince,
+    A family of embedded Runge-Kutta formulae,
+    Journal of Computational and Applied Mathematics,
+    Volume 6, Number 1, 1980, pages 19-26.
+
+  Parameters:
+
+    Input/output, dopri *D, the integrator.
+
+    Input, double TOUT, a time not to step past.
+
+    Output, int DOPRI_STEP, is 0 on success, or 1 if the step size
+    became too small to change T.
+*/
+{
+  const double a21 = 1.0 / 5.0;
+  const double a31 = 3.0 / 40.0, a32 = 9.0 / 40.0;
+  const double a41 = 44.0 / 45.0, a42 = -56.0 / 15.0, a43 = 32.0 / 9.0;
+  const double a51 = 19372.0 / 6561.0, a52 = -25360.0 / 2187.0,
+    a53 = 64448.0 / 6561.0, a54 = -212.0 / 729.0;
+  const double a61 = 9017.0 / 3168.0, a62 = -355.0 / 33.0,
+    a63 = 46732.0 / 5247.0, a64 = 49.0 / 176.0, a65 = -5103.0 / 18656.0;
+  const double a71 = 35.0 / 384.0, a73 = 500.0 / 1113.0,
+    a74 = 125.0 / 192.0, a75 = -2187.0 / 6784.0, a76 = 11.0 / 84.0;
+  const double d1 = -12715105075.0 / 11282082432.0,
+    d3 = 87487479700.0 / 32700410799.0, d4 = -10690763975.0 / 1880347072.0,
+    d5 = 701980252875.0 / 199316789632.0, d6 = -1453857185.0 / 822651844.0,
+    d7 = 69997945.0 / 29380423.0;
+  const double beta = 0.04;
+  const double safe = 0.9;
+  double err;
+  double fac;
+  double fac11;
+  double h;
+  double hnew;
+  int i;
+  double **k = d->k;
+  double *r = d->rcont;
+  double ydiff;
+  double bspl;
+  int last;
+  int n = d->n;
+  double *kt;
+  int reject;
+  double t = d->t;
+  double *x = d->x;
+  double *y = d->y;
+
+  if ( !d->fsal )
+  {
+    d->f ( t, x, k[0], d->data );
+    d->nfev = d->nfev + 1;
+    d->fsal = 1;
+  }
+
+  reject = 0;
+
+  for ( ; ; )
+  {
+    h = fmin ( d->h, d->hmax );
+    last = 0;
+    if ( tout <= t + 1.01 * h )
+    {
+      h = tout - t;
+      last = 1;
+    }
+    if ( fabs ( h ) <= 16.0 * DBL_EPSILON * fabs ( t ) || h <= 0.0 )
+    {
+      return 1;
+    }
+
+    ODE_OMP ( parallel for if ( ODE_PAR_MIN <= n ) )
+    for ( i = 0; i < n; i++ )
+    {
+      y[i] = x[i] + h * a21 * k[0][i];
+    }
+    d->f ( t + h / 5.0, y, k[1], d->data );
+
+    ODE_OMP ( parallel for if ( ODE_PAR_MIN <= n ) )
+    for ( i = 0; i < n; i++ )
+    {
+      y[i] = x[i] + h * ( a31 * k[0][i] + a32 * k[1][i] );
+    }
+    d->f ( t + 3.0 * h / 10.0, y, k[2], d->data );
+
+    ODE_OMP ( parallel for if ( ODE_PAR_MIN <= n ) )
+    for ( i = 0; i < n; i++ )
+    {
+      y[i] = x[i] + h * ( a41 * k[0][i] + a42 * k[1][i] + a43 * k[2][i] );
+    }
+    d->f ( t + 4.0 * h / 5.0, y, k[3], d->data );
+
+    ODE_OMP ( parallel for if ( ODE_PAR_MIN <= n ) )
+    for ( i = 0; i < n; i++ )
+    {
+      y[i] = x[i] + h * ( a51 * k[0][i] + a52 * k[1][i] + a53 * k[2][i]
+        + a54 * k[3][i] );
+    }
+    d->f ( t + 8.0 * h / 9.0, y, k[4], d->data );
+
+    ODE_OMP ( parallel for if ( ODE_PAR_MIN <= n ) )
+    for ( i = 0; i < n; i++ )
+    {
+      y[i] = x[i] + h * ( a61 * k[0][i] + a62 * k[1][i] + a63 * k[2][i]
+        + a64 * k[3][i] + a65 * k[4][i] );
+    }
+    d->f ( t + h, y, k[5], d->data );
+
+    ODE_OMP ( parallel for if ( ODE_PAR_MIN <= n ) )
+    for ( i = 0; i < n; i++ )
+    {
+      y[i] = x[i] + h * ( a71 * k[0][i] + a73 * k[2][i] + a74 * k[3][i]
+        + a75 * k[4][i] + a76 * k[5][i] );
+    }
+    d->f ( t + h, y, k[6], d->data );
+    d->nfev = d->nfev + 6;
+    err = dopri_error ( d, h );
+
+    fac11 = pow ( err, 0.2 - 0.75 * beta );
+
+    if ( err <= 1.0 )
+    {
+      fac = fac11 / pow ( d->facold, beta );
+      fac = fmax ( 0.1, fmin ( 5.0, fac / safe ) );
+      hnew = h / fac;
+      if ( reject )
+      {
+        hnew = fmin ( hnew, h );
+      }
+      d->facold = fmax ( err, 1.0E-04 );
+/*
+  Accept.  Keep the proposed step, not the one shortened to hit TOUT.
+*/
+      if ( !last || d->h < hnew )
+      {
+        d->h = hnew;
+      }
+      if ( d->dense )
+      {
+        ODE_OMP ( parallel for private ( ydiff, bspl )
+          if ( ODE_PAR_MIN <= n ) )
+        for ( i = 0; i < n; i++ )
+        {
+          ydiff = y[i] - x[i];
+          bspl = h * k[0][i] - ydiff;
+          r[i] = x[i];
+          r[i+n] = ydiff;
+          r[i+2*n] = bspl;
+          r[i+3*n] = ydiff - h * k[6][i] - bspl;
+          r[i+4*n] = h * ( d1 * k[0][i] + d3 * k[2][i] + d4 * k[3][i]
+            + d5 * k[4][i] + d6 * k[5][i] + d7 * k[6][i] );
+        }
+      }
+/*
+  The new state becomes the old one by exchanging X and Y, not by a copy.
+*/
+      d->x = y;
+      d->y = x;
+      kt = k[0];
+      k[0] = k[6];
+      k[6] = kt;
+      d->told = t;
+      d->t = last ? tout : t + h;
+      d->naccept = d->naccept + 1;
+      return 0;
+    }
+
+    d->h = h / fmin ( 5.0, fac11 / safe );
+    d->nreject = d->nreject + 1;
+    reject = 1;
+  }
+}
+/******************************************************************************/
+
+double *ode_arena_alloc ( ode_arena *a, int n )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ODE_ARENA_ALLOC takes an aligned vector from an arena.
+
+  Discussion:
+
+    The vector starts on an ODE_ALIGN byte boundary, and its length is
+    rounded up to a whole number of ODE_ALIGN byte lines, so the next
+    one starts aligned as well.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, ode_arena *A, the arena.
+
+    Input, int N, the number of doubles.
+
+    Output, double *ODE_ARENA_ALLOC, the vector, or NULL if the arena
+    is full.
+*/
+{
+  size_t bytes;
+  double *v;
+
+  bytes = ( ( ( size_t ) n * sizeof ( double ) + ODE_ALIGN - 1 )
+    / ODE_ALIGN ) * ODE_ALIGN;
+  if ( a->size < a->used + bytes )
+  {
+    return NULL;
+  }
+  v = ( double * ) ( a->base + a->used );
+  a->used = a->used + bytes;
+
+  return v;
+}
+/******************************************************************************/
+
+ode_arena *ode_arena_create ( int n, int count )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ODE_ARENA_CREATE allocates an arena for aligned vectors.
+
+  Discussion:
+
+    The arena has room for COUNT vectors of up to N doubles each.  A
+    request for up to M*N doubles fits in M of those slots.  Everything
+    is released at once by ODE_ARENA_FREE.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int N, the length of a slot.
+
+    Input, int COUNT, the number of slots.
+
+    Output, ode_arena *ODE_ARENA_CREATE, the arena, or NULL if memory
+    ran out.
+*/
+{
+  ode_arena *a;
+  size_t slot;
+
+  a = ( ode_arena * ) malloc ( sizeof ( ode_arena ) );
+  if ( a == NULL )
+  {
+    return NULL;
+  }
+  slot = ( ( ( size_t ) n * sizeof ( double ) + ODE_ALIGN - 1 )
+    / ODE_ALIGN ) * ODE_ALIGN;
+  a->size = ( size_t ) count * slot;
+  a->used = 0;
+  a->block = ( char * ) malloc ( a->size + ODE_ALIGN );
+  if ( a->block == NULL )
+  {
+    free ( a );
+    return NULL;
+  }
+  a->base = a->block
+    + ( ODE_ALIGN - ( uintptr_t ) a->block % ODE_ALIGN ) % ODE_ALIGN;
+
+  return a;
+}
+/******************************************************************************/
+
+void ode_arena_free ( ode_arena *a )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ODE_ARENA_FREE frees an arena and every vector taken from it.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_arena *A, the arena.
+*/
+{
+  free ( a->block );
+  free ( a );
+
+  return;
+}
+/******************************************************************************/
+
+ode_ctx *ode_ctx_create ( ode_rhs *f, int n, double t, double x[], double h,
+  void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ODE_CTX_CREATE sets up a fixed step RK4 integration context.
+
+  Discussion:
+
+    The context has no sink; set C->OUT to record rows, and C->ID to
+    tell trajectories apart when several contexts share one sink.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T, X[N], the initial time and state.
+
+    Input, double H, the step size.
+
+    Input, void *DATA, passed to F.
+
+    Output, ode_ctx *ODE_CTX_CREATE, the context, or NULL if memory
+    ran out.
+*/
+{
+  ode_ctx *c;
+  int i;
+
+  c = ( ode_ctx * ) malloc ( sizeof ( ode_ctx ) );
+  if ( c == NULL )
+  {
+    return NULL;
+  }
+  c->arena = ode_arena_create ( n + 2, 5 );
+  if ( c->arena == NULL )
+  {
+    free ( c );
+    return NULL;
+  }
+  c->x = ode_arena_alloc ( c->arena, n );
+  c->work = ode_arena_alloc ( c->arena, 3 * n );
+  c->row = ode_arena_alloc ( c->arena, n + 2 );
+
+  c->f = f;
+  c->data = data;
+  c->n = n;
+  c->id = 0;
+  c->t = t;
+  c->h = h;
+  c->out = NULL;
+  c->nfev = 0;
+  for ( i = 0; i < n; i++ )
+  {
+    c->x[i] = x[i];
+  }
+
+  return c;
+}
+/******************************************************************************/
+
+void ode_ctx_free ( ode_ctx *c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ODE_CTX_FREE frees an integration context.
+
+  Discussion:
+
+    The sink, if any, belongs to the caller and is not closed.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_ctx *C, the context.
+*/
+{
+  ode_arena_free ( c->arena );
+  free ( c );
+
+  return;
+}
+/******************************************************************************/
+
+void ode_ctx_run ( ode_ctx *c, double tend )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ODE_CTX_RUN integrates a context up to a final time.
+
+  Discussion:
+
+    The number of steps is ( TEND - C->T ) / C->H rounded to the nearest
+    integer, and the times are computed as C->T + I * C->H, so they do
+    not drift.  If C->OUT is set, the starting row and one row per step
+    are written, each as ( C->ID, T, X[0], ..., X[N-1] ).
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, ode_ctx *C, the context.
+
+    Input, double TEND, the final time.
+*/
+{
+  int i;
+  int j;
+  int nstep;
+  double *row = c->row;
+  double t0;
+
+  t0 = c->t;
+  nstep = ( int ) floor ( ( tend - t0 ) / c->h + 0.5 );
+
+  for ( i = 0; i <= nstep; i++ )
+  {
+    if ( 0 < i )
+    {
+      ode_ctx_step ( c );
+      c->t = t0 + i * c->h;
+    }
+    if ( c->out != NULL )
+    {
+      row[0] = ( double ) c->id;
+      row[1] = c->t;
+      for ( j = 0; j < c->n; j++ )
+      {
+        row[j+2] = c->x[j];
+      }
+      sink_row ( c->out, row );
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void ode_ctx_step ( ode_ctx *c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ODE_CTX_STEP takes one RK4 step of a context.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, ode_ctx *C, the context.  C->X and C->T advance by
+    one step of size C->H.
+*/
+{
+  rk4_step ( c->f, c->n, c->t, c->h, c->x, c->work, c->data );
+  c->t = c->t + c->h;
+  c->nfev = c->nfev + 4;
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_ensemble ( ode_ens_rhs *f, int n, int count, double t, double h,
+  double x[], double work[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    RK4_ENSEMBLE takes one RK4 step for an ensemble of systems.
+
+  Discussion:
+
+    All COUNT copies advance together with the same T and H.  They are
+    handled ODE_BLOCK at a time: the block is copied into WORK, the four
+    stages run on it with F called once per stage for the whole block,
+    and the result is copied back.  A block's working set is
+    4 * N * ODE_BLOCK doubles, which stays in the level 1 or 2 cache, and
+    the inner loops run over copies with unit stride, so the compiler
+    can vectorize them (-O3, or -O2 -ftree-vectorize).
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_ens_rhs *F, the right hand side for a block of copies.
+
+    Input, int N, the number of components of each system.
+
+    Input, int COUNT, the number of copies.
+
+    Input, double T, H, the time and the step size.
+
+    Input/output, double X[N*COUNT], the states at T, with component J
+    of copy I in X[J*COUNT+I], replaced by the states at T+H.
+
+    Workspace, double WORK[4*N*ODE_BLOCK].
+
+    Input, void *DATA, passed to F.
+*/
+{
+  double *acc;
+  int first;
+  int i;
+  int j;
+  double *k;
+  int ld = ODE_BLOCK;
+  int m;
+  double *x0;
+  double *xs;
+
+  x0 = work;
+  k = work + n * ld;
+  xs = work + 2 * n * ld;
+  acc = work + 3 * n * ld;
+
+  for ( first = 0; first < count; first = first + ld )
+  {
+    m = count - first;
+    if ( ld < m )
+    {
+      m = ld;
+    }
+
+    for ( j = 0; j < n; j++ )
+    {
+      for ( i = 0; i < m; i++ )
+      {
+        x0[j*ld+i] = x[j*count+first+i];
+      }
+    }
+
+    f ( t, first, m, ld, x0, k, data );
+    for ( j = 0; j < n; j++ )
+    {
+      for ( i = 0; i < m; i++ )
+      {
+        acc[j*ld+i] = k[j*ld+i];
+        xs[j*ld+i] = x0[j*ld+i] + ( h / 2.0 ) * k[j*ld+i];
+      }
+    }
+
+    f ( t + ( h / 2.0 ), first, m, ld, xs, k, data );
+    for ( j = 0; j < n; j++ )
+    {
+      for ( i = 0; i < m; i++ )
+      {
+        acc[j*ld+i] = acc[j*ld+i] + 2.0 * k[j*ld+i];
+        xs[j*ld+i] = x0[j*ld+i] + ( h / 2.0 ) * k[j*ld+i];
+      }
+    }
+
+    f ( t + ( h / 2.0 ), first, m, ld, xs, k, data );
+    for ( j = 0; j < n; j++ )
+    {
+      for ( i = 0; i < m; i++ )
+      {
+        acc[j*ld+i] = acc[j*ld+i] + 2.0 * k[j*ld+i];
+        xs[j*ld+i] = x0[j*ld+i] + h * k[j*ld+i];
+      }
+    }
+
+    f ( t + h, first, m, ld, xs, k, data );
+    for ( j = 0; j < n; j++ )
+    {
+      for ( i = 0; i < m; i++ )
+      {
+        x[j*count+first+i] = x0[j*ld+i]
+          + ( h / 6.0 ) * ( acc[j*ld+i] + k[j*ld+i] );
+      }
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void rk4_step ( ode_rhs *f, int n, double t, double h, double x[],
+  double work[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    RK4_STEP takes one classical fourth order Runge-Kutta step.
+
+  Discussion:
+
+    Each stage is one call of F for the whole vector, so a step costs
+    4 calls plus O(N) work.  X is only overwritten at the end.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T, H, the time and the step size.
+
+    Input/output, double X[N], the state at T, replaced by the state
+    at T+H.
+
+    Workspace, double WORK[3*N], holding the current stage, the stage
+    point and the running sum K1 + 2 K2 + 2 K3.
+
+    Input, void *DATA, passed to F.
+*/
+{
+  double *acc = work + 2 * n;
+  int j;
+  double *k = work;
+  double *xs = work + n;
+
+  f ( t, x, k, data );
+  ODE_OMP ( parallel for if ( ODE_PAR_MIN <= n ) )
+  for ( j = 0; j < n; j++ )
+  {
+    acc[j] = k[j];
+    xs[j] = x[j] + ( h / 2.0 ) * k[j];
+  }
+
+  f ( t + ( h / 2.0 ), xs, k, data );
+  ODE_OMP ( parallel for if ( ODE_PAR_MIN <= n ) )
+  for ( j = 0; j < n; j++ )
+  {
+    acc[j] = acc[j] + 2.0 * k[j];
+    xs[j] = x[j] + ( h / 2.0 ) * k[j];
+  }
+
+  f ( t + ( h / 2.0 ), xs, k, data );
+  ODE_OMP ( parallel for if ( ODE_PAR_MIN <= n ) )
+  for ( j = 0; j < n; j++ )
+  {
+    acc[j] = acc[j] + 2.0 * k[j];
+    xs[j] = x[j] + h * k[j];
+  }
+
+  f ( t + h, xs, k, data );
+  ODE_OMP ( parallel for if ( ODE_PAR_MIN <= n ) )
+  for ( j = 0; j < n; j++ )
+  {
+    x[j] = x[j] + ( h / 6.0 ) * ( acc[j] + k[j] );
+  }
+
+  return;
+}
@@ -0,0 +1,135 @@
+/*
+  ODE holds the time steppers used by the oscillator programs.
+
+  A right hand side has the form F ( T, X, XP, DATA ): given the time T
+  and the state X[0:N-1], it fills all of XP[0:N-1] with dX/dT.  DATA is
+  passed through untouched, for parameters.
+
+  RK4_STEP is one classical Runge-Kutta step of fixed size.
+
+  DOPRI is the Dormand-Prince 5(4) pair with error control:
+
+    d = dopri_create ( f, n, t, x, atol, rtol, data );
+    dopri_advance ( d, tout );     the state is now d->x at d->t = tout
+    dopri_free ( d );
+
+  With D->DENSE set, each accepted step also keeps a fourth order
+  interpolant over [D->TOLD, D->T], and DOPRI_EVAL samples it.
+  DOPRI_GRID uses this to report the solution on any time grid while
+  the steps themselves are chosen by the error control alone.
+
+  ODE_CTX holds everything one fixed step RK4 integration needs: the
+  right hand side and its parameters, the state, the workspace and an
+  optional results sink.  Nothing is global, so any number of contexts
+  can run at once, for instance one per trajectory on the threads of
+  POOL_RUN.
+
+  RK4_ENSEMBLE takes the same step for COUNT independent copies of a
+  system, stored as structure of arrays: component J of copy I is
+  X[J*COUNT+I].  Its right hand side works on a block of copies at once,
+  F ( T, FIRST, COUNT, LD, X, XP, DATA ), with component J of copy
+  FIRST+I in X[J*LD+I], so the loops over I can use the SIMD units.
+
+  N is only known at run time, and nothing is sized by a compile time
+  constant.  ODE_ARENA hands out the state and stage vectors from one
+  block, each starting on a 64 byte boundary, so a vector never shares
+  a cache line with its neighbour and the stage loops vectorize without
+  a peeling loop.  Every stage update is a single fused pass over N.
+  Compiled with -fopenmp, those passes are split among threads once N
+  is at least ODE_PAR_MIN; below that, or without -fopenmp, they run
+  serially and the results are the same bit for bit.  Above it, the
+  error norm of DOPRI is summed in another order, so its step sizes may
+  differ in the last bits with the number of threads.  The loops are
+  marked with ODE_OMP ( clauses ), which is "# pragma omp clauses" with
+  OpenMP and nothing without it, so a build without -fopenmp has no
+  unknown pragmas to warn about.
+*/
+# ifndef ODE_H
+# define ODE_H
+
+# include "sink.h"
+
+# define ODE_ALIGN 64
+# define ODE_BLOCK 256
+# define ODE_PAR_MIN 32768
+
+# ifdef _OPENMP
+# define ODE_STRING(...) # __VA_ARGS__
+# define ODE_OMP(...) _Pragma ( ODE_STRING ( omp __VA_ARGS__ ) )
+# else
+# define ODE_OMP(...)
+# endif
+
+typedef void ode_rhs ( double t, double x[], double xp[], void *data );
+typedef void ode_ens_rhs ( double t, int first, int count, int ld, double x[],
+  double xp[], void *data );
+
+typedef struct
+{
+  char *block;
+  char *base;
+  size_t size;
+  size_t used;
+} ode_arena;
+
+typedef struct
+{
+  ode_rhs *f;
+  void *data;
+  int n;
+  double atol;
+  double rtol;
+  double hmax;
+  double t;
+  double h;
+  double facold;
+  double *x;
+  double *y;
+  double *k[7];
+  int fsal;
+  int dense;
+  double told;
+  double *rcont;
+  ode_arena *arena;
+  long nfev;
+  long naccept;
+  long nreject;
+} dopri;
+
+typedef struct
+{
+  ode_rhs *f;
+  void *data;
+  int n;
+  int id;
+  double t;
+  double h;
+  double *x;
+  double *work;
+  double *row;
+  ode_arena *arena;
+  sink *out;
+  long nfev;
+} ode_ctx;
+
+int dopri_advance ( dopri *d, double tout );
+dopri *dopri_create ( ode_rhs *f, int n, double t, double x[], double atol,
+  double rtol, void *data );
+void dopri_eval ( dopri *d, double t, double x[] );
+void dopri_free ( dopri *d );
+int dopri_grid ( dopri *d, int m, double tgrid[], double xgrid[] );
+int dopri_step ( dopri *d, double tout );
+double *ode_arena_alloc ( ode_arena *a, int n );
+ode_arena *ode_arena_create ( int n, int count );
+void ode_arena_free ( ode_arena *a );
+ode_ctx *ode_ctx_create ( ode_rhs *f, int n, double t, double x[], double h,
+  void *data );
+void ode_ctx_free ( ode_ctx *c );
+void ode_ctx_run ( ode_ctx *c, double tend );
+void ode_ctx_step ( ode_ctx *c );
+void rk4_ensemble ( ode_ens_rhs *f, int n, int count, double t, double h,
+  double x[], double work[], void *data );
+void rk4_step ( ode_rhs *f, int n, double t, double h, double x[],
+  double work[], void *data );
+
+# endif
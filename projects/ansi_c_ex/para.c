@@ -0,0 +1,332 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <math.h>
+
+# include "para.h"
+# include "pool.h"
+
+static void para_coarse ( para *p, int j, double x[], double g[] );
+static void para_fine ( int i, int thread, void *arg );
+
+/******************************************************************************/
+
+static void para_coarse ( para *p, int j, double x[], double g[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PARA_COARSE applies the coarse propagator over slice J.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, para *P, the Parareal integrator; its first thread
+    workspace is used.
+
+    Input, int J, the slice.
+
+    Input, double X[N], the state at the start of the slice.
+
+    Output, double G[N], the coarse state at its end.
+*/
+{
+  double h;
+  int i;
+  int n = p->n;
+  double ts;
+
+  ts = p->t0 + j * ( p->t1 - p->t0 ) / p->nslice;
+  h = ( p->t1 - p->t0 ) / p->nslice / p->ncoarse;
+  for ( i = 0; i < n; i++ )
+  {
+    g[i] = x[i];
+  }
+  for ( i = 0; i < p->ncoarse; i++ )
+  {
+    rk4_step ( p->f, n, ts + i * h, h, g, p->work, p->data );
+  }
+  p->nfev = p->nfev + 4 * p->ncoarse;
+
+  return;
+}
+/******************************************************************************/
+
+para *para_create ( ode_rhs *f, int n, double t0, double t1, double x0[],
+  int nslice, int nfine, void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PARA_CREATE sets up a Parareal integration.
+
+  Discussion:
+
+    The defaults are NCOARSE = 1, NTHREAD = 1, TOL = 1.0E-10 and
+    MAXITER = NSLICE; change them before PARA_RUN.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T0, T1, the time interval.
+
+    Input, double X0[N], the state at T0.
+
+    Input, int NSLICE, the number of time slices.
+
+    Input, int NFINE, the number of fine RK4 steps per slice.
+
+    Input, void *DATA, passed to F.
+
+    Output, para *PARA_CREATE, the Parareal integrator.
+*/
+{
+  int i;
+  para *p;
+
+  p = ( para * ) malloc ( sizeof ( para ) );
+  p->f = f;
+  p->data = data;
+  p->n = n;
+  p->t0 = t0;
+  p->t1 = t1;
+  p->nslice = nslice;
+  p->nfine = nfine;
+  p->ncoarse = 1;
+  p->nthread = 1;
+  p->tol = 1.0E-10;
+  p->maxiter = nslice;
+  p->u = ( double * ) malloc ( ( 3 * nslice + 1 ) * n * sizeof ( double ) );
+  p->gold = p->u + ( nslice + 1 ) * n;
+  p->fine = p->gold + nslice * n;
+  p->work = NULL;
+  p->defect = ( double * ) malloc ( nslice * sizeof ( double ) );
+  p->iter = 0;
+  p->first = 0;
+  p->nfev = 0;
+
+  for ( i = 0; i < n; i++ )
+  {
+    p->u[i] = x0[i];
+  }
+
+  return p;
+}
+/******************************************************************************/
+
+static void para_fine ( int i, int thread, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PARA_FINE applies the fine propagator over one slice, as a pool task.
+
+  Discussion:
+
+    Task I is slice P->FIRST+I; the slices before P->FIRST are already
+    exact.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int I, the task.
+
+    Input, int THREAD, the calling thread, which picks the workspace.
+
+    Input, void *ARG, the Parareal integrator.
+*/
+{
+  double h;
+  int j;
+  int k;
+  int n;
+  para *p = ( para * ) arg;
+  double ts;
+  double *w;
+  double *x;
+
+  n = p->n;
+  j = p->first + i;
+  ts = p->t0 + j * ( p->t1 - p->t0 ) / p->nslice;
+  h = ( p->t1 - p->t0 ) / p->nslice / p->nfine;
+  x = p->fine + j * n;
+  w = p->work + thread * 3 * n;
+
+  for ( k = 0; k < n; k++ )
+  {
+    x[k] = p->u[j*n+k];
+  }
+  for ( k = 0; k < p->nfine; k++ )
+  {
+    rk4_step ( p->f, n, ts + k * h, h, x, w, p->data );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+void para_free ( para *p )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PARA_FREE frees a Parareal integrator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, para *P, the Parareal integrator.
+*/
+{
+  free ( p->u );
+  free ( p->work );
+  free ( p->defect );
+  free ( p );
+
+  return;
+}
+/******************************************************************************/
+
+int para_run ( para *p )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PARA_RUN carries out the Parareal iterations.
+
+  Discussion:
+
+    The correction is formed as F + ( Gnew - Gold ), so once U(J) stops
+    changing, U(J+1) is the fine value bit for bit, and the result after
+    NSLICE iterations is exactly that of the serial fine run, as long as
+    the serial run takes the same steps.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input/output, para *P, the Parareal integrator.  On output P->U
+    holds the solution at the slice ends, P->ITER the number of
+    iterations and P->DEFECT their changes.
+
+    Output, int PARA_RUN, is 0 if the iterations converged, or 1 if
+    MAXITER iterations did not reach TOL.
+*/
+{
+  double change;
+  double *g;
+  int i;
+  int j;
+  int n = p->n;
+  pool *pl;
+  int status;
+  double un;
+
+  free ( p->work );
+  p->work = ( double * ) malloc ( ( 3 * p->nthread + 1 ) * n
+    * sizeof ( double ) );
+  g = p->work + 3 * p->nthread * n;
+/*
+  The starting values, from one coarse sweep.
+*/
+  for ( j = 0; j < p->nslice; j++ )
+  {
+    para_coarse ( p, j, p->u + j * n, p->gold + j * n );
+    for ( i = 0; i < n; i++ )
+    {
+      p->u[(j+1)*n+i] = p->gold[j*n+i];
+    }
+  }
+
+/*
+  One pool serves all the iterations, so the threads start only once.
+*/
+  pl = pool_create ( p->nthread );
+  if ( pl->nfail != 0 )
+  {
+    fprintf ( stderr, "PARA_RUN: some threads could not be started.\n" );
+  }
+
+  status = 1;
+  p->iter = 0;
+  for ( p->first = 0; p->first < p->nslice && p->iter < p->maxiter;
+    p->first++ )
+  {
+    pool_exec ( pl, p->nslice - p->first, para_fine, p );
+    p->nfev = p->nfev + 4 * ( long ) p->nfine * ( p->nslice - p->first );
+/*
+  The serial correction sweep.  Slice FIRST starts from an exact value,
+  so its end becomes exact as well.
+*/
+    p->defect[p->iter] = 0.0;
+    for ( j = p->first; j < p->nslice; j++ )
+    {
+      para_coarse ( p, j, p->u + j * n, g );
+      for ( i = 0; i < n; i++ )
+      {
+        un = p->fine[j*n+i] + ( g[i] - p->gold[j*n+i] );
+        change = fabs ( un - p->u[(j+1)*n+i] ) / ( 1.0 + fabs ( un ) );
+        p->defect[p->iter] = fmax ( p->defect[p->iter], change );
+        p->u[(j+1)*n+i] = un;
+        p->gold[j*n+i] = g[i];
+      }
+    }
+    p->iter = p->iter + 1;
+
+    if ( p->defect[p->iter-1] <= p->tol )
+    {
+      status = 0;
+      break;
+    }
+  }
+  if ( p->nslice <= p->first )
+  {
+    status = 0;
+  }
+
+  pool_free ( pl );
+
+  return status;
+}
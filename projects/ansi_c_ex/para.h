@@ -0,0 +1,64 @@
+/*
+  PARA integrates X' = F(T,X) over [T0,T1] by Parareal, so the time loop
+  can use several threads:
+
+    p = para_create ( f, n, t0, t1, x0, nslice, nfine, data );
+    p->ncoarse = 4;               coarse RK4 steps per slice
+    p->nthread = 8;
+    para_run ( p );               X(T1) is in p->u + nslice * n
+    para_free ( p );
+
+  [T0,T1] is cut into NSLICE slices.  The fine propagator F is NFINE RK4
+  steps over a slice, the accuracy wanted; the coarse propagator G is
+  NCOARSE RK4 steps, cheap but rough.  After one serial coarse sweep for
+  the starting values U(J), each iteration
+
+    runs F from every U(J) at once, one slice per pool task;
+    sweeps once through the slices, serially, with the correction
+
+      U(J+1) = F ( U(J) ) + G ( new U(J) ) - G ( old U(J) ).
+
+  After K iterations the first K slices are exact, so at most NSLICE
+  iterations give the serial fine solution; the point is that for
+  problems where G is good, far fewer do.  The iterations stop when no
+  U(J) changed by more than TOL * ( 1 + |U(J)| ), and P->DEFECT[K-1]
+  keeps that change for iteration K so convergence can be followed.
+
+  The fine work grows with the number of iterations, so with P threads
+  and K iterations the best speedup over the serial fine run is about
+  P / K, less the coarse sweeps.
+*/
+# ifndef PARA_H
+# define PARA_H
+
+# include "ode.h"
+
+typedef struct
+{
+  ode_rhs *f;
+  void *data;
+  int n;
+  double t0;
+  double t1;
+  int nslice;
+  int nfine;
+  int ncoarse;
+  int nthread;
+  double tol;
+  int maxiter;
+  double *u;
+  double *gold;
+  double *fine;
+  double *work;
+  double *defect;
+  int iter;
+  int first;
+  long nfev;
+} para;
+
+para *para_create ( ode_rhs *f, int n, double t0, double t1, double x0[],
+  int nslice, int nfine, void *data );
+void para_free ( para *p );
+int para_run ( para *p );
+
+# endif
@@ -0,0 +1,498 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <string.h>
+# include <signal.h>
+# include <unistd.h>
+
+# include "plot.h"
+
+static int plot_find ( plot *p, char *name );
+static void plot_forget ( plot *p, char *name );
+static unsigned long long plot_hash ( unsigned long long h, void *b,
+  size_t len );
+static void plot_store ( plot *p, char *name, unsigned long long hash );
+
+/******************************************************************************/
+
+int plot_close ( plot *p )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PLOT_CLOSE ends gnuplot and saves the cache.
+
+  Discussion:
+
+    The cache is written to a temporary file and renamed over the old
+    one, so an interrupted run leaves the old cache intact.  It is not
+    written at all after an error, when the plots may not have been
+    drawn.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, plot *P, the channel.
+
+    Output, int PLOT_CLOSE, is 0, or 1 if anything could not be sent to
+    gnuplot or the cache could not be saved.
+*/
+{
+  FILE *fp;
+  int i;
+  int status;
+  char *tmpname;
+
+  fputs ( "quit\n", p->pipe );
+  if ( pclose ( p->pipe ) != 0 )
+  {
+    p->error = 1;
+  }
+  status = p->error;
+
+  if ( p->cache != NULL && status == 0 )
+  {
+    tmpname = ( char * ) malloc ( strlen ( p->cache ) + 5 );
+    sprintf ( tmpname, "%s.tmp", p->cache );
+    fp = fopen ( tmpname, "w" );
+    if ( fp == NULL )
+    {
+      status = 1;
+    }
+    else
+    {
+      for ( i = 0; i < p->nentry; i++ )
+      {
+        fprintf ( fp, "%016llx %s\n", p->hash[i], p->name[i] );
+      }
+      if ( fclose ( fp ) != 0 || rename ( tmpname, p->cache ) != 0 )
+      {
+        status = 1;
+      }
+    }
+    free ( tmpname );
+  }
+  free ( p->cache );
+
+  for ( i = 0; i < p->nentry; i++ )
+  {
+    free ( p->name[i] );
+  }
+  free ( p->name );
+  free ( p->hash );
+  free ( p );
+
+  return status;
+}
+/******************************************************************************/
+
+int plot_cmd ( plot *p, char *command )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PLOT_CMD sends one command to gnuplot.
+
+  Discussion:
+
+    The command becomes part of the state hashed with every later plot.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, plot *P, the channel.
+
+    Input, char *COMMAND, the command, without the newline.
+
+    Output, int PLOT_CMD, is 0, or 1 if it could not be sent.
+*/
+{
+  p->state = plot_hash ( p->state, command, strlen ( command ) + 1 );
+
+  if ( fputs ( command, p->pipe ) == EOF || fputc ( '\n', p->pipe ) == EOF )
+  {
+    p->error = 1;
+    return 1;
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+int plot_draw ( plot *p, char *output, char *command, int nrow, int ncol,
+  double data[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PLOT_DRAW draws one plot into a file, unless it is unchanged.
+
+  Discussion:
+
+    The output is closed by "set output" after the data, so the file is
+    complete once gnuplot has read the plot.
+
+    The hash is recorded only if the plot went down the pipe and no
+    error has been seen; otherwise the entry of the output is dropped,
+    so the plot is redrawn next time instead of being taken as current.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, plot *P, the channel.
+
+    Input, char *OUTPUT, the output file.
+
+    Input, char *COMMAND, the plot command, with '-' where the data go.
+
+    Input, int NROW, NCOL, the shape of the data.
+
+    Input, double DATA[NROW*NCOL], the data by rows, or NULL.
+
+    Output, int PLOT_DRAW, is 0, or 1 if COMMAND has no '-' for the
+    data or the plot could not be sent.
+*/
+{
+  char *dash;
+  unsigned long long hash;
+  int i;
+  int k;
+  size_t len;
+
+  dash = strstr ( command, "'-'" );
+  if ( data != NULL && dash == NULL )
+  {
+    return 1;
+  }
+  if ( data == NULL )
+  {
+    nrow = 0;
+    ncol = 0;
+  }
+
+  len = ( size_t ) nrow * ncol * sizeof ( double );
+  hash = plot_hash ( p->state, command, strlen ( command ) + 1 );
+  hash = plot_hash ( hash, &nrow, sizeof ( int ) );
+  hash = plot_hash ( hash, &ncol, sizeof ( int ) );
+  hash = plot_hash ( hash, data, len );
+
+  k = plot_find ( p, output );
+  if ( 0 <= k && p->hash[k] == hash && access ( output, F_OK ) == 0 )
+  {
+    p->nskip = p->nskip + 1;
+    return 0;
+  }
+/*
+  The command, with the binary format after the '-'.
+*/
+  fprintf ( p->pipe, "set output \"%s\"\n", output );
+  if ( data == NULL )
+  {
+    fprintf ( p->pipe, "%s\n", command );
+  }
+  else
+  {
+    fwrite ( command, 1, dash + 3 - command, p->pipe );
+    fprintf ( p->pipe, " binary record=%d format=\"", nrow );
+    for ( i = 0; i < ncol; i++ )
+    {
+      fputs ( "%double", p->pipe );
+    }
+    fprintf ( p->pipe, "\"%s\n", dash + 3 );
+    if ( fwrite ( data, 1, len, p->pipe ) != len )
+    {
+      p->error = 1;
+    }
+  }
+  fputs ( "set output\n", p->pipe );
+  if ( fflush ( p->pipe ) != 0 || ferror ( p->pipe ) )
+  {
+    p->error = 1;
+  }
+  if ( p->error )
+  {
+    plot_forget ( p, output );
+    return 1;
+  }
+
+  plot_store ( p, output, hash );
+  p->ndraw = p->ndraw + 1;
+  p->nbyte = p->nbyte + ( long ) len;
+
+  return 0;
+}
+/******************************************************************************/
+
+static int plot_find ( plot *p, char *name )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PLOT_FIND looks an output file up in the cache.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, plot *P, the channel.
+
+    Input, char *NAME, the output file.
+
+    Output, int PLOT_FIND, its entry, or -1.
+*/
+{
+  int i;
+
+  for ( i = 0; i < p->nentry; i++ )
+  {
+    if ( strcmp ( p->name[i], name ) == 0 )
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+/******************************************************************************/
+
+static void plot_forget ( plot *p, char *name )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PLOT_FORGET drops an output file from the cache.
+
+  Discussion:
+
+    The last entry takes the place of the dropped one.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, plot *P, the channel.
+
+    Input, char *NAME, the output file.
+*/
+{
+  int k;
+
+  k = plot_find ( p, name );
+  if ( k < 0 )
+  {
+    return;
+  }
+
+  free ( p->name[k] );
+  p->nentry = p->nentry - 1;
+  p->name[k] = p->name[p->nentry];
+  p->hash[k] = p->hash[p->nentry];
+
+  return;
+}
+/******************************************************************************/
+
+static unsigned long long plot_hash ( unsigned long long h, void *b,
+  size_t len )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PLOT_HASH continues a 64 bit FNV-1a hash over a block of bytes.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, unsigned long long H, the hash so far.
+
+    Input, void *B, the bytes.
+
+    Input, size_t LEN, their number.
+
+    Output, unsigned long long PLOT_HASH, the hash.
+*/
+{
+  unsigned char *c = ( unsigned char * ) b;
+  size_t i;
+
+  for ( i = 0; i < len; i++ )
+  {
+    h = ( h ^ c[i] ) * 1099511628211ULL;
+  }
+
+  return h;
+}
+/******************************************************************************/
+
+plot *plot_open ( char *command, char *cache )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PLOT_OPEN starts gnuplot.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, char *COMMAND, the command that starts gnuplot, or NULL for
+    "gnuplot".
+
+    Input, char *CACHE, the cache file, or NULL to keep the cache for
+    this run only.  A missing file is an empty cache.
+
+    Output, plot *PLOT_OPEN, the channel, or NULL if gnuplot could not be
+    started.
+*/
+{
+  FILE *fp;
+  unsigned long long hash;
+  char line[1024];
+  int n;
+  plot *p;
+
+  signal ( SIGPIPE, SIG_IGN );
+
+  p = ( plot * ) malloc ( sizeof ( plot ) );
+  p->pipe = popen ( ( command != NULL ) ? command : "gnuplot", "w" );
+  if ( p->pipe == NULL )
+  {
+    free ( p );
+    return NULL;
+  }
+  p->cache = NULL;
+  p->state = 14695981039346656037ULL;
+  p->nentry = 0;
+  p->size = 0;
+  p->name = NULL;
+  p->hash = NULL;
+  p->error = 0;
+  p->ndraw = 0;
+  p->nskip = 0;
+  p->nbyte = 0;
+
+  if ( cache == NULL )
+  {
+    return p;
+  }
+  p->cache = ( char * ) malloc ( strlen ( cache ) + 1 );
+  strcpy ( p->cache, cache );
+
+  fp = fopen ( cache, "r" );
+  if ( fp == NULL )
+  {
+    return p;
+  }
+  while ( fgets ( line, sizeof ( line ), fp ) != NULL )
+  {
+    if ( sscanf ( line, "%llx %n", &hash, &n ) != 1 )
+    {
+      continue;
+    }
+    line[strcspn ( line, "\n" )] = '\0';
+    plot_store ( p, line + n, hash );
+  }
+  fclose ( fp );
+
+  return p;
+}
+/******************************************************************************/
+
+static void plot_store ( plot *p, char *name, unsigned long long hash )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    PLOT_STORE records the hash of the last plot drawn into a file.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, plot *P, the channel.
+
+    Input, char *NAME, the output file.
+
+    Input, unsigned long long HASH, the hash.
+*/
+{
+  int k;
+
+  k = plot_find ( p, name );
+  if ( k < 0 )
+  {
+    if ( p->nentry == p->size )
+    {
+      p->size = ( p->size == 0 ) ? 64 : 2 * p->size;
+      p->name = ( char ** ) realloc ( p->name, p->size * sizeof ( char * ) );
+      p->hash = ( unsigned long long * ) realloc ( p->hash,
+        p->size * sizeof ( unsigned long long ) );
+    }
+    k = p->nentry;
+    p->name[k] = ( char * ) malloc ( strlen ( name ) + 1 );
+    strcpy ( p->name[k], name );
+    p->nentry = p->nentry + 1;
+  }
+  p->hash[k] = hash;
+
+  return;
+}
@@ -0,0 +1,53 @@
+/*
+  PLOT keeps one gnuplot process open for any number of plots, and sends
+  their data inline, in binary, instead of through text files:
+
+    p = plot_open ( NULL, "plot.cache" );
+    plot_cmd ( p, "set term png size 800,600" );
+    plot_draw ( p, "a.png", "plot '-' using 1:2 with lines", nrow, 2, xy );
+    ...
+    plot_close ( p );
+
+  PLOT_DRAW writes NROW rows of NCOL doubles, by rows, straight down the
+  pipe after the command; the first '-' of the command gets the binary
+  format, record=NROW format="%double%double...", so gnuplot reads the
+  numbers without parsing them.  The command may be any plot or splot
+  command, or have no '-' at all when DATA is NULL.
+
+  Each plot has a 64 bit FNV-1a hash of everything that decides its
+  contents: the commands sent since PLOT_OPEN, the plot command and the
+  data.  If the output file exists and its last plot had the same hash,
+  the plot is skipped.  The hashes are kept under the output names, and
+  with CACHE not NULL they are read from that file at PLOT_OPEN and
+  written back at PLOT_CLOSE, so a rerun only redraws what changed.
+
+  SIGPIPE is ignored from PLOT_OPEN on, so a gnuplot that is missing or
+  has died makes the calls return 1 instead of killing the program.
+*/
+# ifndef PLOT_H
+# define PLOT_H
+
+# include <stdio.h>
+
+typedef struct
+{
+  FILE *pipe;
+  char *cache;
+  unsigned long long state;
+  int nentry;
+  int size;
+  char **name;
+  unsigned long long *hash;
+  int error;
+  long ndraw;
+  long nskip;
+  long nbyte;
+} plot;
+
+int plot_close ( plot *p );
+int plot_cmd ( plot *p, char *command );
+int plot_draw ( plot *p, char *output, char *command, int nrow, int ncol,
+  double data[] );
+plot *plot_open ( char *command, char *cache );
+
+# endif
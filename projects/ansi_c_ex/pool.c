@@ -0,0 +1,452 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <pthread.h>
+
+# include "pool.h"
+/*
+  One share of task indices, [LO,HI).  The padding keeps shares of
+  different threads on different cache lines.
+*/
+typedef struct
+{
+  pthread_mutex_t lock;
+  int lo;
+  int hi;
+  char pad[64];
+} pool_share;
+
+typedef struct
+{
+  pool *p;
+  int thread;
+  int alive;
+} pool_arg;
+/*
+  RUN counts the runs handed out and BUSY the threads still working on
+  the current one; LOCK guards both, and QUIT.
+*/
+struct pool_state
+{
+  pthread_mutex_t lock;
+  pthread_cond_t start;
+  pthread_cond_t finish;
+  unsigned long run;
+  int busy;
+  int quit;
+  pool_share *share;
+  pool_task *task;
+  void *arg;
+  pool_arg *args;
+  pthread_t *tid;
+};
+
+static void pool_work ( pool *p, int thread );
+static void *pool_worker ( void *arg );
+
+/******************************************************************************/
+
+pool *pool_create ( int nthread )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    POOL_CREATE starts a pool of threads.
+
+  Discussion:
+
+    The calling thread will work as thread 0 of each run, and NTHREAD-1
+    more threads are started, which sleep until POOL_EXEC gives them
+    work.  If a thread cannot be started, P->NFAIL counts it, and its
+    share of each run is stolen by the others.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, int NTHREAD, the number of threads.
+
+    Output, pool *POOL_CREATE, the pool.
+*/
+{
+  int i;
+  pool *p;
+  struct pool_state *s;
+
+  if ( nthread < 1 )
+  {
+    nthread = 1;
+  }
+
+  p = ( pool * ) malloc ( sizeof ( pool ) );
+  s = ( struct pool_state * ) malloc ( sizeof ( struct pool_state ) );
+  p->nthread = nthread;
+  p->nfail = 0;
+  p->state = s;
+
+  pthread_mutex_init ( &s->lock, NULL );
+  pthread_cond_init ( &s->start, NULL );
+  pthread_cond_init ( &s->finish, NULL );
+  s->run = 0;
+  s->busy = 0;
+  s->quit = 0;
+  s->task = NULL;
+  s->arg = NULL;
+  s->share = ( pool_share * ) malloc ( nthread * sizeof ( pool_share ) );
+  s->args = ( pool_arg * ) malloc ( nthread * sizeof ( pool_arg ) );
+  s->tid = ( pthread_t * ) malloc ( nthread * sizeof ( pthread_t ) );
+
+  for ( i = 0; i < nthread; i++ )
+  {
+    pthread_mutex_init ( &s->share[i].lock, NULL );
+    s->share[i].lo = 0;
+    s->share[i].hi = 0;
+    s->args[i].p = p;
+    s->args[i].thread = i;
+    s->args[i].alive = ( i == 0 );
+  }
+
+  for ( i = 1; i < nthread; i++ )
+  {
+    if ( pthread_create ( &s->tid[i], NULL, pool_worker, &s->args[i] ) == 0 )
+    {
+      s->args[i].alive = 1;
+    }
+    else
+    {
+      p->nfail = p->nfail + 1;
+    }
+  }
+
+  return p;
+}
+/******************************************************************************/
+
+int pool_exec ( pool *p, int ntask, pool_task *task, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    POOL_EXEC runs NTASK tasks on the threads of a pool.
+
+  Discussion:
+
+    The calling thread works as thread 0.  POOL_EXEC returns when all
+    tasks are finished, and the other threads go back to sleep.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, pool *P, the pool.
+
+    Input, int NTASK, the number of tasks.
+
+    Input, pool_task *TASK, the task routine.
+
+    Input, void *ARG, passed to TASK.
+
+    Output, int POOL_EXEC, the number of threads that could not be
+    started, normally 0.
+*/
+{
+  int i;
+  int nthread = p->nthread;
+  struct pool_state *s = p->state;
+
+  for ( i = 0; i < nthread; i++ )
+  {
+    s->share[i].lo = ( int ) ( ( ( long ) ntask * i ) / nthread );
+    s->share[i].hi = ( int ) ( ( ( long ) ntask * ( i + 1 ) ) / nthread );
+  }
+  s->task = task;
+  s->arg = arg;
+
+  if ( 1 < nthread - p->nfail )
+  {
+    pthread_mutex_lock ( &s->lock );
+    s->run = s->run + 1;
+    s->busy = nthread - 1 - p->nfail;
+    pthread_cond_broadcast ( &s->start );
+    pthread_mutex_unlock ( &s->lock );
+  }
+
+  pool_work ( p, 0 );
+
+  pthread_mutex_lock ( &s->lock );
+  while ( 0 < s->busy )
+  {
+    pthread_cond_wait ( &s->finish, &s->lock );
+  }
+  pthread_mutex_unlock ( &s->lock );
+
+  return p->nfail;
+}
+/******************************************************************************/
+
+void pool_free ( pool *p )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    POOL_FREE stops the threads of a pool and frees it.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, pool *P, the pool.
+*/
+{
+  int i;
+  struct pool_state *s = p->state;
+
+  pthread_mutex_lock ( &s->lock );
+  s->quit = 1;
+  pthread_cond_broadcast ( &s->start );
+  pthread_mutex_unlock ( &s->lock );
+
+  for ( i = 1; i < p->nthread; i++ )
+  {
+    if ( s->args[i].alive )
+    {
+      pthread_join ( s->tid[i], NULL );
+    }
+  }
+
+  for ( i = 0; i < p->nthread; i++ )
+  {
+    pthread_mutex_destroy ( &s->share[i].lock );
+  }
+  pthread_cond_destroy ( &s->finish );
+  pthread_cond_destroy ( &s->start );
+  pthread_mutex_destroy ( &s->lock );
+  free ( s->share );
+  free ( s->args );
+  free ( s->tid );
+  free ( s );
+  free ( p );
+
+  return;
+}
+/******************************************************************************/
+
+int pool_run ( int nthread, int ntask, pool_task *task, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    POOL_RUN runs NTASK tasks on NTHREAD threads with work stealing.
+
+  Discussion:
+
+    The threads are started for this one run and stopped after it.
+    Callers that run tasks repeatedly should keep a pool from
+    POOL_CREATE instead, since starting and joining the threads can
+    cost more than a short run.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, int NTHREAD, the number of threads.
+
+    Input, int NTASK, the number of tasks.
+
+    Input, pool_task *TASK, the task routine.
+
+    Input, void *ARG, passed to TASK.
+
+    Output, int POOL_RUN, the number of threads that could not be
+    started, normally 0.
+*/
+{
+  int failed;
+  pool *p;
+
+  p = pool_create ( nthread );
+  failed = pool_exec ( p, ntask, task, arg );
+  pool_free ( p );
+
+  return failed;
+}
+/******************************************************************************/
+
+static void pool_work ( pool *p, int thread )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    POOL_WORK runs tasks of the current run until none is left.
+
+  Discussion:
+
+    The thread takes tasks one at a time from the front of its own
+    share.  When the share is empty it visits the other threads in turn
+    and takes the back half of the first nonempty share it finds.  When
+    every share is empty, no task is left to start and the thread quits.
+
+    A thread never holds two locks at once.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, pool *P, the pool.
+
+    Input, int THREAD, the calling thread.
+*/
+{
+  int hi;
+  int i;
+  int lo;
+  pool_share *mine;
+  int nthread = p->nthread;
+  struct pool_state *ps = p->state;
+  pool_share *s;
+  int v;
+
+  mine = &ps->share[thread];
+
+  for ( ; ; )
+  {
+    pthread_mutex_lock ( &mine->lock );
+    if ( mine->lo < mine->hi )
+    {
+      i = mine->lo;
+      mine->lo = mine->lo + 1;
+      pthread_mutex_unlock ( &mine->lock );
+      ps->task ( i, thread, ps->arg );
+      continue;
+    }
+    pthread_mutex_unlock ( &mine->lock );
+
+    lo = 0;
+    hi = 0;
+    for ( v = 1; v < nthread && lo == hi; v++ )
+    {
+      s = &ps->share[( thread + v ) % nthread];
+      pthread_mutex_lock ( &s->lock );
+      if ( s->lo < s->hi )
+      {
+        hi = s->hi;
+        lo = s->hi - ( s->hi - s->lo + 1 ) / 2;
+        s->hi = lo;
+      }
+      pthread_mutex_unlock ( &s->lock );
+    }
+
+    if ( lo == hi )
+    {
+      break;
+    }
+
+    pthread_mutex_lock ( &mine->lock );
+    mine->lo = lo;
+    mine->hi = hi;
+    pthread_mutex_unlock ( &mine->lock );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void *pool_worker ( void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    POOL_WORKER is the loop run by each started thread of a pool.
+
+  Discussion:
+
+    The thread sleeps until POOL_EXEC hands out a new run, works on it
+    with POOL_WORK, reports that it is done, and sleeps again, until
+    POOL_FREE tells it to quit.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, void *ARG, a pool_arg giving the pool and the thread number.
+*/
+{
+  pool_arg *a = ( pool_arg * ) arg;
+  struct pool_state *s = a->p->state;
+  unsigned long seen;
+
+/*
+  The pool was created with RUN at 0, and a run may be handed out before
+  this thread first takes the lock.
+*/
+  seen = 0;
+  pthread_mutex_lock ( &s->lock );
+
+  for ( ; ; )
+  {
+    while ( s->run == seen && !s->quit )
+    {
+      pthread_cond_wait ( &s->start, &s->lock );
+    }
+    if ( s->quit )
+    {
+      break;
+    }
+    seen = s->run;
+    pthread_mutex_unlock ( &s->lock );
+
+    pool_work ( a->p, a->thread );
+
+    pthread_mutex_lock ( &s->lock );
+    s->busy = s->busy - 1;
+    if ( s->busy == 0 )
+    {
+      pthread_cond_signal ( &s->finish );
+    }
+  }
+
+  pthread_mutex_unlock ( &s->lock );
+
+  return NULL;
+}
@@ -0,0 +1,41 @@
+/*
+  POOL runs independent tasks 0 to NTASK-1 on a set of threads.
+
+  Each thread starts with a contiguous share of the task indices and
+  works through it from the front.  A thread whose share runs out
+  steals the back half of another thread's remaining share, so uneven
+  task costs are evened out without a central queue.
+
+  The task routine is called as TASK ( I, THREAD, ARG ), where THREAD,
+  between 0 and NTHREAD-1, identifies the calling thread, so each
+  thread can keep its own output buffer without locking.
+
+  A caller that runs tasks over and over keeps the threads alive
+  between the runs:
+
+    p = pool_create ( nthread );
+    pool_exec ( p, ntask, task, arg );     as often as needed
+    pool_free ( p );
+
+  The idle threads sleep on a condition variable, so a run costs a
+  wakeup instead of a thread start.  POOL_RUN does all three steps for
+  a single run.
+*/
+# ifndef POOL_H
+# define POOL_H
+
+typedef void pool_task ( int i, int thread, void *arg );
+
+typedef struct
+{
+  int nthread;
+  int nfail;
+  struct pool_state *state;
+} pool;
+
+pool *pool_create ( int nthread );
+int pool_exec ( pool *p, int ntask, pool_task *task, void *arg );
+void pool_free ( pool *p );
+int pool_run ( int nthread, int ntask, pool_task *task, void *arg );
+
+# endif
@@ -1,21 +1,374 @@
+// build: gcc -O3 -o rk4 rk4.c abm.c ckpt.c erk.c event.c fit.c lti.c ode.c para.c plot.c pool.c sde.c sens.c sink.c stiff.c symp.c traj.c -lm -lpthread
+//        add -fopenmp to split the stage loops of large systems among threads
+// rk4            fixed step RK4, num_of_data steps
+// rk4 -rk45 tol  adaptive Dormand-Prince 5(4) with atol = rtol = tol
+// rk4 -events tol
+//                adaptive Dormand-Prince with the upward zero crossings of x
+//                located inside the steps; osc.dat gets each crossing and the
+//                period ending there; stops when the energy is down to 1%
+// rk4 -abm tol [pec]
+//                variable step, variable order Adams-Bashforth-Moulton with
+//                atol = rtol = tol, 2 rhs evaluations per step, or 1 with pec;
+//                osc.dat gets one row per accepted step
+// rk4 -ensemble count
+//                count oscillators with damping b from 0 to 0.4, stepped
+//                together by rk4_ensemble; osc.dat gets the mean displacement
+// rk4 -sweep count threads [prefix]
+//                the same sweep as count separate trajectories, each with its
+//                own ode_ctx, spread over threads by pool_run; thread i keeps
+//                its rows in its own sink, prefix.i.bin if prefix is given,
+//                else a summary; osc.dat gets b and the final displacement
+// rk4 -parareal slices threads [periods]
+//                a long run, 1000 periods by default, of the oscillator with
+//                b = 0.002: 1000 RK4 steps per period serially, then the
+//                same steps as the fine propagator of Parareal over slices
+//                time slices on threads threads, with a coarse step 20 times
+//                longer, to a change of 1e-8; prints the change per
+//                iteration, the difference from the serial run and the
+//                speedup; osc.dat gets the Parareal solution at the ends of
+//                the slices
+// rk4 -sens      the fixed step run with the sensitivities of x and v to k, b,
+//                m and the two starting values carried in the same RK4 stages,
+//                checked against central differences of whole runs; osc.dat
+//                gets t, x, dx/dk, dx/db and dx/dm
+// rk4 -fit file [starts] [threads]
+//                estimate k and b (m = 1) from the t, x columns of file, such
+//                as the osc.dat of a plain run, by Levenberg-Marquardt from
+//                starts starting points, 8 by default, spread over threads;
+//                prints the estimates with their standard errors and
+//                correlation; osc.dat gets t, the data and the fitted model
+// rk4 -sde em|milstein|srk [paths] [threads] [substeps]
+//                the oscillator with a noisy force that also grows with the
+//                velocity, dv = -(k x + b v)/m dt + (0.1 + 0.2 v) dW, as an
+//                ensemble of paths, 100000 by default, on threads threads,
+//                with substeps steps, 10 by default, per step of the RK4 run;
+//                only the mean and variance are kept, and checked against
+//                the exact moment equations; osc.dat gets t, the mean and
+//                standard deviation of x, and the exact ones
+// rk4 -bdf b, rk4 -rosw b
+//                the oscillator with damping b (stiff when b is large) by
+//                variable order BDF or Rosenbrock-W, tolerance 1e-6, over
+//                t = 0 to 30 b; osc.dat gets one row per accepted step
+// rk4 -verlet|-yoshida4|-yoshida6|-rkn4 [periods] [steps per period] [b]
+//                long runs of the oscillator as x'' = -k/m x, by default
+//                10000 periods of 20 steps with b = 0; osc.dat gets t, x
+//                and the energy at the end of each period
+// rk4 -erk heun|rk3|rk4|rk38
+//                the fixed step run with a method from a Butcher tableau
+// rk4 -lti [force]
+//                the oscillator, with a constant force if given, as the
+//                linear system x' = A x + g stepped by the exact propagator
+//                exp(A step): one matrix-vector product per step
+// rk4 -expv masses
+//                the chain below, propagated step by step by exp(A step) x
+//                from Krylov subspaces, A only used through the chain's rhs
+// rk4 -chain masses
+//                a chain of masses joined by springs between fixed ends,
+//                2*masses equations, started in its slowest mode and stepped
+//                by rk4_step for t = 0 to 30; osc.dat gets the displacement
+//                of the middle mass
+// ... -ckpt file every
+//                added to -chain, -expv, -sweep, -rk45 or -events: checkpoint
+//                to file every that many steps (trajectories for -sweep,
+//                accepted steps for -rk45, crossings for -events), in the
+//                background, the adaptive runs with their step size control;
+//                a run started with a checkpoint present resumes from it and
+//                ends with the same results, bit for bit, as one that was
+//                never stopped; the file is removed when the run ends
+// rk4 -traj file the fixed step run, every step written to file as a chunked
+//                binary trajectory (t, x, v) instead of printed, by a writer
+//                thread so the steps never wait for the disk
+// rk4 -read file t0 t1
+//                print the rows of such a file with t0 <= t < t1, read in
+//                place from a memory map
+// every mode ends by plotting the first two columns of osc.dat into
+// c_rk_4.png, skipped when the plot is the same as the one in
+// rk4.plotcache and c_rk_4.png is still there
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "abm.h"
+#include "ckpt.h"
+#include "erk.h"
+#include "event.h"
+#include "fit.h"
+#include "lti.h"
+#include "ode.h"
+#include "para.h"
+#include "plot.h"
+#include "pool.h"
+#include "sde.h"
+#include "sens.h"
+#include "stiff.h"
+#include "symp.h"
+#include "traj.h"
 
 #define problem_order 2
 
-double x_prime(double x1[], double tt, int i);
-double integrate(double x[], double tt, int i);
-double t, step;
+// parameters of the ensemble, one entry per oscillator: m x'' + b x' + k x = 0
+typedef struct {
+  double *k, *b, *m;
+} osc_param;
+
+// a chain of count masses m joined by springs k, each with damping b
+typedef struct {
+  int count;
+  double k, b, m;
+} chain_param;
 
-// 資料檔案存檔用
-FILE *output;
-// 利用 pipe 呼叫 gnuplot 繪圖
-FILE *pipe;
+// one parameter sweep: trajectory i has k, b, m = kbm[3*i..3*i+2]
+typedef struct {
+  double initial_time, final_time, step;
+  double x0[problem_order];
+  double *kbm;
+  double *final;
+  sink **out;
+  // progress: done[i] once trajectory i is in final, both under lock
+  int count;
+  unsigned char *done;
+  long ndone;
+  pthread_mutex_t lock;
+  ckpt *ck;
+  long every;
+} sweep_job;
 
-int main(){
-  double initial_time, final_time;
+void x_prime(double tt, double x[], double xp[], void *data);
+void x_accel(double tt, double q[], double a[], void *data);
+void x_prime_ensemble(double tt, int first, int count, int ld, double x[], double xp[], void *data);
+void x_prime_chain(double tt, double x[], double xp[], void *data);
+void sweep_task(int i, int thread, void *arg);
+void osc_events(double tt, double x[], double g[], void *data);
+void x_jvp(double tt, double x[], double v[], int j, double jv[], void *data);
+void x_prime_sde(double tt, int first, int count, int ld, double x[], double xp[], void *data);
+void x_diff_sde(double tt, int first, int count, int ld, double x[], double g[], double dg[], void *data);
+void x_moments(double tt, double y[], double yp[], void *data);
+
+int main(int argc, char *argv[]){
+  double initial_time, final_time, t, step;
+  // 資料檔案存檔用
+  FILE *output;
+  // 利用 pipe 呼叫 gnuplot 繪圖
+  plot *gp;
+  int nplot;
+  double *tplot, *yplot, *xyplot;
   int num_of_data, j;
-  double x[problem_order];
-  output=fopen("osc.dat", "w");
+  double *tgrid, *xgrid;
+  // the state is sized at run time, aligned, from an arena
+  int n = problem_order;
+  ode_arena *arena;
+  double *x, *wc;
+  chain_param chain = {0, 1, 0, 1};
+  // fixed step methods from a tableau, and their stage counts
+  const char *erk_names[4] = {"heun", "rk3", "rk4", "rk38"};
+  void (*erk_steps[4])(ode_rhs *, int, double, double, double *, double *, void *) = {erk_heun_step, erk_rk3_step, erk_rk4_step, erk_rk38_step};
+  int erk_stages[4] = {2, 3, 4, 4};
+  int erk = -1;
+  int lin = 0;
+  double a[problem_order*problem_order], g[problem_order] = {0, 0}, err;
+  lti *lp;
+  abm *ab;
+  int abm_mode = 0;
+  ode_ctx *c;
+  double tol = 0;
+  long nfev;
+  dopri *d;
+  int count = 0;
+  double *xe, *we, mean;
+  osc_param p;
+  int threads = 0;
+  char *prefix = NULL, name[256];
+  char *names[problem_order+2] = {"id", "t", "x", "v"};
+  sweep_job job;
+  int method = -1;
+  double kbm[3] = {1, 0.2, 1};
+  stiff *st;
+  int smethod = -1;
+  long periods = 10000, steps = 20, i;
+  double energy;
+  symp *sy;
+  char *trajname = NULL;
+  char *tnames[problem_order+1] = {"t", "x", "v"};
+  double row[problem_order+1], *rp;
+  sink *ts;
+  traj *tr;
+  long r, r1, run;
+  int events = 0, ev, rk45 = 0;
+  event *e;
+  double tcross, estop, es[3];
+  long el[5];
+  char *ckname = NULL;
+  long ckevery = 0, i0, off;
+  ckpt *ck = NULL;
+  int resume = 0, sweep = 0;
+  int slices = 0, nfine;
+  para *pr;
+  double xs[problem_order], tserial, tpara;
+  struct timespec c0, c1;
+  int sensitivity = 0;
+  // sensitivities to k, b, m, x0 and v0
+  int sparam[5] = {0, 1, 2, SENS_X0(0), SENS_X0(1)};
+  const char *snames[5] = {"k", "b", "m", "x0", "v0"};
+  sens *se, *sp;
+  double kbm2[3], delta, fd[5*problem_order];
+  char *fitname = NULL;
+  int nstart = 0, mobs = 0, fitstatus;
+  // k and b are fitted, m stays fixed
+  int fitwhich[2] = {0, 1};
+  double *tobs = NULL, *yobs = NULL, *starts;
+  fit *ft;
+  int sdemethod = 0;
+  long npath = 0;
+  // k, b, m and the noise 0.1 + 0.2 v
+  double sdep[5] = {1, 0.2, 1, 0.1, 0.2};
+  double mom[5], wm[20];
+  sde *sd;
+  for(j = 2; j+2 < argc; j++){
+    if(strcmp(argv[j], "-ckpt") == 0){
+      ckname = argv[j+1];
+      ckevery = atol(argv[j+2]);
+    }
+  }
+  if(argc > 4 && strcmp(argv[1], "-read") == 0){
+    // nothing is integrated: look the rows up and print them
+    tr = traj_open(argv[2]);
+    if(tr == NULL) return 1;
+    r = traj_find(tr, atof(argv[3]));
+    r1 = traj_find(tr, atof(argv[4]));
+    if(r < 0){
+      fprintf(stderr, "%s has no time column\n", argv[2]);
+      traj_close(tr);
+      return 1;
+    }
+    for(j = 0; j < tr->ncol; j++) printf("%s%s", tr->names[j], (j+1 < tr->ncol) ? "\t" : "\n");
+    // each call hands back a whole run of contiguous rows
+    while(r < r1){
+      rp = traj_row(tr, r, &run);
+      for(; run > 0 && r < r1; run--, r++, rp += tr->ncol){
+        for(j = 0; j < tr->ncol; j++) printf("%.17g%s", rp[j], (j+1 < tr->ncol) ? "\t" : "\n");
+      }
+    }
+    fprintf(stderr, "%ld rows in %ld chunks\n", tr->nrow, tr->nchunk);
+    traj_close(tr);
+    return 0;
+  }
+  if(argc > 2 && strcmp(argv[1], "-traj") == 0){
+    trajname = argv[2];
+  }
+  if(argc > 1 && strcmp(argv[1], "-rk45") == 0){
+    tol = (argc > 2) ? atof(argv[2]) : 1e-6;
+    rk45 = 1;
+  }
+  if(argc > 1 && strcmp(argv[1], "-events") == 0){
+    tol = (argc > 2) ? atof(argv[2]) : 1e-6;
+    events = 1;
+  }
+  if(argc > 1 && strcmp(argv[1], "-parareal") == 0){
+    slices = (argc > 2) ? atoi(argv[2]) : 32;
+    threads = (argc > 3) ? atoi(argv[3]) : 1;
+    periods = (argc > 4) ? atol(argv[4]) : 1000;
+  }
+  if(argc > 1 && strcmp(argv[1], "-sens") == 0){
+    sensitivity = 1;
+  }
+  if(argc > 2 && strcmp(argv[1], "-sde") == 0){
+    if(strcmp(argv[2], "em") == 0) sdemethod = SDE_EM;
+    if(strcmp(argv[2], "milstein") == 0) sdemethod = SDE_MILSTEIN;
+    if(strcmp(argv[2], "srk") == 0) sdemethod = SDE_SRK;
+    if(sdemethod == 0){
+      fprintf(stderr, "unknown method %s\n", argv[2]);
+      return 1;
+    }
+    npath = (argc > 3) ? atol(argv[3]) : 100000;
+    threads = (argc > 4) ? atoi(argv[4]) : 1;
+    steps = (argc > 5) ? atol(argv[5]) : 10;
+    if(npath < 2) npath = 2;
+    if(steps < 1) steps = 1;
+  }
+  if(argc > 2 && strcmp(argv[1], "-fit") == 0){
+    fitname = argv[2];
+    nstart = (argc > 3) ? atoi(argv[3]) : 8;
+    threads = (argc > 4) ? atoi(argv[4]) : 1;
+    if(nstart < 1) nstart = 1;
+    // read before osc.dat is opened for writing: it may be the data
+    if(fit_read(fitname, &mobs, &tobs, &yobs) != 0){
+      fprintf(stderr, "no data in %s\n", fitname);
+      return 1;
+    }
+  }
+  if(argc > 1 && strcmp(argv[1], "-abm") == 0){
+    tol = (argc > 2) ? atof(argv[2]) : 1e-6;
+    abm_mode = (argc > 3 && strcmp(argv[3], "pec") == 0) ? ABM_PEC : ABM_PECE;
+  }
+  if(argc > 1 && strcmp(argv[1], "-ensemble") == 0){
+    count = (argc > 2) ? atoi(argv[2]) : 100000;
+  }
+  if(argc > 1 && (strcmp(argv[1], "-bdf") == 0 || strcmp(argv[1], "-rosw") == 0)){
+    method = (strcmp(argv[1], "-bdf") == 0) ? STIFF_BDF : STIFF_ROSW;
+    kbm[1] = (argc > 2) ? atof(argv[2]) : 1000;
+  }
+  if(argc > 1){
+    if(strcmp(argv[1], "-verlet") == 0) smethod = SYMP_VERLET;
+    if(strcmp(argv[1], "-yoshida4") == 0) smethod = SYMP_YOSHIDA4;
+    if(strcmp(argv[1], "-yoshida6") == 0) smethod = SYMP_YOSHIDA6;
+    if(strcmp(argv[1], "-rkn4") == 0) smethod = SYMP_RKN4;
+  }
+  if(smethod >= 0){
+    periods = (argc > 2) ? atol(argv[2]) : 10000;
+    steps = (argc > 3) ? atol(argv[3]) : 20;
+    kbm[1] = (argc > 4) ? atof(argv[4]) : 0;
+  }
+  if(argc > 1 && strcmp(argv[1], "-sweep") == 0){
+    sweep = 1;
+    count = (argc > 2) ? atoi(argv[2]) : 100000;
+    threads = (argc > 3) ? atoi(argv[3]) : 1;
+    prefix = (argc > 4) ? argv[4] : NULL;
+  }
+  if(argc > 1 && strcmp(argv[1], "-lti") == 0){
+    lin = 1;
+    g[1] = (argc > 2) ? atof(argv[2]) : 0;
+  }
+  if(argc > 1 && strcmp(argv[1], "-expv") == 0){
+    lin = 2;
+    chain.count = (argc > 2) ? atoi(argv[2]) : 100000;
+    n = 2*chain.count;
+  }
+  if(argc > 1 && strcmp(argv[1], "-chain") == 0){
+    chain.count = (argc > 2) ? atoi(argv[2]) : 100000;
+    n = 2*chain.count;
+  }
+  if(argc > 2 && strcmp(argv[1], "-erk") == 0){
+    for(j = 0; j < 4; j++){
+      if(strcmp(argv[2], erk_names[j]) == 0) erk = j;
+    }
+    if(erk < 0){
+      fprintf(stderr, "unknown method %s\n", argv[2]);
+      return 1;
+    }
+  }
+  arena = ode_arena_create(n, 6);
+  if(arena == NULL){
+    fprintf(stderr, "out of memory for %d equations\n", n);
+    return 1;
+  }
+  x = ode_arena_alloc(arena, n);
+  // room for the stages of any of the methods
+  wc = ode_arena_alloc(arena, 5*n);
+  // only the modes that save checkpoints load one; -sde and -fit also
+  // set threads, and must leave a file of that name alone
+  if(ckname != NULL && ckevery > 0 && (chain.count > 0 || sweep || rk45 || events)){
+    ck = ckpt_create(ckname);
+    resume = (ckpt_load(ck) == 0);
+  }
+  // a resumed chain or events run goes on writing the osc.dat of the run
+  // it resumes
+  output = NULL;
+  if(resume && (chain.count > 0 || events)) output = fopen("osc.dat", "r+");
+  if(output == NULL) output=fopen("osc.dat", "w");
   // initial setup
   initial_time = 0;
   final_time = 30;
@@ -26,92 +379,715 @@ int main(){
   x[0] = 1;
   x[1] = 0;
   // x[2] = 0.1;
-  for(t = initial_time; t < final_time; t+=step){
-    printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f\n", t, x[0], x[1]);
-    for(j =0; j < problem_order; j++){
-      x[j] = integrate(x, t, j);
+  if(lin == 1){
+    // x_prime is x' = A x: column j of A is x_prime of the unit vector e_j
+    for(j = 0; j < problem_order; j++){
+      for(i = 0; i < problem_order; i++) wc[i] = (i == j);
+      x_prime(t, wc, a + j*problem_order, NULL);
+    }
+    lp = lti_create(problem_order, a, g, step, initial_time, x);
+    while(lp->t < final_time - step/2){
+      printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f\n", lp->t, lp->x[0], lp->x[1]);
+      fprintf(output, "%f\t%f\n", lp->t, lp->x[0]);
+      lti_step(lp);
+    }
+    printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f\n", lp->t, lp->x[0], lp->x[1]);
+    fprintf(output, "%f\t%f\n", lp->t, lp->x[0]);
+    printf("matrix-vector products = %ld\n", lp->nstep);
+    lti_free(lp);
+  }
+  else if(chain.count > 0){
+    // slowest mode: x_i = sin(pi (i+1)/(count+1)), at rest
+    for(j = 0; j < chain.count; j++){
+      x[j] = sin(3.14159265358979323846*(j+1)/(chain.count+1));
+      x[chain.count+j] = 0;
+    }
+    nfev = 0;
+    i0 = 0;
+    if(resume && (ckpt_get(ck, "i", &i0, sizeof(long)) != 0 || ckpt_get(ck, "x", x, n*sizeof(double)) != 0)){
+      fprintf(stderr, "%s is not a checkpoint of this run, starting over\n", ckname);
+      i0 = 0;
+      resume = 0;
+    }
+    if(i0 > 0){
+      ckpt_get(ck, "nfev", &nfev, sizeof(long));
+      ckpt_get(ck, "osc.dat", &off, sizeof(long));
+      // drop the rows written after the checkpoint
+      fflush(output);
+      if(ftruncate(fileno(output), off) != 0) fprintf(stderr, "cannot truncate osc.dat\n");
+      fseek(output, 0, SEEK_END);
+      t = initial_time + i0*step;
+      printf("resumed at step %ld, t = %g\n", i0, t);
+    }
+    for(i = i0; i < num_of_data; i++){
+      if(ck != NULL && i > i0 && i % ckevery == 0){
+        // all the run depends on: the step, the state, the counter and
+        // how much of osc.dat is written
+        fflush(output);
+        off = ftell(output);
+        ckpt_begin(ck);
+        ckpt_put(ck, "i", &i, sizeof(long));
+        ckpt_put(ck, "x", x, n*sizeof(double));
+        ckpt_put(ck, "nfev", &nfev, sizeof(long));
+        ckpt_put(ck, "osc.dat", &off, sizeof(long));
+        if(ckpt_commit(ck) != 0) fprintf(stderr, "writing %s failed\n", ckname);
+      }
+      fprintf(output, "%f\t%f\n", t, x[chain.count/2]);
+      if(lin == 2){
+        if(lti_expv(x_prime_chain, n, step, x, x, 10, 1e-10, &nfev, &chain) != 0){
+          fprintf(stderr, "expv failed at t = %g\n", t);
+          break;
+        }
+      }
+      else{
+        rk4_step(x_prime_chain, n, t, step, x, wc, &chain);
+        nfev += 4;
+      }
+      t = initial_time + (i+1)*step;
+    }
+    fprintf(output, "%f\t%f\n", t, x[chain.count/2]);
+    // the slowest mode only changes its amplitude, by cos(w t)
+    err = 0;
+    for(j = 0; j < chain.count; j++){
+      err = fmax(err, fabs(x[j] - sin(3.14159265358979323846*(j+1)/(chain.count+1))*cos(2*sin(3.14159265358979323846/(2*(chain.count+1)))*t)));
     }
+    printf("%d masses, time = %-5.5f, middle displacement = %-5.5f, error = %.2e\n", chain.count, t, x[chain.count/2], err);
+    printf("%s = %ld\n", (lin == 2) ? "matrix-vector products" : "rhs evaluations", nfev);
+  }
+  else if(erk >= 0){
+    nfev = 0;
+    for(i = 0; i < num_of_data; i++){
+      printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f\n", t, x[0], x[1]);
+      fprintf(output, "%f\t%f\n", t, x[0]);
+      erk_steps[erk](x_prime, n, t, step, x, wc, NULL);
+      nfev += erk_stages[erk];
+      t = initial_time + (i+1)*step;
+    }
+    printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f\n", t, x[0], x[1]);
     fprintf(output, "%f\t%f\n", t, x[0]);
+    printf("rhs evaluations = %ld\n", nfev);
+  }
+  else if(smethod >= 0){
+    // x'' = -k/m x with the damping b/m applied by the integrator
+    sy = symp_create(smethod, x_accel, 1, initial_time, &x[0], &x[1], kbm);
+    sy->gamma = kbm[1]/kbm[2];
+    step = 2*3.14159265358979323846*sqrt(kbm[2]/kbm[0])/steps;
+    for(i = 0; i < periods*steps; i++){
+      symp_step(sy, step);
+      if((i+1) % steps == 0){
+        energy = 0.5*kbm[2]*sy->v[0]*sy->v[0] + 0.5*kbm[0]*sy->q[0]*sy->q[0];
+        fprintf(output, "%f\t%f\t%.10e\n", sy->t, sy->q[0], energy);
+      }
+    }
+    energy = 0.5*kbm[2]*sy->v[0]*sy->v[0] + 0.5*kbm[0]*sy->q[0]*sy->q[0];
+    printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f, energy = %.10f\n", sy->t, sy->q[0], sy->v[0], energy);
+    printf("force evaluations = %ld\n", sy->nfev);
+    symp_free(sy);
+  }
+  else if(method >= 0){
+    // the slow mode decays like exp(-k t/b), so run over 30 b
+    st = stiff_create(method, x_prime, NULL, problem_order, STIFF_DENSE, 0, 0, initial_time, x, 1e-6, 1e-6, kbm);
+    fprintf(output, "%f\t%f\n", st->t, st->x[0]);
+    while(st->t < final_time*kbm[1]){
+      if(stiff_step(st, final_time*kbm[1]) != 0){
+        fprintf(stderr, "step size underflow at t = %g\n", st->t);
+        break;
+      }
+      fprintf(output, "%f\t%f\n", st->t, st->x[0]);
+    }
+    printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f\n", st->t, st->x[0], st->x[1]);
+    printf("steps = %ld, rejected = %ld, rhs evaluations = %ld, jacobians = %ld, factorizations = %ld\n", st->naccept, st->nreject, st->nfev, st->njev, st->nlu);
+    stiff_free(st);
+  }
+  else if(sensitivity){
+    se = sens_create(x_prime, x_jvp, problem_order, 5, sparam, initial_time, x, kbm);
+    for(i = 0; i < num_of_data; i++){
+      fprintf(output, "%f\t%f\t%f\t%f\t%f\n", se->t, se->y[0], se->y[2], se->y[4], se->y[6]);
+      sens_step(se, step);
+    }
+    fprintf(output, "%f\t%f\t%f\t%f\t%f\n", se->t, se->y[0], se->y[2], se->y[4], se->y[6]);
+    printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f\n", se->t, se->y[0], se->y[1]);
+    // the same run again for the timing, without writing osc.dat, so
+    // both timed loops do nothing but integrate
+    clock_gettime(CLOCK_MONOTONIC, &c0);
+    sp = sens_create(x_prime, x_jvp, problem_order, 5, sparam, initial_time, x, kbm);
+    for(i = 0; i < num_of_data; i++) sens_step(sp, step);
+    sens_free(sp);
+    clock_gettime(CLOCK_MONOTONIC, &c1);
+    tserial = (c1.tv_sec - c0.tv_sec) + 1e-9*(c1.tv_nsec - c0.tv_nsec);
+    // two more runs per parameter, by the same steps without sensitivities
+    delta = 1e-6;
+    clock_gettime(CLOCK_MONOTONIC, &c0);
+    for(j = 0; j < 5; j++){
+      for(r = -1; r <= 1; r += 2){
+        for(i = 0; i < 3; i++) kbm2[i] = kbm[i];
+        xs[0] = x[0];
+        xs[1] = x[1];
+        if(j < 3) kbm2[j] += r*delta;
+        else xs[j-3] += r*delta;
+        sp = sens_create(x_prime, x_jvp, problem_order, 0, sparam, initial_time, xs, kbm2);
+        for(i = 0; i < num_of_data; i++) sens_step(sp, step);
+        for(i = 0; i < problem_order; i++) fd[j*problem_order+i] = (r < 0) ? -sp->y[i] : fd[j*problem_order+i] + sp->y[i];
+        sens_free(sp);
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &c1);
+    tpara = (c1.tv_sec - c0.tv_sec) + 1e-9*(c1.tv_nsec - c0.tv_nsec);
+    for(j = 0; j < 5; j++){
+      printf("d/d%-2s  x: %+.10e (differences %+.10e)  v: %+.10e (differences %+.10e)\n", snames[j], se->y[(j+1)*problem_order], fd[j*problem_order]/(2*delta), se->y[(j+1)*problem_order+1], fd[j*problem_order+1]/(2*delta));
+    }
+    printf("with sensitivities: %ld rhs evaluations, %ld products, %.3g s\n", se->nfev, se->njvp, tserial);
+    printf("central differences: %d rhs evaluations, %.3g s\n", 10*4*num_of_data, tpara);
+    sens_free(se);
+  }
+  else if(sdemethod > 0){
+    // moments every 10 steps
+    clock_gettime(CLOCK_MONOTONIC, &c0);
+    sd = sde_create(sdemethod, x_prime_sde, x_diff_sde, problem_order, initial_time, x, step/steps, 10*steps, num_of_data/10+1, npath, 20261018, sdep);
+    if(sde_run(sd, threads) != 0) fprintf(stderr, "some threads could not be started\n");
+    clock_gettime(CLOCK_MONOTONIC, &c1);
+    tserial = (c1.tv_sec - c0.tv_sec) + 1e-9*(c1.tv_nsec - c0.tv_nsec);
+    // E x, E v, E xx, E xv, E vv by RK4 steps 100 times shorter
+    mom[0] = x[0];
+    mom[1] = x[1];
+    mom[2] = x[0]*x[0];
+    mom[3] = x[0]*x[1];
+    mom[4] = x[1]*x[1];
+    for(j = 0; j < sd->nout; j++){
+      if(j > 0){
+        for(i = 0; i < 1000; i++) rk4_step(x_moments, 5, 0, step/100, mom, wm, sdep);
+      }
+      fprintf(output, "%f\t%f\t%f\t%f\t%f\n", initial_time + j*10*step, sd->mean[j*problem_order], sqrt(sd->var[j*problem_order]), mom[0], sqrt(mom[2] - mom[0]*mom[0]));
+    }
+    j = sd->nout - 1;
+    printf("%ld paths on %d threads, %ld steps, %.5f s, %.3g path steps/s\n", npath, threads, sd->nfev, tserial, (double) npath*sd->nfev/tserial);
+    printf("time = %-5.5f, mean displacement = %+.6f (exact %+.6f, standard error %.1e)\n", initial_time + 10*j*step, sd->mean[j*problem_order], mom[0], sqrt(sd->var[j*problem_order]/npath));
+    printf("variance = %.6f (exact %.6f, standard error %.1e)\n", sd->var[j*problem_order], mom[2] - mom[0]*mom[0], sd->var[j*problem_order]*sqrt(2.0/(npath-1)));
+    printf("rhs evaluations = %ld, diffusion evaluations = %ld per path\n", sd->nfev, sd->ngev);
+    sde_free(sd);
+  }
+  else if(fitname != NULL){
+    // starting points spread over k in [0.25, 3], b in [0, 1] by the
+    // golden ratio sequences, the same for every run
+    starts = (double *) malloc(2*nstart*sizeof(double));
+    for(j = 0; j < nstart; j++){
+      starts[2*j] = 0.25 + 2.75*fmod(0.5 + j*0.6180339887498949, 1);
+      starts[2*j+1] = fmod(0.5 + j*0.7548776662466927, 1);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &c0);
+    ft = fit_create(x_prime, x_jvp, problem_order, initial_time, x, 3, kbm, 2, fitwhich, mobs, tobs, yobs, 0);
+    fitstatus = fit_multistart(ft, nstart, starts, threads);
+    clock_gettime(CLOCK_MONOTONIC, &c1);
+    tserial = (c1.tv_sec - c0.tv_sec) + 1e-9*(c1.tv_nsec - c0.tv_nsec);
+    printf("%d observations from %s, %d starting points on %d threads\n", mobs, fitname, nstart, threads);
+    printf("k = %.10f +- %.3e\n", ft->p[0], sqrt(ft->cov[0]));
+    printf("b = %.10f +- %.3e\n", ft->p[1], sqrt(ft->cov[3]));
+    printf("correlation = %.6f\n", (ft->cov[0] > 0 && ft->cov[3] > 0) ? ft->cov[1]/sqrt(ft->cov[0]*ft->cov[3]) : 0);
+    printf("cost = %.6e, rms residual = %.3e, %d iterations from start %d (k = %g, b = %g)%s\n", ft->cost, sqrt(2*ft->cost/mobs), ft->iter, ft->best, starts[2*ft->best], starts[2*ft->best+1], (fitstatus == 0) ? "" : ", not converged");
+    printf("rhs evaluations = %ld, %.5f s\n", ft->nfev, tserial);
+    // the fitted model on the observation times, by the same steps
+    se = sens_create(x_prime, x_jvp, problem_order, 0, sparam, initial_time, x, ft->p);
+    for(i = 0; i < mobs; i++){
+      if(tobs[i] > se->t){
+        r = (long) ceil((tobs[i] - se->t)/ft->hmax - 1e-9);
+        delta = (tobs[i] - se->t)/r;
+        for(; r > 0; r--) sens_step(se, delta);
+        se->t = tobs[i];
+      }
+      fprintf(output, "%f\t%f\t%f\n", tobs[i], yobs[i], se->y[0]);
+    }
+    sens_free(se);
+    fit_free(ft);
+    free(starts);
+    free(tobs);
+    free(yobs);
+  }
+  else if(slices > 0){
+    kbm[1] = 0.002;
+    final_time = initial_time + 2*3.14159265358979323846*periods;
+    nfine = (int) (1000*periods/slices);
+    if(nfine < 1) nfine = 1;
+    // the serial run, slice by slice with the same steps as the fine propagator
+    clock_gettime(CLOCK_MONOTONIC, &c0);
+    for(j = 0; j < problem_order; j++) xs[j] = x[j];
+    for(j = 0; j < slices; j++){
+      t = initial_time + j*(final_time - initial_time)/slices;
+      step = (final_time - initial_time)/slices/nfine;
+      for(i = 0; i < nfine; i++) rk4_step(x_prime, problem_order, t + i*step, step, xs, wc, kbm);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &c1);
+    tserial = (c1.tv_sec - c0.tv_sec) + 1e-9*(c1.tv_nsec - c0.tv_nsec);
+    clock_gettime(CLOCK_MONOTONIC, &c0);
+    pr = para_create(x_prime, problem_order, initial_time, final_time, x, slices, nfine, kbm);
+    pr->ncoarse = (nfine >= 20) ? nfine/20 : 1;
+    pr->nthread = threads;
+    pr->tol = 1e-8;
+    if(para_run(pr) != 0) fprintf(stderr, "parareal did not converge in %d iterations\n", pr->iter);
+    clock_gettime(CLOCK_MONOTONIC, &c1);
+    tpara = (c1.tv_sec - c0.tv_sec) + 1e-9*(c1.tv_nsec - c0.tv_nsec);
+    for(j = 0; j < pr->iter; j++) printf("iteration %d, change = %.3e\n", j+1, pr->defect[j]);
+    for(j = 0; j <= slices; j++){
+      fprintf(output, "%f\t%f\n", initial_time + j*(final_time - initial_time)/slices, pr->u[j*problem_order]);
+    }
+    err = 0;
+    for(j = 0; j < problem_order; j++) err = fmax(err, fabs(pr->u[slices*problem_order+j] - xs[j]));
+    printf("%d slices, %d fine and %d coarse steps each, %d threads\n", slices, nfine, pr->ncoarse, threads);
+    printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f, difference from serial = %.2e\n", final_time, pr->u[slices*problem_order], pr->u[slices*problem_order+1], err);
+    printf("serial %.4f s, parareal %.4f s, speedup %.2f\n", tserial, tpara, tserial/tpara);
+    // the speedup the iterations allow with one core per thread, counting
+    // RK4 steps: fine slices shared among the threads, coarse sweeps serial
+    err = (double) slices*pr->ncoarse;
+    for(j = 0; j < pr->iter; j++) err += (double) ((slices - j + threads - 1)/threads)*nfine + (double) (slices - j)*pr->ncoarse;
+    printf("speedup on %d cores from the step counts = %.2f\n", threads, (double) slices*nfine/err);
+    para_free(pr);
+  }
+  else if(threads > 0){
+    job.initial_time = initial_time;
+    job.final_time = final_time;
+    job.step = step;
+    for(j = 0; j < problem_order; j++){
+      job.x0[j] = x[j];
+    }
+    job.kbm = (double *) malloc(3*count*sizeof(double));
+    job.final = (double *) malloc(count*problem_order*sizeof(double));
+    job.out = (sink **) malloc(threads*sizeof(sink *));
+    job.count = count;
+    job.done = (unsigned char *) calloc(count, 1);
+    job.ndone = 0;
+    job.ck = ck;
+    job.every = ckevery;
+    pthread_mutex_init(&job.lock, NULL);
+    // finished trajectories are skipped; with a prefix, the .bin files of
+    // a resumed run only hold the trajectories run after the restart
+    if(resume){
+      if(ckpt_get(ck, "done", job.done, count) == 0 && ckpt_get(ck, "final", job.final, count*problem_order*sizeof(double)) == 0){
+        for(j = 0; j < count; j++) job.ndone += job.done[j];
+        printf("resumed with %ld of %d trajectories done\n", job.ndone, count);
+      }
+      else{
+        fprintf(stderr, "%s is not a checkpoint of this sweep, starting over\n", ckname);
+        memset(job.done, 0, count);
+        resume = 0;
+      }
+    }
+    for(j = 0; j < count; j++){
+      job.kbm[3*j] = 1;
+      job.kbm[3*j+1] = (count > 1) ? 0.4*j/(count-1) : 0.2;
+      job.kbm[3*j+2] = 1;
+    }
+    // per-thread sinks, so no thread ever waits on another's output
+    for(j = 0; j < threads; j++){
+      if(prefix != NULL){
+        sprintf(name, "%.200s.%d.bin", prefix, j);
+        job.out[j] = sink_open(SINK_BINARY, name, problem_order+2, names);
+      }
+      else{
+        job.out[j] = sink_open(SINK_SUMMARY, NULL, problem_order+2, names);
+      }
+      if(job.out[j] == NULL){
+        if(prefix != NULL) fprintf(stderr, "cannot open %s\n", name);
+        else fprintf(stderr, "cannot open summary sink\n");
+        return 1;
+      }
+    }
+    if(pool_run(threads, count, sweep_task, &job) != 0){
+      fprintf(stderr, "some threads could not be started\n");
+    }
+    for(j = 0; j < threads; j++){
+      sink_close(job.out[j]);
+    }
+    for(j = 0; j < count; j++){
+      fprintf(output, "%f\t%f\n", job.kbm[3*j+1], job.final[j*problem_order]);
+    }
+    printf("%d trajectories on %d threads\n", count, threads);
+    free(job.kbm);
+    free(job.final);
+    free(job.out);
+    free(job.done);
+    pthread_mutex_destroy(&job.lock);
+  }
+  else if(count > 0){
+    // state in structure of arrays: xe[j] displacements, xe[count+j] velocities
+    xe = (double *) malloc(2*count*sizeof(double));
+    we = (double *) malloc(4*2*ODE_BLOCK*sizeof(double));
+    p.k = (double *) malloc(3*count*sizeof(double));
+    p.b = p.k + count;
+    p.m = p.b + count;
+    for(j = 0; j < count; j++){
+      p.k[j] = 1;
+      p.b[j] = (count > 1) ? 0.4*j/(count-1) : 0.2;
+      p.m[j] = 1;
+      xe[j] = x[0];
+      xe[count+j] = x[1];
+    }
+    nfev = 0;
+    // t from the step number, not summed, so there are exactly
+    // num_of_data steps as in the other fixed step modes
+    for(i = 0; i < num_of_data; i++){
+      t = initial_time + i*step;
+      mean = 0;
+      for(j = 0; j < count; j++){
+        mean += xe[j];
+      }
+      fprintf(output, "%f\t%f\n", t, mean/count);
+      rk4_ensemble(x_prime_ensemble, problem_order, count, t, step, xe, we, &p);
+      nfev += 4;
+    }
+    printf("%d oscillators, rhs evaluations = %ld per oscillator\n", count, nfev);
+    free(xe);
+    free(we);
+    free(p.k);
+  }
+  else if(abm_mode > 0){
+    ab = abm_create(x_prime, problem_order, initial_time, x, tol, tol, NULL);
+    ab->mode = abm_mode;
+    fprintf(output, "%f\t%f\n", ab->t, ab->x[0]);
+    while(ab->t < final_time){
+      if(abm_step(ab, final_time) != 0){
+        fprintf(stderr, "step size underflow at t = %g\n", ab->t);
+        break;
+      }
+      fprintf(output, "%f\t%f\n", ab->t, ab->x[0]);
+    }
+    printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f\n", ab->t, ab->x[0], ab->x[1]);
+    printf("steps = %ld, rejected = %ld, rhs evaluations = %ld, final order = %d\n", ab->naccept, ab->nreject, ab->nfev, ab->order);
+    abm_free(ab);
+  }
+  else if(events){
+    // g[0] = x rising gives the periods, g[1] = energy falling to estop ends the run
+    estop = 0.01*(0.5*x[1]*x[1] + 0.5*x[0]*x[0]);
+    d = dopri_create(x_prime, problem_order, initial_time, x, tol, tol, NULL);
+    e = event_create(d, 2, osc_events, &estop);
+    e->direction[0] = 1;
+    e->direction[1] = -1;
+    e->terminal[1] = 1;
+    tcross = -1;
+    // the damped period 2 pi / sqrt(k/m - (b/2m)^2) with k = m = 1, b = 0.2
+    printf("exact period = %.15f\n", 2*3.14159265358979323846/sqrt(0.99));
+    // the event finder stops inside a step, so its scan of that step is
+    // restored along with the integrator and its dense output
+    if(resume){
+      if(ckpt_get(ck, "event", el, sizeof(el)) == 0 && ckpt_get(ck, "event.t", es, sizeof(es)) == 0
+         && ckpt_get_dopri(ck, d) == 0){
+        ckpt_get(ck, "event.gscan", e->gscan, 2*sizeof(double));
+        ckpt_get(ck, "event.gend", e->gend, 2*sizeof(double));
+        e->pending = el[0];
+        e->which = el[1];
+        e->ngev = el[2];
+        e->nevent = el[3];
+        e->tscan = es[0];
+        e->te = es[1];
+        tcross = es[2];
+        // drop the rows written after the checkpoint
+        fflush(output);
+        if(ftruncate(fileno(output), el[4]) != 0) fprintf(stderr, "cannot truncate osc.dat\n");
+        fseek(output, 0, SEEK_END);
+        printf("resumed at crossing %ld, t = %g\n", e->nevent, e->te);
+      }
+      else{
+        fprintf(stderr, "%s is not a checkpoint of this run, starting over\n", ckname);
+        if(ftruncate(fileno(output), 0) != 0) fprintf(stderr, "cannot truncate osc.dat\n");
+        resume = 0;
+      }
+    }
+    while((ev = event_advance(e, final_time)) == EVENT_HIT){
+      if(tcross >= 0){
+        printf("crossing at t = %.15f, period = %.15f\n", e->te, e->te - tcross);
+        fprintf(output, "%f\t%.15f\n", e->te, e->te - tcross);
+      }
+      tcross = e->te;
+      if(ck != NULL && e->nevent % ckevery == 0){
+        fflush(output);
+        el[0] = e->pending;
+        el[1] = e->which;
+        el[2] = e->ngev;
+        el[3] = e->nevent;
+        el[4] = ftell(output);
+        es[0] = e->tscan;
+        es[1] = e->te;
+        es[2] = tcross;
+        ckpt_begin(ck);
+        ckpt_put(ck, "event", el, sizeof(el));
+        ckpt_put(ck, "event.t", es, sizeof(es));
+        ckpt_put(ck, "event.gscan", e->gscan, 2*sizeof(double));
+        ckpt_put(ck, "event.gend", e->gend, 2*sizeof(double));
+        ckpt_put_dopri(ck, d);
+        if(ckpt_commit(ck) != 0) fprintf(stderr, "writing %s failed\n", ckname);
+      }
+    }
+    if(ev == EVENT_STOP) printf("energy down to 1%% at t = %.15f, displacement = %-5.5f\n", e->te, e->xe[0]);
+    if(ev == 1) fprintf(stderr, "step size underflow at t = %g\n", d->t);
+    printf("steps = %ld, rejected = %ld, rhs evaluations = %ld, event evaluations = %ld\n", d->naccept, d->nreject, d->nfev, e->ngev);
+    event_free(e);
+    dopri_free(d);
+  }
+  else if(tol > 0){
+    // adaptive: the steps follow the error, the num_of_data+1 rows of
+    // osc.dat come from the dense output on the same grid as the RK4 run
+    tgrid = (double *) malloc((num_of_data+1)*sizeof(double));
+    xgrid = (double *) malloc((num_of_data+1)*problem_order*sizeof(double));
+    for(j = 0; j <= num_of_data; j++){
+      tgrid[j] = initial_time + j*step;
+    }
+    d = dopri_create(x_prime, problem_order, initial_time, x, tol, tol, NULL);
+    if(ck == NULL){
+      if(dopri_grid(d, num_of_data+1, tgrid, xgrid) != 0){
+        fprintf(stderr, "step size underflow at t = %g\n", d->t);
+      }
+    }
+    else{
+      // the loop of dopri_grid, with a checkpoint every ckevery accepted
+      // steps: the integrator with its step size control, and the rows
+      // of the grid filled so far
+      d->dense = 1;
+      j = 0;
+      if(resume){
+        if(ckpt_get(ck, "grid", &j, sizeof(int)) == 0 && ckpt_get(ck, "xgrid", xgrid, (num_of_data+1)*problem_order*sizeof(double)) == 0
+           && ckpt_get_dopri(ck, d) == 0){
+          printf("resumed at step %ld, t = %g\n", d->naccept, d->t);
+        }
+        else{
+          fprintf(stderr, "%s is not a checkpoint of this run, starting over\n", ckname);
+          j = 0;
+          resume = 0;
+        }
+      }
+      i0 = d->naccept;
+      while(j <= num_of_data){
+        if(tgrid[j] == d->t){
+          memcpy(xgrid + j*problem_order, d->x, problem_order*sizeof(double));
+          j++;
+        }
+        else if(tgrid[j] < d->t){
+          dopri_eval(d, tgrid[j], xgrid + j*problem_order);
+          j++;
+        }
+        else{
+          if(d->naccept > i0 && d->naccept % ckevery == 0){
+            ckpt_begin(ck);
+            ckpt_put(ck, "grid", &j, sizeof(int));
+            ckpt_put(ck, "xgrid", xgrid, (num_of_data+1)*problem_order*sizeof(double));
+            ckpt_put_dopri(ck, d);
+            if(ckpt_commit(ck) != 0) fprintf(stderr, "writing %s failed\n", ckname);
+            i0 = d->naccept;
+          }
+          if(dopri_step(d, tgrid[num_of_data]) != 0){
+            fprintf(stderr, "step size underflow at t = %g\n", d->t);
+            break;
+          }
+        }
+      }
+    }
+    for(j = 0; j <= num_of_data && tgrid[j] <= d->t; j++){
+      printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f\n", tgrid[j], xgrid[j*problem_order], xgrid[j*problem_order+1]);
+      fprintf(output, "%f\t%f\n", tgrid[j], xgrid[j*problem_order]);
+    }
+    printf("steps = %ld, rejected = %ld, rhs evaluations = %ld\n", d->naccept, d->nreject, d->nfev);
+    dopri_free(d);
+    free(tgrid);
+    free(xgrid);
+  }
+  else if(trajname != NULL){
+    ts = sink_open(SINK_TRAJ, trajname, problem_order+1, tnames);
+    if(ts == NULL){
+      fprintf(stderr, "cannot open %s\n", trajname);
+      return 1;
+    }
+    sink_async(ts, 4);
+    c = ode_ctx_create(x_prime, problem_order, initial_time, x, step, NULL);
+    // times as initial_time + i*step, as in ode_ctx_run, so there are
+    // exactly num_of_data steps and the last row is at final_time
+    for(i = 0; i <= num_of_data; i++){
+      if(i > 0){
+        ode_ctx_step(c);
+        c->t = initial_time + i*step;
+      }
+      row[0] = c->t;
+      for(j = 0; j < problem_order; j++) row[j+1] = c->x[j];
+      sink_row(ts, row);
+      fprintf(output, "%f\t%f\n", c->t, c->x[0]);
+    }
+    if(ts->nwait > 0) printf("waited for the disk %ld times\n", ts->nwait);
+    sink_close(ts);
+    printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f\n", c->t, c->x[0], c->x[1]);
+    printf("rhs evaluations = %ld\n", c->nfev);
+    ode_ctx_free(c);
+  }
+  else{
+    c = ode_ctx_create(x_prime, problem_order, initial_time, x, step, NULL);
+    // num_of_data steps and num_of_data+1 rows, the times without drift
+    for(i = 0; i <= num_of_data; i++){
+      if(i > 0){
+        ode_ctx_step(c);
+        c->t = initial_time + i*step;
+      }
+      printf("time = %-5.5f, displacement = %-5.5f, velocity = %-5.5f\n", c->t, c->x[0], c->x[1]);
+      fprintf(output, "%f\t%f\n", c->t, c->x[0]);
+    }
+    printf("rhs evaluations = %ld\n", c->nfev);
+    ode_ctx_free(c);
   }
   fclose(output);
+  ode_arena_free(arena);
+  if(ck != NULL){
+    ckpt_report(ck, stdout);
+    // the run is over: its checkpoint, or the one it resumed from, is done
+    // with; a file this run neither wrote nor resumed from is kept
+    if(ck->nsave > 0 || resume) remove(ckname);
+    ckpt_free(ck);
+  }
 
-  pipe = popen("gnuplot -persist","w");
-  //fprintf(pipe,"set term png enhanced font \"v:/fireflysung.ttf\" 18 \n");
-  fprintf(pipe,"set term png enhanced font \"y:/wqy-microhei.ttc\" 18 \n");
-  //fprintf(pipe,"set yrange [68:70]\n");
-  fprintf(pipe,"set output \"c_rk_4.png\"\n");
-  fprintf(pipe, "plot \"osc.dat\" title \"C 以 Runge-Kutta 解微分方程式\" with lines\n");
-  fprintf(pipe,"quit\n");
-  pclose(pipe);
+  // one gnuplot for the run, the points sent inline as binary doubles;
+  // c_rk_4.png is only redrawn when its data or commands have changed
+  gp = plot_open(NULL, "rk4.plotcache");
+  if(gp != NULL && fit_read("osc.dat", &nplot, &tplot, &yplot) == 0){
+    xyplot = malloc(2 * nplot * sizeof(double));
+    for(j = 0; j < nplot; j++){
+      xyplot[2*j] = tplot[j];
+      xyplot[2*j+1] = yplot[j];
+    }
+    //plot_cmd(gp, "set term png enhanced font \"v:/fireflysung.ttf\" 18");
+    plot_cmd(gp, "set term png enhanced font \"y:/wqy-microhei.ttc\" 18");
+    //plot_cmd(gp, "set yrange [68:70]");
+    plot_draw(gp, "c_rk_4.png", "plot '-' title \"C 以 Runge-Kutta 解微分方程式\" with lines", nplot, 2, xyplot);
+    free(xyplot);
+    free(tplot);
+    free(yplot);
+  }
+  if(gp != NULL && plot_close(gp) != 0) fprintf(stderr, "gnuplot did not take the plot\n");
 return 0;
 }
 
 // x is an array which represents the big matrix of the state variables
-double x_prime(double x[], double tt, int i){
-    double k, b, m, xp[problem_order];
+// xp receives the whole derivative vector in one call
+void x_prime(double tt, double x[], double xp[], void *data){
+    double k, b, m;
     k=1;
-    b=0;
+    b=0.2;
     m=1;
+    // a sweep passes its own k, b, m
+    if(data != NULL){
+      k=((double *) data)[0];
+      b=((double *) data)[1];
+      m=((double *) data)[2];
+    }
     xp[0]=x[1];
-    xp[1]=-x[0]-0.2*x[1];
+    xp[1]=-(k*x[0]+b*x[1])/m;
     // xp[2]=x[0];
-    return xp[i];
 }
 
-
-// Integrate the differential equation using the Runge-Kutta Method
-
-// x is an array of the matrix which represents the state variables
-
-double integrate(double x[], double tt, int i){
-
-// the purpose of this function is to calculate the value of the $x for each step
-// upon time series, calculate corresponding $x array
-// there we introduct the array k1,k2,k3,k4
-//k1[0],k2[0],k3[0],k4[0] is corresponding to x[0]
-//k1[1],k2[1],k3[1],k4[1] is corresponding to x[1]
-// initialize $order
-// order=0;
-// step=0.1;
-double k1[problem_order], k2[problem_order], k3[problem_order], k4[problem_order];
-double x1[problem_order], x2[problem_order], x3[problem_order], x4[problem_order];
-double t2, t3, t4;
-double h = step/2;
-int k, j;
-for(j = 0; j < problem_order; j++){
-  k1[j] = x_prime(x, tt, j);
+// products for the sensitivities: jv = df/dx v + df/dp_j, with p = k, b, m
+void x_jvp(double tt, double x[], double v[], int j, double jv[], void *data){
+    double k = ((double *) data)[0], b = ((double *) data)[1], m = ((double *) data)[2];
+    jv[0]=v[1];
+    jv[1]=-(k*v[0]+b*v[1])/m;
+    if(j == 0) jv[1]-=x[0]/m;
+    if(j == 1) jv[1]-=x[1]/m;
+    if(j == 2) jv[1]+=(k*x[0]+b*x[1])/(m*m);
 }
 
-for(k = 0; k < problem_order; k++){
-  x2[k] = x[k] + (h/2)*k1[k];
+// the oscillator for sde: the same drift for every path, data = k, b, m, s0, s1
+void x_prime_sde(double tt, int first, int count, int ld, double x[], double xp[], void *data){
+    double *p = (double *) data;
+    int i;
+    for(i = 0; i < count; i++){
+      xp[i] = x[ld+i];
+      xp[ld+i] = -(p[0]*x[i] + p[1]*x[ld+i])/p[2];
+    }
 }
 
-t2 = tt + (h/2);
-
-for(j = 0; j < problem_order; j++){
-  k2[j] = x_prime(x2, t2, j);
+// the noise acts on v only: g = s0 + s1 v, dg/dv = s1
+void x_diff_sde(double tt, int first, int count, int ld, double x[], double g[], double dg[], void *data){
+    double *p = (double *) data;
+    int i;
+    for(i = 0; i < count; i++){
+      g[i] = 0;
+      g[ld+i] = p[3] + p[4]*x[ld+i];
+      if(dg != NULL){
+        dg[i] = 0;
+        dg[ld+i] = p[4];
+      }
+    }
 }
 
-for(k = 0; k < problem_order; k++){
-  x3[k] = x[k] + (h/2)*k2[k];
+// the exact moments of the sde: y = E x, E v, E xx, E xv, E vv
+void x_moments(double tt, double y[], double yp[], void *data){
+    double *p = (double *) data;
+    double k = p[0]/p[2], b = p[1]/p[2], s0 = p[3], s1 = p[4];
+    yp[0] = y[1];
+    yp[1] = -k*y[0] - b*y[1];
+    yp[2] = 2*y[3];
+    yp[3] = y[4] - k*y[2] - b*y[3];
+    yp[4] = -2*(k*y[3] + b*y[4]) + s0*s0 + 2*s0*s1*y[1] + s1*s1*y[4];
 }
 
-t3 = tt + (h/2);
-
-for(j = 0; j < problem_order; j++){
-  k3[j] = x_prime(x3, t3, j);
+// events of the oscillator: g[0] is the displacement, g[1] the energy
+// above the level *data at which the run stops
+void osc_events(double tt, double x[], double g[], void *data){
+  g[0] = x[0];
+  g[1] = 0.5*x[1]*x[1] + 0.5*x[0]*x[0] - *(double *) data;
 }
-for(k = 0; k < problem_order; k++){
-  x4[k] = x[k] + (h)*k3[k];
+
+// the same oscillator as a second order system: q'' = -k/m q
+// the damping b is left to the integrator
+void x_accel(double tt, double q[], double a[], void *data){
+    double *kbm = (double *) data;
+    a[0] = -kbm[0]/kbm[2]*q[0];
 }
-t4 = tt + (h);
-for(j = 0; j < problem_order; j++){
-  k4[j] = x_prime(x4, t4, j);
+
+// the same oscillator for a block of the ensemble: x[i] and x[ld+i] are the
+// displacement and velocity of oscillator first+i, with its own k, b, m
+// the loop has unit stride in every array, so it vectorizes
+void x_prime_ensemble(double tt, int first, int count, int ld, double x[], double xp[], void *data){
+    osc_param *p = (osc_param *) data;
+    double *k = p->k + first, *b = p->b + first, *m = p->m + first;
+    int i;
+    for(i = 0; i < count; i++){
+      xp[i] = x[ld+i];
+      xp[ld+i] = -(k[i]*x[i] + b[i]*x[ld+i])/m[i];
+    }
 }
 
-for(k = 0;k < problem_order; k++){
-  x[k] = x[k] + (h/6)*(k1[k] + (2.0*k2[k]) + (2.0*k3[k]) + k4[k]);
+// the chain: x[i] is the displacement of mass i, x[count+i] its velocity,
+// the ends are held at 0; one pass over the masses, split among threads for
+// long chains when built with -fopenmp
+void x_prime_chain(double tt, double x[], double xp[], void *data){
+    chain_param *p = (chain_param *) data;
+    int count = p->count, i;
+    double left, right;
+    ODE_OMP(parallel for private(left, right) if(count >= ODE_PAR_MIN))
+    for(i = 0; i < count; i++){
+      left = (i > 0) ? x[i-1] : 0;
+      right = (i < count-1) ? x[i+1] : 0;
+      xp[i] = x[count+i];
+      xp[count+i] = (p->k*(left - 2*x[i] + right) - p->b*x[count+i])/p->m;
+    }
 }
-return x[i];
 
+// one trajectory of a sweep, run by whichever pool thread picks it up
+// everything it touches is its own context, its own slot of job->final and
+// the sink of the calling thread
+void sweep_task(int i, int thread, void *arg){
+    sweep_job *job = (sweep_job *) arg;
+    ode_ctx *c;
+    int j;
+    if(job->done[i]) return;
+    c = ode_ctx_create(x_prime, problem_order, job->initial_time, job->x0, job->step, job->kbm + 3*i);
+    c->id = i;
+    c->out = job->out[thread];
+    ode_ctx_run(c, job->final_time);
+    pthread_mutex_lock(&job->lock);
+    for(j = 0; j < problem_order; j++){
+      job->final[i*problem_order+j] = c->x[j];
+    }
+    job->done[i] = 1;
+    job->ndone++;
+    if(job->ck != NULL && job->ndone % job->every == 0){
+      ckpt_begin(job->ck);
+      ckpt_put(job->ck, "done", job->done, job->count);
+      ckpt_put(job->ck, "final", job->final, job->count*problem_order*sizeof(double));
+      ckpt_commit(job->ck);
+    }
+    pthread_mutex_unlock(&job->lock);
+    ode_ctx_free(c);
 }
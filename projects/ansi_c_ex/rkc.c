@@ -0,0 +1,342 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <math.h>
+
+# include "rkc.h"
+
+/******************************************************************************/
+
+double rkc_rho ( ode_rhs *f, int n, double t, double x[], double v[],
+  int maxit, double tol, double work[], void *data, long *nfev )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    RKC_RHO estimates the spectral radius of the Jacobian of F.
+
+  Discussion:
+
+    The iterates are kept as perturbations X + V of X, of a size
+    relative to X, and each product J V is ( F(X+V) - F(X) ) / |V|.
+    The iteration stops when the estimate changes by less than TOL
+    relative to itself, and the result is raised by 20 percent, as in
+    RKC, since the power method approaches the radius from below.
+
+    If V is zero on input, the iteration starts from F(X), or from a
+    fixed vector if that is zero too.  On output V holds the last
+    direction, a good start for the next call along the solution.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Ben Sommeijer, Lawrence Shampine, Jan Verwer,
+    RKC: an explicit solver for parabolic PDEs,
+    Journal of Computational and Applied Mathematics,
+    Volume 88, 1997, pages 315-326.
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T, X[N], the point.
+
+    Input/output, double V[N], the starting direction, or zero; the
+    last direction.
+
+    Input, int MAXIT, the largest number of iterations.
+
+    Input, double TOL, the relative change at which to stop.
+
+    Workspace, double WORK[2*N].
+
+    Input, void *DATA, passed to F.
+
+    Input/output, long *NFEV, the count of evaluations of F.
+
+    Output, double RKC_RHO, the estimate.
+*/
+{
+  double dx;
+  double dv;
+  double *fx;
+  double *fv;
+  int i;
+  int it;
+  double rho;
+  double rhold;
+  double xnorm;
+
+  fx = work;
+  fv = work + n;
+
+  f ( t, x, fx, data );
+  *nfev = *nfev + 1;
+
+  xnorm = 0.0;
+  dv = 0.0;
+  for ( i = 0; i < n; i++ )
+  {
+    xnorm = xnorm + x[i] * x[i];
+    dv = dv + v[i] * v[i];
+  }
+  xnorm = sqrt ( xnorm );
+  dv = sqrt ( dv );
+  if ( dv == 0.0 )
+  {
+    for ( i = 0; i < n; i++ )
+    {
+      v[i] = fx[i];
+      dv = dv + v[i] * v[i];
+    }
+    dv = sqrt ( dv );
+  }
+  if ( dv == 0.0 )
+  {
+    for ( i = 0; i < n; i++ )
+    {
+      v[i] = ( i % 2 == 0 ) ? 1.0 : -1.0;
+    }
+    dv = sqrt ( ( double ) n );
+  }
+/*
+  The perturbation is about sqrt ( eps ) relative to X.
+*/
+  dx = ( xnorm == 0.0 ) ? 1.0E-08 : 1.0E-08 * xnorm;
+  for ( i = 0; i < n; i++ )
+  {
+    v[i] = dx * v[i] / dv;
+  }
+
+  rho = 0.0;
+  for ( it = 0; it < maxit; it++ )
+  {
+    for ( i = 0; i < n; i++ )
+    {
+      fv[i] = x[i] + v[i];
+    }
+    f ( t, fv, v, data );
+    *nfev = *nfev + 1;
+    dv = 0.0;
+    for ( i = 0; i < n; i++ )
+    {
+      v[i] = v[i] - fx[i];
+      dv = dv + v[i] * v[i];
+    }
+    dv = sqrt ( dv );
+    rhold = rho;
+    rho = dv / dx;
+    if ( dv == 0.0 )
+    {
+      break;
+    }
+    for ( i = 0; i < n; i++ )
+    {
+      v[i] = dx * v[i] / dv;
+    }
+    if ( 0 < it && fabs ( rho - rhold ) <= tol * rho )
+    {
+      break;
+    }
+  }
+
+  return 1.2 * rho;
+}
+/******************************************************************************/
+
+int rkc_stages ( double h, double rho )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    RKC_STAGES returns the number of stages RKC needs for a step.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double H, the step size.
+
+    Input, double RHO, the spectral radius of the Jacobian.
+
+    Output, int RKC_STAGES, the smallest S, at least 2, for which H is
+    stable.
+*/
+{
+  return 1 + ( int ) sqrt ( 1.54 * h * rho + 1.0 );
+}
+/******************************************************************************/
+
+void rkc_step ( ode_rhs *f, int n, double t, double h, int s, double x[],
+  double work[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    RKC_STEP takes one step of the Runge-Kutta-Chebyshev method.
+
+  Discussion:
+
+    The stages follow the three term recurrence of the Chebyshev
+    polynomials T(J), with W0 = 1 + EPS / S^2 and the coefficients of
+    the second order method of van der Houwen and Sommeijer, so only
+    the last two stages are kept.  The new stage is written over the
+    one before last, entry by entry.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Ben Sommeijer, Lawrence Shampine, Jan Verwer,
+    RKC: an explicit solver for parabolic PDEs,
+    Journal of Computational and Applied Mathematics,
+    Volume 88, 1997, pages 315-326.
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, int N, the number of components.
+
+    Input, double T, H, the time and the step size.
+
+    Input, int S, the number of stages, at least 2; see RKC_STAGES.
+
+    Input/output, double X[N], the state at T, replaced by the state
+    at T+H.
+
+    Workspace, double WORK[4*N].
+
+    Input, void *DATA, passed to F.
+*/
+{
+  double ajm1;
+  double arg;
+  double bj;
+  double bjm1;
+  double bjm2;
+  double d2zj;
+  double d2zjm1;
+  double d2zjm2;
+  double dzj;
+  double dzjm1;
+  double dzjm2;
+  double *fj;
+  double *fn;
+  int i;
+  int j;
+  double mu;
+  double mus;
+  double nu;
+  double *p;
+  double temp1;
+  double temp2;
+  double thj;
+  double thjm1;
+  double thjm2;
+  double w0;
+  double w1;
+  double *yjm1;
+  double *yjm2;
+  double zj;
+  double zjm1;
+  double zjm2;
+
+  fn = work;
+  yjm1 = work + n;
+  yjm2 = work + 2 * n;
+  fj = work + 3 * n;
+
+  w0 = 1.0 + 2.0 / ( 13.0 * s * s );
+  temp1 = w0 * w0 - 1.0;
+  temp2 = sqrt ( temp1 );
+  arg = s * log ( w0 + temp2 );
+  w1 = sinh ( arg ) * temp1 
+    / ( cosh ( arg ) * s * temp2 - w0 * sinh ( arg ) );
+  bjm1 = 1.0 / ( ( 2.0 * w0 ) * ( 2.0 * w0 ) );
+  bjm2 = bjm1;
+/*
+  The first stage.
+*/
+  f ( t, x, fn, data );
+  mus = w1 * bjm1;
+  for ( i = 0; i < n; i++ )
+  {
+    yjm2[i] = x[i];
+    yjm1[i] = x[i] + h * mus * fn[i];
+  }
+  thjm2 = 0.0;
+  thjm1 = mus;
+  zjm1 = w0;
+  zjm2 = 1.0;
+  dzjm1 = 1.0;
+  dzjm2 = 0.0;
+  d2zjm1 = 0.0;
+  d2zjm2 = 0.0;
+/*
+  Stages 2 to S.
+*/
+  for ( j = 2; j <= s; j++ )
+  {
+    zj = 2.0 * w0 * zjm1 - zjm2;
+    dzj = 2.0 * w0 * dzjm1 - dzjm2 + 2.0 * zjm1;
+    d2zj = 2.0 * w0 * d2zjm1 - d2zjm2 + 4.0 * dzjm1;
+    bj = d2zj / ( dzj * dzj );
+    ajm1 = 1.0 - zjm1 * bjm1;
+    mu = 2.0 * w0 * bj / bjm1;
+    nu = - bj / bjm2;
+    mus = mu * w1 / w0;
+
+    f ( t + h * thjm1, yjm1, fj, data );
+    for ( i = 0; i < n; i++ )
+    {
+      yjm2[i] = mu * yjm1[i] + nu * yjm2[i] + ( 1.0 - mu - nu ) * x[i]
+        + h * mus * ( fj[i] - ajm1 * fn[i] );
+    }
+    thj = mu * thjm1 + nu * thjm2 + mus * ( 1.0 - ajm1 );
+
+    p = yjm2;
+    yjm2 = yjm1;
+    yjm1 = p;
+    thjm2 = thjm1;
+    thjm1 = thj;
+    bjm2 = bjm1;
+    bjm1 = bj;
+    zjm2 = zjm1;
+    zjm1 = zj;
+    dzjm2 = dzjm1;
+    dzjm1 = dzj;
+    d2zjm2 = d2zjm1;
+    d2zjm1 = d2zj;
+  }
+
+  for ( i = 0; i < n; i++ )
+  {
+    x[i] = yjm1[i];
+  }
+
+  return;
+}
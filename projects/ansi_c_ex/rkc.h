@@ -0,0 +1,33 @@
+/*
+  RKC holds the second order Runge-Kutta-Chebyshev method of Sommeijer,
+  Shampine and Verwer, an explicit method for mildly stiff problems
+  whose Jacobian has eigenvalues near the negative real axis, such as
+  diffusion after discretization in space:
+
+    rho = rkc_rho ( f, n, t, x, v, 50, 0.01, work, data, &nfev );
+    s = rkc_stages ( h, rho );
+    rkc_step ( f, n, t, h, s, x, work, data );
+
+  A step of S stages is stable for H * RHO up to about 0.65 S^2, against
+  2.78 for a step of RK4, so the stable step grows with the square of
+  the number of evaluations of F, and a step chosen for accuracy alone
+  can be taken with S near sqrt ( H * RHO / 0.65 ).  The damping
+  EPS = 2/13 keeps the stability polynomial inside [-1,1] by a margin,
+  so the step can be used up to that bound.
+
+  RKC_RHO estimates the spectral radius RHO of dF/dX by power iteration,
+  each product being a difference of two values of F, so F need not be
+  linear and the Jacobian is never formed.
+*/
+# ifndef RKC_H
+# define RKC_H
+
+# include "ode.h"
+
+double rkc_rho ( ode_rhs *f, int n, double t, double x[], double v[],
+  int maxit, double tol, double work[], void *data, long *nfev );
+int rkc_stages ( double h, double rho );
+void rkc_step ( ode_rhs *f, int n, double t, double h, int s, double x[],
+  double work[], void *data );
+
+# endif
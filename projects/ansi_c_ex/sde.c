@@ -0,0 +1,466 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <stdint.h>
+# include <math.h>
+
+# include "sde.h"
+# include "pool.h"
+
+static void sde_task ( int b, int thread, void *arg );
+
+/******************************************************************************/
+
+sde *sde_create ( int method, ode_ens_rhs *f, sde_diff *g, int n, double t0,
+  double x0[], double h, int nstep, int nout, long npath,
+  unsigned long seed, void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SDE_CREATE sets up an ensemble of stochastic differential equations.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int METHOD, SDE_EM, SDE_MILSTEIN or SDE_SRK.
+
+    Input, ode_ens_rhs *F, the drift, for a block of paths.
+
+    Input, sde_diff *G, the diagonal of the diffusion, for a block of
+    paths.
+
+    Input, int N, the number of components.
+
+    Input, double T0, X0[N], the starting point, the same for all paths.
+
+    Input, double H, the step size.
+
+    Input, int NSTEP, the number of steps between output times.
+
+    Input, int NOUT, the number of output times, T0 included.
+
+    Input, long NPATH, the number of paths, at least 2.
+
+    Input, unsigned long SEED, the key of the random numbers.
+
+    Input, void *DATA, passed to F and G.
+
+    Output, sde *SDE_CREATE, the ensemble.
+*/
+{
+  int j;
+  sde *s;
+
+  s = ( sde * ) malloc ( sizeof ( sde ) );
+  s->method = method;
+  s->f = f;
+  s->g = g;
+  s->data = data;
+  s->n = n;
+  s->t0 = t0;
+  s->x0 = ( double * ) malloc ( ( n + 2 * nout * n ) * sizeof ( double ) );
+  s->mean = s->x0 + n;
+  s->var = s->mean + nout * n;
+  s->h = h;
+  s->nstep = nstep;
+  s->nout = nout;
+  s->npath = npath;
+  s->seed = seed;
+  s->bmean = NULL;
+  s->bm2 = NULL;
+  s->nfev = 0;
+  s->ngev = 0;
+
+  for ( j = 0; j < n; j++ )
+  {
+    s->x0[j] = x0[j];
+  }
+
+  return s;
+}
+/******************************************************************************/
+
+void sde_free ( sde *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SDE_FREE frees an ensemble.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, sde *S, the ensemble.
+*/
+{
+  free ( s->x0 );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+void sde_normal ( unsigned long seed, long step, int pair, long first,
+  int count, double z0[], double z1[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SDE_NORMAL returns the standard normals of a block of paths.
+
+  Discussion:
+
+    Path I gets the 128 bit output of Philox4x32-10 with key SEED and
+    counter ( STEP, PAIR, I ), read as two uniforms in (0,1) with 53
+    bits each, and turned into two normals by the Box-Muller transform.
+
+    The rounds run as one loop over the paths on 32 bit integers, and
+    the transform as another, so both can be vectorized.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    John Salmon, Mark Moraes, Ron Dror, David Shaw,
+    Parallel random numbers: as easy as 1, 2, 3,
+    Proceedings of SC11, 2011.
+
+  Parameters:
+
+    Input, unsigned long SEED, the key.
+
+    Input, long STEP, int PAIR, the step and the pair of components.
+
+    Input, long FIRST, int COUNT, the paths FIRST to FIRST+COUNT-1.
+
+    Output, double Z0[COUNT], Z1[COUNT], the normals.
+*/
+{
+  uint32_t c0;
+  uint32_t c1;
+  uint32_t c2;
+  uint32_t c3;
+  int i;
+  uint32_t k0;
+  uint32_t k1;
+  uint64_t p0;
+  uint64_t p1;
+  double r;
+  int round;
+  double u1;
+  double u2;
+
+  for ( i = 0; i < count; i++ )
+  {
+    c0 = ( uint32_t ) step;
+    c1 = ( uint32_t ) pair;
+    c2 = ( uint32_t ) ( first + i );
+    c3 = ( uint32_t ) ( ( uint64_t ) ( first + i ) >> 32 );
+    k0 = ( uint32_t ) seed;
+    k1 = ( uint32_t ) ( ( uint64_t ) seed >> 32 )
+      ^ ( uint32_t ) ( ( uint64_t ) step >> 32 );
+    for ( round = 0; round < 10; round++ )
+    {
+      p0 = ( uint64_t ) 0xD2511F53 * c0;
+      p1 = ( uint64_t ) 0xCD9E8D57 * c2;
+      c0 = ( uint32_t ) ( p1 >> 32 ) ^ c1 ^ k0;
+      c1 = ( uint32_t ) p1;
+      c2 = ( uint32_t ) ( p0 >> 32 ) ^ c3 ^ k1;
+      c3 = ( uint32_t ) p0;
+      k0 = k0 + 0x9E3779B9;
+      k1 = k1 + 0xBB67AE85;
+    }
+    z0[i] = ( ( double ) ( ( ( ( uint64_t ) c0 << 32 ) | c1 ) >> 11 ) + 0.5 )
+      / 9007199254740992.0;
+    z1[i] = ( ( double ) ( ( ( ( uint64_t ) c2 << 32 ) | c3 ) >> 11 ) + 0.5 )
+      / 9007199254740992.0;
+  }
+
+  for ( i = 0; i < count; i++ )
+  {
+    u1 = z0[i];
+    u2 = z1[i];
+    r = sqrt ( -2.0 * log ( u1 ) );
+    z0[i] = r * cos ( 6.283185307179586 * u2 );
+    z1[i] = r * sin ( 6.283185307179586 * u2 );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+int sde_run ( sde *s, int nthread )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SDE_RUN integrates all the paths and forms the moments.
+
+  Discussion:
+
+    Block B holds paths B*ODE_BLOCK onwards.  Its means and sums of
+    squared deviations are formed by two passes over the block, and the
+    blocks are then combined in order by the pairwise update of Chan,
+    Golub and LeVeque, which stays accurate for 10^6 paths and more.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, sde *S, the ensemble.  On output S->MEAN[O*N+J] and
+    S->VAR[O*N+J] are the mean and the sample variance of component J at
+    time T0 + O * NSTEP * H, and S->NFEV and S->NGEV count the
+    evaluations of F and G per path.
+
+    Input, int NTHREAD, the number of threads.
+
+    Output, int SDE_RUN, is 0, or 1 if the threads could not be started.
+*/
+{
+  int b;
+  double delta;
+  long m;
+  long na;
+  int nblock;
+  int nn = s->nout * s->n;
+  int o;
+  int status;
+
+  nblock = ( int ) ( ( s->npath + ODE_BLOCK - 1 ) / ODE_BLOCK );
+  s->bmean = ( double * ) malloc ( 2 * ( size_t ) nblock * nn
+    * sizeof ( double ) );
+  s->bm2 = s->bmean + ( size_t ) nblock * nn;
+
+  status = pool_run ( nthread, nblock, sde_task, s );
+
+  for ( o = 0; o < nn; o++ )
+  {
+    s->mean[o] = s->bmean[o];
+    s->var[o] = s->bm2[o];
+  }
+  na = ( ODE_BLOCK < s->npath ) ? ODE_BLOCK : s->npath;
+  for ( b = 1; b < nblock; b++ )
+  {
+    m = s->npath - ( long ) b * ODE_BLOCK;
+    if ( ODE_BLOCK < m )
+    {
+      m = ODE_BLOCK;
+    }
+    for ( o = 0; o < nn; o++ )
+    {
+      delta = s->bmean[(size_t)b*nn+o] - s->mean[o];
+      s->mean[o] = s->mean[o] + delta * m / ( double ) ( na + m );
+      s->var[o] = s->var[o] + s->bm2[(size_t)b*nn+o]
+        + delta * delta * ( ( double ) na * m / ( double ) ( na + m ) );
+    }
+    na = na + m;
+  }
+  for ( o = 0; o < nn; o++ )
+  {
+    s->var[o] = s->var[o] / ( double ) ( s->npath - 1 );
+  }
+
+  s->nfev = ( long ) s->nstep * ( s->nout - 1 );
+  s->ngev = ( ( s->method == SDE_SRK ) ? 2 : 1 ) * s->nfev;
+
+  free ( s->bmean );
+  s->bmean = NULL;
+  s->bm2 = NULL;
+
+  return ( status == 0 ) ? 0 : 1;
+}
+/******************************************************************************/
+
+static void sde_task ( int b, int thread, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SDE_TASK integrates block B of the paths, as a pool task.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int B, the block.
+
+    Input, int THREAD, the calling thread, not used.
+
+    Input, void *ARG, the ensemble.
+*/
+{
+  double *dg;
+  double *dw;
+  double *f;
+  long first;
+  double *g;
+  double *gs;
+  int i;
+  int j;
+  int k;
+  int ld = ODE_BLOCK;
+  int m;
+  double mean;
+  double m2;
+  int n;
+  int nn;
+  int o;
+  sde *s = ( sde * ) arg;
+  double sq;
+  long step;
+  double t;
+  double *work;
+  double *x;
+  double *xs;
+
+  n = s->n;
+  nn = s->nout * n;
+  first = ( long ) b * ld;
+  m = ( s->npath - first < ld ) ? ( int ) ( s->npath - first ) : ld;
+  sq = sqrt ( s->h );
+
+  work = ( double * ) malloc ( ( 7 * n + 1 ) * ld * sizeof ( double ) );
+  x = work;
+  f = x + n * ld;
+  g = f + n * ld;
+  dg = g + n * ld;
+  xs = dg + n * ld;
+  gs = xs + n * ld;
+  dw = gs + n * ld;
+
+  for ( j = 0; j < n; j++ )
+  {
+    for ( i = 0; i < m; i++ )
+    {
+      x[j*ld+i] = s->x0[j];
+    }
+  }
+
+  for ( o = 0; o < s->nout; o++ )
+  {
+    for ( k = 0; 0 < o && k < s->nstep; k++ )
+    {
+      step = ( long ) ( o - 1 ) * s->nstep + k;
+      t = s->t0 + step * s->h;
+/*
+  The increments, two components per call.
+*/
+      for ( j = 0; j < n; j = j + 2 )
+      {
+        sde_normal ( s->seed, step, j / 2, first, m, dw + j * ld,
+          dw + ( j + 1 ) * ld );
+      }
+      for ( j = 0; j < n * ld; j++ )
+      {
+        dw[j] = sq * dw[j];
+      }
+
+      s->f ( t, ( int ) first, m, ld, x, f, s->data );
+      s->g ( t, ( int ) first, m, ld, x, g,
+        ( s->method == SDE_MILSTEIN ) ? dg : NULL, s->data );
+
+      if ( s->method == SDE_MILSTEIN )
+      {
+        for ( j = 0; j < n; j++ )
+        {
+          for ( i = 0; i < m; i++ )
+          {
+            x[j*ld+i] = x[j*ld+i] + s->h * f[j*ld+i] + g[j*ld+i] * dw[j*ld+i]
+              + 0.5 * g[j*ld+i] * dg[j*ld+i]
+              * ( dw[j*ld+i] * dw[j*ld+i] - s->h );
+          }
+        }
+      }
+      else if ( s->method == SDE_SRK )
+      {
+        for ( j = 0; j < n; j++ )
+        {
+          for ( i = 0; i < m; i++ )
+          {
+            xs[j*ld+i] = x[j*ld+i] + s->h * f[j*ld+i] + sq * g[j*ld+i];
+          }
+        }
+        s->g ( t, ( int ) first, m, ld, xs, gs, NULL, s->data );
+        for ( j = 0; j < n; j++ )
+        {
+          for ( i = 0; i < m; i++ )
+          {
+            x[j*ld+i] = x[j*ld+i] + s->h * f[j*ld+i] + g[j*ld+i] * dw[j*ld+i]
+              + ( gs[j*ld+i] - g[j*ld+i] )
+              * ( dw[j*ld+i] * dw[j*ld+i] - s->h ) / ( 2.0 * sq );
+          }
+        }
+      }
+      else
+      {
+        for ( j = 0; j < n; j++ )
+        {
+          for ( i = 0; i < m; i++ )
+          {
+            x[j*ld+i] = x[j*ld+i] + s->h * f[j*ld+i] + g[j*ld+i] * dw[j*ld+i];
+          }
+        }
+      }
+    }
+/*
+  The moments of the block at output time O.
+*/
+    for ( j = 0; j < n; j++ )
+    {
+      mean = 0.0;
+      for ( i = 0; i < m; i++ )
+      {
+        mean = mean + x[j*ld+i];
+      }
+      mean = mean / m;
+      m2 = 0.0;
+      for ( i = 0; i < m; i++ )
+      {
+        m2 = m2 + ( x[j*ld+i] - mean ) * ( x[j*ld+i] - mean );
+      }
+      s->bmean[(size_t)b*nn+o*n+j] = mean;
+      s->bm2[(size_t)b*nn+o*n+j] = m2;
+    }
+  }
+
+  free ( work );
+
+  return;
+}
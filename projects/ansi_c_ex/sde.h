@@ -0,0 +1,77 @@
+/*
+  SDE integrates Monte Carlo ensembles of stochastic differential
+  equations with diagonal noise,
+
+    dX(J) = F(J) ( T, X ) dT + G(J) ( T, X ) dW(J),
+
+  and keeps only the mean and variance of every component at the output
+  times, never the paths:
+
+    s = sde_create ( SDE_MILSTEIN, f, g, n, t0, x0, h, nstep, nout,
+      npath, seed, data );
+    sde_run ( s, nthread );      s->mean, s->var at t0 + o * nstep * h
+    sde_free ( s );
+
+  The methods, all of strong order 1 for diagonal noise except EM:
+
+    SDE_EM        Euler-Maruyama, strong order 1/2, weak order 1;
+    SDE_MILSTEIN  adds 1/2 G dG/dX ( DW^2 - H ), which needs dG(J)/dX(J);
+    SDE_SRK       the derivative free Runge-Kutta form of Milstein's
+                  scheme, which takes the correction from a second value
+                  of G at the support point X + F H + G sqrt ( H ).
+
+  F has the form of the right hand side of RK4_ENSEMBLE and G the same
+  form, G ( T, FIRST, COUNT, LD, X, G, DG, DATA ), filling DG with
+  dG(J)/dX(J) unless it is NULL.  The paths advance ODE_BLOCK at a time,
+  stored as structure of arrays, so the loops over paths vectorize.
+
+  The increments come from Philox4x32-10, a counter based generator:
+  the normals of path I at step K are a fixed function of ( SEED, K, I ),
+  so no generator state is kept or shared.  Each block of paths is one
+  task of POOL_RUN, its moments are kept per block, and the blocks are
+  merged in order at the end, so the results are the same, bit for bit,
+  whatever the number of threads.
+*/
+# ifndef SDE_H
+# define SDE_H
+
+# include "ode.h"
+
+# define SDE_EM 1
+# define SDE_MILSTEIN 2
+# define SDE_SRK 3
+
+typedef void sde_diff ( double t, int first, int count, int ld, double x[],
+  double g[], double dg[], void *data );
+
+typedef struct
+{
+  int method;
+  ode_ens_rhs *f;
+  sde_diff *g;
+  void *data;
+  int n;
+  double t0;
+  double *x0;
+  double h;
+  int nstep;
+  int nout;
+  long npath;
+  unsigned long seed;
+  double *mean;
+  double *var;
+  double *bmean;
+  double *bm2;
+  long nfev;
+  long ngev;
+} sde;
+
+sde *sde_create ( int method, ode_ens_rhs *f, sde_diff *g, int n, double t0,
+  double x0[], double h, int nstep, int nout, long npath,
+  unsigned long seed, void *data );
+void sde_free ( sde *s );
+void sde_normal ( unsigned long seed, long step, int pair, long first,
+  int count, double z0[], double z1[] );
+int sde_run ( sde *s, int nthread );
+
+# endif
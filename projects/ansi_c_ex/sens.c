@@ -0,0 +1,182 @@
+# include <stdlib.h>
+# include <stdio.h>
+
+# include "sens.h"
+
+/******************************************************************************/
+
+sens *sens_create ( ode_rhs *f, sens_jvp *jvp, int n, int ns, int param[],
+  double t, double x[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SENS_CREATE sets up the forward sensitivities of an ODE.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, sens_jvp *JVP, its Jacobian vector products.
+
+    Input, int N, the number of components.
+
+    Input, int NS, the number of sensitivities.
+
+    Input, int PARAM[NS], what each sensitivity is with respect to: a
+    parameter index of JVP, or SENS_X0(I) for the starting value X0(I).
+    It is copied.
+
+    Input, double T, X[N], the starting point.
+
+    Input, void *DATA, passed to F and JVP.
+
+    Output, sens *SENS_CREATE, the sensitivity integrator, with S->Y
+    holding the state and the starting sensitivities.
+*/
+{
+  int i;
+  int k;
+  sens *s;
+
+  s = ( sens * ) malloc ( sizeof ( sens ) );
+  s->f = f;
+  s->jvp = jvp;
+  s->data = data;
+  s->n = n;
+  s->ns = ns;
+  s->param = ( int * ) malloc ( ns * sizeof ( int ) );
+  s->t = t;
+  s->y = ( double * ) malloc ( 4 * ( ns + 1 ) * n * sizeof ( double ) );
+  s->work = s->y + ( ns + 1 ) * n;
+  s->nfev = 0;
+  s->njvp = 0;
+
+  for ( i = 0; i < n; i++ )
+  {
+    s->y[i] = x[i];
+  }
+  for ( k = 0; k < ns; k++ )
+  {
+    s->param[k] = param[k];
+    for ( i = 0; i < n; i++ )
+    {
+      s->y[(k+1)*n+i] = ( param[k] == SENS_X0 ( i ) ) ? 1.0 : 0.0;
+    }
+  }
+
+  return s;
+}
+/******************************************************************************/
+
+void sens_free ( sens *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SENS_FREE frees a sensitivity integrator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, sens *S, the sensitivity integrator.
+*/
+{
+  free ( s->param );
+  free ( s->y );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+void sens_rhs ( double t, double y[], double yp[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SENS_RHS is the right hand side of the state and its sensitivities.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double T, the time.
+
+    Input, double Y[(NS+1)*N], the state and the sensitivities.
+
+    Output, double YP[(NS+1)*N], their derivatives.
+
+    Input, void *DATA, the sens structure.
+*/
+{
+  int k;
+  int n;
+  sens *s = ( sens * ) data;
+
+  n = s->n;
+  s->f ( t, y, yp, s->data );
+  for ( k = 0; k < s->ns; k++ )
+  {
+    s->jvp ( t, y, y + ( k + 1 ) * n, s->param[k], yp + ( k + 1 ) * n,
+      s->data );
+  }
+  s->nfev = s->nfev + 1;
+  s->njvp = s->njvp + s->ns;
+
+  return;
+}
+/******************************************************************************/
+
+void sens_step ( sens *s, double h )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SENS_STEP takes one RK4 step of the state and its sensitivities.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, sens *S, the sensitivity integrator.
+
+    Input, double H, the step size.
+*/
+{
+  rk4_step ( sens_rhs, ( s->ns + 1 ) * s->n, s->t, h, s->y, s->work, s );
+  s->t = s->t + h;
+
+  return;
+}
@@ -0,0 +1,67 @@
+/*
+  SENS integrates the forward sensitivities of an ODE X' = F(T,X,P)
+  along with its state: S(K) = dX/dP(J) for a parameter P(J), or
+  dX/dX0(I) for a starting value, obeys the variational equation
+
+    S(K)' = dF/dX S(K) + dF/dP(J),   S(K)(T0) = 0, or E(I) for X0(I).
+
+  The state and the NS sensitivities form one vector
+
+    Y = [ X, S(0), ..., S(NS-1) ],   ( NS + 1 ) * N values,
+
+  whose right hand side is SENS_RHS, an ordinary ode_rhs, so any of the
+  integrators can take it, with the sensitivities computed in the same
+  stages as the state:
+
+    s = sens_create ( f, jvp, n, ns, param, t, x, data );
+    sens_step ( s, h );                          fixed RK4 steps, or
+    d = dopri_create ( sens_rhs, ( ns + 1 ) * n, s->t, s->y, atol, rtol, s );
+
+  With fixed RK4 steps the sensitivities are the exact derivatives of
+  the discrete solution, the same as differentiating the program.
+
+  The Jacobian never has to be formed.  The caller provides the
+  products JVP ( T, X, V, J, JV, DATA ), which must set
+
+    JV = dF/dX V + dF/dP(J),    or JV = dF/dX V when J < 0,
+
+  which for most right hand sides is a few lines next to F itself.  Each
+  stage costs one F and NS products, much less than the NS further
+  integrations that finite differences need, and without their
+  cancellation error.
+
+  PARAM[K] = J >= 0 makes S(K) the sensitivity to the parameter J of the
+  JVP; PARAM[K] = SENS_X0(I) makes it that to X0(I).
+*/
+# ifndef SENS_H
+# define SENS_H
+
+# include "ode.h"
+
+# define SENS_X0(i) ( -1 - ( i ) )
+
+typedef void sens_jvp ( double t, double x[], double v[], int j, double jv[],
+  void *data );
+
+typedef struct
+{
+  ode_rhs *f;
+  sens_jvp *jvp;
+  void *data;
+  int n;
+  int ns;
+  int *param;
+  double t;
+  double *y;
+  double *work;
+  long nfev;
+  long njvp;
+} sens;
+
+sens *sens_create ( ode_rhs *f, sens_jvp *jvp, int n, int ns, int param[],
+  double t, double x[], void *data );
+void sens_free ( sens *s );
+void sens_rhs ( double t, double y[], double yp[], void *data );
+void sens_step ( sens *s, double h );
+
+# endif
@@ -0,0 +1,728 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <math.h>
+
+# include "shoot.h"
+# include "pool.h"
+
+typedef struct
+{
+  shoot *sh;
+  pool *pool;
+  double *s;
+  long *nfev;
+  long *njvp;
+} shoot_job;
+
+static double shoot_defect ( shoot *sh, double s[], double d[] );
+static int shoot_gauss ( int n, double a[], double b[] );
+static int shoot_integrate ( shoot_job *job, double s[] );
+static void shoot_segment ( int k, int thread, void *arg );
+static int shoot_step ( shoot *sh, double d[], double ds[] );
+
+/******************************************************************************/
+
+shoot *shoot_create ( ode_rhs *f, sens_jvp *jvp, shoot_bc *bc, int n,
+  double xa, double xb, int nseg, int nstep, void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_CREATE sets up a boundary value problem for multiple shooting.
+
+  Discussion:
+
+    The starting values SH->S are set to zero; any better guess should
+    be stored there before SHOOT_RUN.  The defaults are NTHREAD = 1,
+    TOL = 1.0E-10 and MAXITER = 20.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, sens_jvp *JVP, its Jacobian vector products, called only with
+    J = SENS_X0(I), or NULL.
+
+    Input, shoot_bc *BC, the boundary conditions.
+
+    Input, int N, the number of components.
+
+    Input, double XA, XB, the ends of the interval.
+
+    Input, int NSEG, the number of segments.
+
+    Input, int NSTEP, the number of RK4 steps per segment.
+
+    Input, void *DATA, passed to F, JVP and BC.
+
+    Output, shoot *SHOOT_CREATE, the problem.
+*/
+{
+  int i;
+  shoot *sh;
+
+  sh = ( shoot * ) malloc ( sizeof ( shoot ) );
+  sh->f = f;
+  sh->jvp = jvp;
+  sh->bc = bc;
+  sh->data = data;
+  sh->n = n;
+  sh->xa = xa;
+  sh->xb = xb;
+  sh->nseg = nseg;
+  sh->nstep = nstep;
+  sh->nthread = 1;
+  sh->tol = 1.0E-10;
+  sh->maxiter = 20;
+  sh->s = ( double * ) malloc ( ( 5 * nseg * n + nseg * n * n
+    + 5 * n * n + 5 * n ) * sizeof ( double ) );
+  sh->phi = sh->s + nseg * n;
+  sh->g = sh->phi + nseg * n;
+  sh->work = sh->g + nseg * n * n;
+  sh->iter = 0;
+  sh->nhalf = 0;
+  sh->res = 0.0;
+  sh->nfev = 0;
+  sh->njvp = 0;
+
+  for ( i = 0; i < nseg * n; i++ )
+  {
+    sh->s[i] = 0.0;
+  }
+
+  return sh;
+}
+/******************************************************************************/
+
+static double shoot_defect ( shoot *sh, double s[], double d[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_DEFECT evaluates the matching and boundary conditions.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, shoot *SH, the problem, with SH->PHI integrated from S.
+
+    Input, double S[NSEG*N], the starting values.
+
+    Output, double D[NSEG*N], PHI(K) - S(K+1) for K < NSEG-1, then
+    R ( S(0), PHI(NSEG-1) ).
+
+    Output, double SHOOT_DEFECT, the largest entry of |D|, or HUGE_VAL
+    if one is not finite.
+*/
+{
+  int i;
+  int n = sh->n;
+  int nn = sh->nseg * n;
+  double res;
+
+  for ( i = 0; i < nn - n; i++ )
+  {
+    d[i] = sh->phi[i] - s[i+n];
+  }
+  sh->bc ( s, sh->phi + nn - n, d + nn - n, sh->data );
+
+  res = 0.0;
+  for ( i = 0; i < nn; i++ )
+  {
+    if ( !( fabs ( d[i] ) <= res ) )
+    {
+      res = fabs ( d[i] );
+    }
+  }
+  if ( !( res < HUGE_VAL ) )
+  {
+    res = HUGE_VAL;
+  }
+
+  return res;
+}
+/******************************************************************************/
+
+void shoot_free ( shoot *sh )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_FREE frees a boundary value problem.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, shoot *SH, the problem.
+*/
+{
+  free ( sh->s );
+  free ( sh );
+
+  return;
+}
+/******************************************************************************/
+
+static int shoot_gauss ( int n, double a[], double b[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_GAUSS solves A X = B by Gauss elimination with partial pivoting.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int N, the order.
+
+    Input/output, double A[N*N], the matrix, by rows; destroyed.
+
+    Input/output, double B[N], the right hand side, replaced by X.
+
+    Output, int SHOOT_GAUSS, is 0, or 1 if A is singular.
+*/
+{
+  int i;
+  int j;
+  int k;
+  int p;
+  double t;
+
+  for ( k = 0; k < n; k++ )
+  {
+    p = k;
+    for ( i = k + 1; i < n; i++ )
+    {
+      if ( fabs ( a[p*n+k] ) < fabs ( a[i*n+k] ) )
+      {
+        p = i;
+      }
+    }
+    if ( a[p*n+k] == 0.0 )
+    {
+      return 1;
+    }
+    if ( p != k )
+    {
+      for ( j = k; j < n; j++ )
+      {
+        t = a[k*n+j];
+        a[k*n+j] = a[p*n+j];
+        a[p*n+j] = t;
+      }
+      t = b[k];
+      b[k] = b[p];
+      b[p] = t;
+    }
+    for ( i = k + 1; i < n; i++ )
+    {
+      t = a[i*n+k] / a[k*n+k];
+      for ( j = k + 1; j < n; j++ )
+      {
+        a[i*n+j] = a[i*n+j] - t * a[k*n+j];
+      }
+      b[i] = b[i] - t * b[k];
+    }
+  }
+  for ( k = n - 1; 0 <= k; k-- )
+  {
+    for ( j = k + 1; j < n; j++ )
+    {
+      b[k] = b[k] - a[k*n+j] * b[j];
+    }
+    b[k] = b[k] / a[k*n+k];
+  }
+
+  return 0;
+}
+/******************************************************************************/
+
+static int shoot_integrate ( shoot_job *job, double s[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_INTEGRATE integrates all the segments, in parallel.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, shoot_job *JOB, the problem, the pool and the counters of the
+    segments.
+
+    Input, double S[NSEG*N], the starting values; SH->PHI and SH->G
+    are set from them.
+
+    Output, int SHOOT_INTEGRATE, is 0, or 1 if the threads could not be
+    started.
+*/
+{
+  int k;
+  shoot *sh = job->sh;
+  int status;
+
+  job->s = s;
+  status = pool_exec ( job->pool, sh->nseg, shoot_segment, job );
+
+  for ( k = 0; k < sh->nseg; k++ )
+  {
+    sh->nfev = sh->nfev + job->nfev[k];
+    sh->njvp = sh->njvp + job->njvp[k];
+  }
+
+  return ( status == 0 ) ? 0 : 1;
+}
+/******************************************************************************/
+
+int shoot_run ( shoot *sh )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_RUN solves the boundary value problem by Newton's method.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input/output, shoot *SH, the problem.  On input SH->S holds the
+    guess.  On output SH->S[K*N+I] is Y(I) at the left end of segment K,
+    SH->PHI[(NSEG-1)*N+I] is Y(I) at XB, SH->RES is the largest defect,
+    SH->ITER the number of Newton steps and SH->NHALF the number of
+    times a step was halved.
+
+    Output, int SHOOT_RUN, is 0 if the defects fell below SH->TOL or the
+    steps became negligible, or 1 if not.
+*/
+{
+  double *d;
+  double *ds;
+  int half;
+  int i;
+  shoot_job job;
+  double lambda;
+  int n = sh->n;
+  int nn = sh->nseg * n;
+  double res;
+  int status;
+  double *st;
+  double step;
+
+  d = sh->work;
+  ds = d + nn;
+  st = ds + nn;
+
+  job.sh = sh;
+  job.pool = pool_create ( sh->nthread );
+  job.nfev = ( long * ) malloc ( 2 * sh->nseg * sizeof ( long ) );
+  job.njvp = job.nfev + sh->nseg;
+
+  sh->nfev = 0;
+  sh->njvp = 0;
+  sh->nhalf = 0;
+  shoot_integrate ( &job, sh->s );
+  sh->res = shoot_defect ( sh, sh->s, d );
+  status = 1;
+
+  for ( sh->iter = 0; sh->iter < sh->maxiter; sh->iter++ )
+  {
+    if ( sh->res <= sh->tol )
+    {
+      status = 0;
+      break;
+    }
+    if ( shoot_step ( sh, d, ds ) != 0 )
+    {
+      fprintf ( stderr, "SHOOT_RUN: the Newton matrix is singular.\n" );
+      break;
+    }
+/*
+  Halve the step until the largest defect goes down.
+*/
+    lambda = 1.0;
+    for ( half = 0; half <= 10; half++ )
+    {
+      for ( i = 0; i < nn; i++ )
+      {
+        st[i] = sh->s[i] + lambda * ds[i];
+      }
+      shoot_integrate ( &job, st );
+      res = shoot_defect ( sh, st, d );
+      if ( res < sh->res )
+      {
+        break;
+      }
+      lambda = lambda / 2.0;
+    }
+    if ( 10 < half )
+    {
+      break;
+    }
+    sh->nhalf = sh->nhalf + half;
+
+    step = 0.0;
+    for ( i = 0; i < nn; i++ )
+    {
+      step = fmax ( step, fabs ( st[i] - sh->s[i] )
+        / ( 1.0 + fabs ( sh->s[i] ) ) );
+      sh->s[i] = st[i];
+    }
+    sh->res = res;
+    if ( step <= sh->tol && lambda == 1.0 )
+    {
+      sh->iter++;
+      status = 0;
+      break;
+    }
+  }
+/*
+  A failed step leaves SH->PHI at the trial point; bring it back.
+*/
+  if ( status != 0 )
+  {
+    shoot_integrate ( &job, sh->s );
+    sh->res = shoot_defect ( sh, sh->s, d );
+  }
+
+  pool_free ( job.pool );
+  free ( job.nfev );
+
+  return status;
+}
+/******************************************************************************/
+
+static void shoot_segment ( int k, int thread, void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_SEGMENT integrates segment K, as a pool task.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int K, the segment.
+
+    Input, int THREAD, the calling thread, not used.
+
+    Input, void *ARG, the shoot_job.
+*/
+{
+  double delta;
+  double *g;
+  double h;
+  int i;
+  shoot_job *job = ( shoot_job * ) arg;
+  int l;
+  int n;
+  int *param;
+  double *phi;
+  int r;
+  sens *se;
+  shoot *sh = job->sh;
+  double *x0;
+  double xk;
+
+  n = sh->n;
+  h = ( sh->xb - sh->xa ) / sh->nseg;
+  xk = sh->xa + k * h;
+  h = h / sh->nstep;
+  phi = sh->phi + k * n;
+  g = sh->g + k * n * n;
+  job->nfev[k] = 0;
+  job->njvp[k] = 0;
+
+  if ( sh->jvp != NULL )
+  {
+    param = ( int * ) malloc ( n * sizeof ( int ) );
+    for ( i = 0; i < n; i++ )
+    {
+      param[i] = SENS_X0 ( i );
+    }
+    se = sens_create ( sh->f, sh->jvp, n, n, param, xk, job->s + k * n,
+      sh->data );
+    for ( l = 0; l < sh->nstep; l++ )
+    {
+      sens_step ( se, h );
+    }
+    for ( r = 0; r < n; r++ )
+    {
+      phi[r] = se->y[r];
+      for ( i = 0; i < n; i++ )
+      {
+        g[r*n+i] = se->y[(i+1)*n+r];
+      }
+    }
+    job->nfev[k] = se->nfev;
+    job->njvp[k] = se->njvp;
+    sens_free ( se );
+    free ( param );
+    return;
+  }
+/*
+  Without products, one run from S(K) and one from each perturbed value.
+*/
+  x0 = ( double * ) malloc ( n * sizeof ( double ) );
+  for ( i = -1; i < n; i++ )
+  {
+    for ( r = 0; r < n; r++ )
+    {
+      x0[r] = job->s[k*n+r];
+    }
+    delta = 0.0;
+    if ( 0 <= i )
+    {
+      delta = 1.0E-07 * ( 1.0 + fabs ( x0[i] ) );
+      x0[i] = x0[i] + delta;
+    }
+    se = sens_create ( sh->f, NULL, n, 0, NULL, xk, x0, sh->data );
+    for ( l = 0; l < sh->nstep; l++ )
+    {
+      sens_step ( se, h );
+    }
+    for ( r = 0; r < n; r++ )
+    {
+      if ( i < 0 )
+      {
+        phi[r] = se->y[r];
+      }
+      else
+      {
+        g[r*n+i] = ( se->y[r] - phi[r] ) / delta;
+      }
+    }
+    job->nfev[k] = job->nfev[k] + se->nfev;
+    sens_free ( se );
+  }
+  free ( x0 );
+
+  return;
+}
+/******************************************************************************/
+
+static int shoot_step ( shoot *sh, double d[], double ds[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHOOT_STEP finds the Newton correction of the starting values.
+
+  Discussion:
+
+    The correction satisfies G(K) DS(K) - DS(K+1) = -D(K) for the
+    matching conditions and BA DS(0) + BB G(NSEG-1) DS(NSEG-1) = -R for
+    the boundary conditions.  Running along the segments,
+    DS(K) = E(K) DS(0) + W(K), with E(0) = I, W(0) = 0,
+    E(K+1) = G(K) E(K) and W(K+1) = G(K) W(K) + D(K); substituting into
+    the boundary conditions leaves ( BA + BB E ) DS(0) = -R - BB W, with
+    E and W taken one segment past the last.  BA and BB are differences
+    of R.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, shoot *SH, the problem, with SH->PHI and SH->G at SH->S.
+
+    Input, double D[NSEG*N], the defects at SH->S.
+
+    Output, double DS[NSEG*N], the correction.
+
+    Output, int SHOOT_STEP, is 0, or 1 if the N by N system is
+    singular.
+*/
+{
+  double *a;
+  double *ba;
+  double *bb;
+  double delta;
+  double *e;
+  double *g;
+  int i;
+  int j;
+  int k;
+  int l;
+  int n = sh->n;
+  int nn = sh->nseg * n;
+  double *rr;
+  double *t;
+  double *w;
+  double *ya;
+  double *yb;
+
+  e = sh->work + 3 * nn;
+  t = e + n * n;
+  a = t + n * n;
+  ba = a + n * n;
+  bb = ba + n * n;
+  w = bb + n * n;
+  rr = w + n;
+  ya = rr + n;
+  yb = ya + n;
+/*
+  BA(I,J) = dR(I)/dYA(J) and BB(I,J) = dR(I)/dYB(J).
+*/
+  for ( j = 0; j < n; j++ )
+  {
+    ya[j] = sh->s[j];
+    yb[j] = sh->phi[nn-n+j];
+  }
+  for ( j = 0; j < n; j++ )
+  {
+    delta = 1.0E-07 * ( 1.0 + fabs ( ya[j] ) );
+    ya[j] = ya[j] + delta;
+    sh->bc ( ya, yb, rr, sh->data );
+    ya[j] = sh->s[j];
+    for ( i = 0; i < n; i++ )
+    {
+      ba[i*n+j] = ( rr[i] - d[nn-n+i] ) / delta;
+    }
+    delta = 1.0E-07 * ( 1.0 + fabs ( yb[j] ) );
+    yb[j] = yb[j] + delta;
+    sh->bc ( ya, yb, rr, sh->data );
+    yb[j] = sh->phi[nn-n+j];
+    for ( i = 0; i < n; i++ )
+    {
+      bb[i*n+j] = ( rr[i] - d[nn-n+i] ) / delta;
+    }
+  }
+/*
+  E and W, one segment at a time.
+*/
+  for ( i = 0; i < n; i++ )
+  {
+    for ( j = 0; j < n; j++ )
+    {
+      e[i*n+j] = ( i == j ) ? 1.0 : 0.0;
+    }
+    w[i] = 0.0;
+  }
+  for ( k = 0; k < sh->nseg; k++ )
+  {
+    g = sh->g + k * n * n;
+    for ( i = 0; i < n; i++ )
+    {
+      rr[i] = ( k < sh->nseg - 1 ) ? d[k*n+i] : 0.0;
+      for ( j = 0; j < n; j++ )
+      {
+        t[i*n+j] = 0.0;
+        rr[i] = rr[i] + g[i*n+j] * w[j];
+      }
+      for ( l = 0; l < n; l++ )
+      {
+        for ( j = 0; j < n; j++ )
+        {
+          t[i*n+j] = t[i*n+j] + g[i*n+l] * e[l*n+j];
+        }
+      }
+    }
+    for ( i = 0; i < n; i++ )
+    {
+      w[i] = rr[i];
+      for ( j = 0; j < n; j++ )
+      {
+        e[i*n+j] = t[i*n+j];
+      }
+    }
+  }
+/*
+  ( BA + BB E ) DS(0) = -R - BB W.
+*/
+  for ( i = 0; i < n; i++ )
+  {
+    ds[i] = -d[nn-n+i];
+    for ( j = 0; j < n; j++ )
+    {
+      ds[i] = ds[i] - bb[i*n+j] * w[j];
+      a[i*n+j] = ba[i*n+j];
+      for ( l = 0; l < n; l++ )
+      {
+        a[i*n+j] = a[i*n+j] + bb[i*n+l] * e[l*n+j];
+      }
+    }
+  }
+  if ( shoot_gauss ( n, a, ds ) != 0 )
+  {
+    return 1;
+  }
+/*
+  DS(K+1) = G(K) DS(K) + D(K).
+*/
+  for ( k = 0; k < sh->nseg - 1; k++ )
+  {
+    g = sh->g + k * n * n;
+    for ( i = 0; i < n; i++ )
+    {
+      ds[(k+1)*n+i] = d[k*n+i];
+      for ( j = 0; j < n; j++ )
+      {
+        ds[(k+1)*n+i] = ds[(k+1)*n+i] + g[i*n+j] * ds[k*n+j];
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+/*
+  SHOOT solves two point boundary value problems
+
+    Y' = F ( X, Y ),  XA <= X <= XB,  R ( Y(XA), Y(XB) ) = 0,
+
+  with N components and N boundary conditions R, linear or not, by
+  multiple shooting:
+
+    sh = shoot_create ( f, jvp, bc, n, xa, xb, nseg, nstep, data );
+    ... a guess of Y at the start of each segment in sh->s ...
+    sh->nthread = 8;
+    shoot_run ( sh );             Y at the nodes is in sh->s and sh->phi
+    shoot_free ( sh );
+
+  [XA,XB] is cut into NSEG equal segments, and the unknowns are the
+  values S(K) of Y at their left ends.  Segment K is integrated from
+  S(K) by NSTEP RK4 steps to PHI(K), with the sensitivities
+  G(K) = dPHI(K)/dS(K) carried along by SENS, and the segments are
+  independent, so they run at once as pool tasks; one pool serves all
+  the Newton steps of a run.  If JVP is NULL, G(K) is formed by
+  differences of N more runs per segment instead.
+
+  Newton's method is applied to the matching conditions
+  PHI(K) - S(K+1) = 0 and to R ( S(0), PHI(NSEG-1) ) = 0.  Their
+  Jacobian is block bidiagonal, G(K) and -I, apart from the boundary
+  blocks, and the Newton step is found by running along the blocks:
+  DS(K+1) = G(K) DS(K) + PHI(K) - S(K+1) expresses every correction in
+  terms of DS(0), which is found from an N by N system with the
+  boundary conditions, at a cost of NSEG N^3 operations.  The step is
+  halved, up to 10 times, while it does not lower the largest defect;
+  SH->NHALF counts the halvings of a run.
+
+  BC ( YA, YB, R, DATA ) fills R[0:N-1]; its derivatives are taken by
+  differences.
+*/
+# ifndef SHOOT_H
+# define SHOOT_H
+
+# include "sens.h"
+
+typedef void shoot_bc ( double ya[], double yb[], double r[], void *data );
+
+typedef struct
+{
+  ode_rhs *f;
+  sens_jvp *jvp;
+  shoot_bc *bc;
+  void *data;
+  int n;
+  double xa;
+  double xb;
+  int nseg;
+  int nstep;
+  int nthread;
+  double tol;
+  int maxiter;
+  double *s;
+  double *phi;
+  double *g;
+  double *work;
+  int iter;
+  int nhalf;
+  double res;
+  long nfev;
+  long njvp;
+} shoot;
+
+shoot *shoot_create ( ode_rhs *f, sens_jvp *jvp, shoot_bc *bc, int n,
+  double xa, double xb, int nseg, int nstep, void *data );
+void shoot_free ( shoot *sh );
+int shoot_run ( shoot *sh );
+
+# endif
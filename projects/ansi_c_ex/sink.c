@@ -0,0 +1,990 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <string.h>
+# include <math.h>
+# include <float.h>
+# include <pthread.h>
+# include <stdatomic.h>
+
+# include "sink.h"
+/*
+  The bytes in front of the rows of a chunk, "CHNK", R, KEYFIRST, KEYLAST.
+*/
+# define SINK_CHUNK_HEAD 24
+/*
+  The buffers of an asynchronous sink.  HEAD counts the buffers handed to
+  the writer and TAIL those it has written; buffer K is BUF[K%NBUF].  Only
+  the producer stores HEAD and only the writer stores TAIL, without a
+  lock.  LOCK is only taken to sleep or to wake a sleeper: the writer
+  sleeps on READY while the ring is empty, with WSLEEP set, and the
+  producer on ROOM while it is full, with PSLEEP set.  DONE is guarded
+  by LOCK.
+*/
+struct sink_pipe
+{
+  int nbuf;
+  char **buf;
+  size_t *len;
+  atomic_ulong head;
+  atomic_ulong tail;
+  atomic_int wsleep;
+  atomic_int psleep;
+  int done;
+  pthread_mutex_t lock;
+  pthread_cond_t ready;
+  pthread_cond_t room;
+  pthread_t thread;
+  FILE *fp;
+};
+
+static void sink_chunk ( sink *s );
+static void sink_flush ( sink *s );
+static void sink_header ( sink *s );
+static void sink_le ( unsigned char *b, void *data, int size );
+static void *sink_writer ( void *arg );
+
+/******************************************************************************/
+
+int sink_async ( sink *s, int nbuf )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_ASYNC hands the writing of a sink to a background thread.
+
+  Discussion:
+
+    The sink then has NBUF buffers of the same size.  When the one being
+    filled is full it is passed to the writer thread, and filling goes on
+    in the next; the integration only waits, and S->NWAIT is only
+    incremented, if all NBUF buffers are still waiting to be written, so
+    a slow disk slows the producer down instead of letting memory grow.
+    SINK_CLOSE hands over the last buffer and waits until everything is
+    written.
+
+    The hand over is lock free while both sides keep up.  A side that
+    has to wait blocks on a condition variable, so an idle writer, or a
+    producer held back by the disk, uses no processor time, and the
+    other side only takes the mutex to wake it.
+
+    It must be called before the first row.  It does nothing in SINK_OFF
+    and SINK_SUMMARY modes.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input/output, sink *S, the sink.
+
+    Input, int NBUF, the number of buffers, at least 2.
+
+    Output, int SINK_ASYNC, is 0 on success, or 1 if the thread could not
+    be started, in which case the sink keeps writing by itself.
+*/
+{
+  int k;
+  struct sink_pipe *p;
+
+  if ( s->buf == NULL || s->pipe != NULL )
+  {
+    return 0;
+  }
+  if ( nbuf < 2 )
+  {
+    nbuf = 2;
+  }
+
+  p = ( struct sink_pipe * ) malloc ( sizeof ( struct sink_pipe ) );
+  p->nbuf = nbuf;
+  p->buf = ( char ** ) malloc ( nbuf * sizeof ( char * ) );
+  p->len = ( size_t * ) malloc ( nbuf * sizeof ( size_t ) );
+  p->buf[0] = s->buf;
+  for ( k = 1; k < nbuf; k++ )
+  {
+    p->buf[k] = ( char * ) malloc ( s->size );
+  }
+  atomic_init ( &p->head, 0 );
+  atomic_init ( &p->tail, 0 );
+  atomic_init ( &p->wsleep, 0 );
+  atomic_init ( &p->psleep, 0 );
+  p->done = 0;
+  pthread_mutex_init ( &p->lock, NULL );
+  pthread_cond_init ( &p->ready, NULL );
+  pthread_cond_init ( &p->room, NULL );
+  p->fp = s->fp;
+
+  if ( pthread_create ( &p->thread, NULL, sink_writer, p ) != 0 )
+  {
+    pthread_mutex_destroy ( &p->lock );
+    pthread_cond_destroy ( &p->ready );
+    pthread_cond_destroy ( &p->room );
+    for ( k = 1; k < nbuf; k++ )
+    {
+      free ( p->buf[k] );
+    }
+    free ( p->buf );
+    free ( p->len );
+    free ( p );
+    return 1;
+  }
+  s->pipe = p;
+
+  return 0;
+}
+/******************************************************************************/
+
+static void sink_chunk ( sink *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_CHUNK writes the buffered rows of a SINK_TRAJ sink as one chunk.
+
+  Discussion:
+
+    The rows are kept after room for the chunk header, so a chunk goes
+    out, or to the writer thread, as one block.  The file header goes
+    out first, with the first chunk, so that S->KEY can still be set
+    after SINK_OPEN; no block has been handed to a writer thread yet, so
+    the two never write at the same time.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, sink *S, the sink.  The buffer is emptied.
+*/
+{
+  unsigned char *h;
+  unsigned int r;
+
+  if ( !s->head )
+  {
+    sink_header ( s );
+  }
+  if ( s->len == SINK_CHUNK_HEAD )
+  {
+    return;
+  }
+
+  r = ( unsigned int ) ( ( s->len - SINK_CHUNK_HEAD )
+    / ( s->ncol * sizeof ( double ) ) );
+  if ( s->key < 0 || s->ncol <= s->key )
+  {
+    s->kfirst = 0.0;
+    s->klast = 0.0;
+  }
+  h = ( unsigned char * ) s->buf;
+  memcpy ( h, "CHNK", 4 );
+  sink_le ( h + 4, &r, 4 );
+  sink_le ( h + 8, &s->kfirst, 8 );
+  sink_le ( h + 16, &s->klast, 8 );
+  sink_flush ( s );
+  s->len = SINK_CHUNK_HEAD;
+
+  return;
+}
+/******************************************************************************/
+
+void sink_close ( sink *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_CLOSE flushes and closes a results sink.
+
+  Discussion:
+
+    In SINK_SUMMARY mode, this is where the summary is printed, and in
+    SINK_TRAJ mode the last, partial, chunk is written.  An asynchronous
+    sink waits here for its writer thread.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, sink *S, the sink.
+*/
+{
+  int j;
+
+  if ( s->mode == SINK_SUMMARY )
+  {
+    fprintf ( s->fp, "  %ld rows\n", s->rows );
+    for ( j = 0; j < s->ncol && 0 < s->rows; j++ )
+    {
+      fprintf ( s->fp, "  %-12s  min = %14g  max = %14g\n", 
+        s->names[j], s->cmin[j], s->cmax[j] );
+    }
+  }
+
+  if ( s->mode == SINK_TRAJ )
+  {
+    sink_chunk ( s );
+  }
+  else if ( 0 < s->len )
+  {
+    sink_flush ( s );
+  }
+/*
+  Let the writer finish.
+*/
+  if ( s->pipe != NULL )
+  {
+    pthread_mutex_lock ( &s->pipe->lock );
+    s->pipe->done = 1;
+    pthread_cond_signal ( &s->pipe->ready );
+    pthread_mutex_unlock ( &s->pipe->lock );
+    pthread_join ( s->pipe->thread, NULL );
+    pthread_mutex_destroy ( &s->pipe->lock );
+    pthread_cond_destroy ( &s->pipe->ready );
+    pthread_cond_destroy ( &s->pipe->room );
+    for ( j = 0; j < s->pipe->nbuf; j++ )
+    {
+      free ( s->pipe->buf[j] );
+    }
+    free ( s->pipe->buf );
+    free ( s->pipe->len );
+    free ( s->pipe );
+    s->buf = NULL;
+  }
+
+  if ( s->own )
+  {
+    fclose ( s->fp );
+  }
+  else if ( s->fp != NULL )
+  {
+    fflush ( s->fp );
+  }
+
+  free ( s->buf );
+  free ( s->cmin );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+static void sink_flush ( sink *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_FLUSH writes out the buffer of a sink and empties it.
+
+  Discussion:
+
+    With a writer thread, the buffer is handed over and S->BUF becomes
+    the next one, once it has been written; that wait is the
+    backpressure.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input/output, sink *S, the sink.
+*/
+{
+  unsigned long h;
+  struct sink_pipe *p = s->pipe;
+
+  if ( p == NULL )
+  {
+    fwrite ( s->buf, 1, s->len, s->fp );
+    s->len = 0;
+    return;
+  }
+
+  h = atomic_load_explicit ( &p->head, memory_order_relaxed );
+  p->len[h%p->nbuf] = s->len;
+/*
+  Publish the buffer, then wake the writer if it sleeps.  Both this
+  store and the load of WSLEEP are sequentially consistent, as are the
+  writer's store of WSLEEP and its load of HEAD, so either the writer
+  sees the buffer or this side sees it asleep; no wakeup is lost.
+*/
+  atomic_store ( &p->head, h + 1 );
+  if ( atomic_load ( &p->wsleep ) )
+  {
+    pthread_mutex_lock ( &p->lock );
+    pthread_cond_signal ( &p->ready );
+    pthread_mutex_unlock ( &p->lock );
+  }
+/*
+  Wait while every buffer is still unwritten.
+*/
+  if ( ( unsigned long ) p->nbuf <= h + 1 - atomic_load ( &p->tail ) )
+  {
+    s->nwait = s->nwait + 1;
+    pthread_mutex_lock ( &p->lock );
+    atomic_store ( &p->psleep, 1 );
+    while ( ( unsigned long ) p->nbuf <= h + 1 - atomic_load ( &p->tail ) )
+    {
+      pthread_cond_wait ( &p->room, &p->lock );
+    }
+    atomic_store ( &p->psleep, 0 );
+    pthread_mutex_unlock ( &p->lock );
+  }
+
+  s->buf = p->buf[(h+1)%p->nbuf];
+  s->len = 0;
+
+  return;
+}
+/******************************************************************************/
+
+int sink_format ( double x, int digits, char *text )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_FORMAT writes a double in scientific notation.
+
+  Discussion:
+
+    The result looks like the output of printf ( "%.*e", DIGITS-1, X ),
+    for instance "-1.2345e-03", but it is built from a single integer 
+    conversion instead of the general printf machinery.
+
+    The decimal exponent is estimated from the binary one, and the
+    mantissa is scaled by an exactly representable power of ten
+    whenever possible.  Up to 15 significant digits are reliable, the
+    last one to within a unit; use SINK_BINARY when values must be kept
+    exactly.
+
+    Subnormal values, whose scaled mantissa would overflow, and any
+    value whose exponent estimate is still not settled after a few
+    corrections, are written by SNPRINTF instead.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, double X, the value.
+
+    Input, int DIGITS, the number of significant digits, between 1 and 15.
+
+    Output, char *TEXT, the text, which is not terminated.  At least
+    DIGITS+8 characters must be available.
+
+    Output, int SINK_FORMAT, the number of characters written.
+*/
+{
+  static const double p10[23] = {
+    1.0e0,  1.0e1,  1.0e2,  1.0e3,  1.0e4,  1.0e5,  1.0e6,  1.0e7,
+    1.0e8,  1.0e9,  1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15,
+    1.0e16, 1.0e17, 1.0e18, 1.0e19, 1.0e20, 1.0e21, 1.0e22 };
+  char d[16];
+  char fallback[32];
+  int e;
+  int i;
+  int k;
+  int n;
+  long long mant;
+  int tries;
+  double y;
+
+  n = 0;
+
+  if ( x != x )
+  {
+    memcpy ( text, "nan", 3 );
+    return 3;
+  }
+  if ( x < 0.0 || ( x == 0.0 && 1.0 / x < 0.0 ) )
+  {
+    text[n++] = '-';
+    x = - x;
+  }
+  if ( isinf ( x ) )
+  {
+    memcpy ( text + n, "inf", 3 );
+    return n + 3;
+  }
+  if ( digits < 1 )
+  {
+    digits = 1;
+  }
+  if ( 15 < digits )
+  {
+    digits = 15;
+  }
+
+  if ( x == 0.0 )
+  {
+    mant = 0;
+    e = 0;
+  }
+  else
+  {
+/*
+  Estimate the decimal exponent E so that 10^E <= X < 10^(E+1).
+*/
+    frexp ( x, &e );
+    e = ( int ) floor ( ( double ) ( e - 1 ) * 0.30102999566398120 );
+    k = digits - 1 - e;
+    for ( tries = 0; ; tries++ )
+    {
+      if ( 0 <= k && k <= 22 )
+      {
+        y = x * p10[k];
+      }
+      else if ( k < 0 && -22 <= k )
+      {
+        y = x / p10[-k];
+      }
+      else if ( 0 < k )
+      {
+        y = ( x * p10[22] ) * pow ( 10.0, ( double ) ( k - 22 ) );
+      }
+      else
+      {
+        y = x / pow ( 10.0, ( double ) ( - k ) );
+      }
+      if ( !isfinite ( y ) || 3 <= tries || x < DBL_MIN )
+      {
+        i = snprintf ( fallback, sizeof ( fallback ), "%.*e", digits - 1, x );
+        memcpy ( text + n, fallback, i );
+        return n + i;
+      }
+      mant = llround ( y );
+      if ( mant < ( long long ) p10[digits-1] )
+      {
+        e = e - 1;
+        k = k + 1;
+      }
+      else if ( ( long long ) p10[digits] <= mant )
+      {
+        e = e + 1;
+        k = k - 1;
+      }
+      else
+      {
+        break;
+      }
+    }
+  }
+/*
+  Write the mantissa digits, then the exponent.
+*/
+  for ( i = digits - 1; 0 <= i; i-- )
+  {
+    d[i] = ( char ) ( '0' + mant % 10 );
+    mant = mant / 10;
+  }
+  text[n++] = d[0];
+  if ( 1 < digits )
+  {
+    text[n++] = '.';
+    for ( i = 1; i < digits; i++ )
+    {
+      text[n++] = d[i];
+    }
+  }
+  text[n++] = 'e';
+  if ( e < 0 )
+  {
+    text[n++] = '-';
+    e = - e;
+  }
+  else
+  {
+    text[n++] = '+';
+  }
+  if ( 100 <= e )
+  {
+    text[n++] = ( char ) ( '0' + e / 100 );
+  }
+  text[n++] = ( char ) ( '0' + ( e / 10 ) % 10 );
+  text[n++] = ( char ) ( '0' + e % 10 );
+
+  return n;
+}
+/******************************************************************************/
+
+static void sink_header ( sink *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_HEADER writes the file header of a SINK_TRAJ sink.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, sink *S, the sink.
+*/
+{
+  unsigned char h[32];
+  int j;
+  int key;
+  unsigned long long size;
+  unsigned int u;
+  static const char zero[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  size = 32;
+  for ( j = 0; j < s->ncol; j++ )
+  {
+    size = size + strlen ( s->names[j] ) + 1;
+  }
+  size = ( size + 7 ) / 8 * 8;
+  key = ( 0 <= s->key && s->key < s->ncol ) ? s->key : -1;
+
+  memcpy ( h, "SINKTRAJ", 8 );
+  u = 1;
+  sink_le ( h + 8, &u, 4 );
+  u = sizeof ( double );
+  sink_le ( h + 12, &u, 4 );
+  u = ( unsigned int ) s->ncol;
+  sink_le ( h + 16, &u, 4 );
+  sink_le ( h + 20, &key, 4 );
+  sink_le ( h + 24, &size, 8 );
+  fwrite ( h, 1, 32, s->fp );
+
+  size = size - 32;
+  for ( j = 0; j < s->ncol; j++ )
+  {
+    fwrite ( s->names[j], 1, strlen ( s->names[j] ) + 1, s->fp );
+    size = size - strlen ( s->names[j] ) - 1;
+  }
+  fwrite ( zero, 1, ( size_t ) size, s->fp );
+  s->head = 1;
+
+  return;
+}
+/******************************************************************************/
+
+static void sink_le ( unsigned char *b, void *data, int size )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_LE stores one number in little-endian byte order.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Output, unsigned char *B, where the SIZE bytes go.
+
+    Input, void *DATA, the number.
+
+    Input, int SIZE, its size in bytes.
+*/
+{
+  static const union { unsigned short u; unsigned char c[2]; } order = { 1 };
+  int k;
+  unsigned char *p = ( unsigned char * ) data;
+
+  if ( order.c[0] == 1 )
+  {
+    memcpy ( b, p, size );
+  }
+  else
+  {
+    for ( k = 0; k < size; k++ )
+    {
+      b[k] = p[size-1-k];
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+sink *sink_open ( int mode, char *filename, int ncol, char *names[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_OPEN opens a results sink.
+
+  Discussion:
+
+    The column names are not copied, and must remain valid until the
+    sink is closed.  In SINK_CSV mode they form the header line.
+
+    The number of significant digits written in SINK_CSV mode is
+    S->DIGITS, which is 9 unless the caller changes it.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int MODE, one of SINK_OFF, SINK_SUMMARY, SINK_CSV, SINK_BINARY
+    or SINK_TRAJ.
+
+    Input, char *FILENAME, the output file, or NULL for standard output.
+
+    Input, int NCOL, the number of columns in a row.
+
+    Input, char *NAMES[NCOL], the column names.
+
+    Output, sink *SINK_OPEN, the sink, or NULL if the file could not
+    be opened.
+*/
+{
+  int j;
+  sink *s;
+
+  s = ( sink * ) malloc ( sizeof ( sink ) );
+
+  s->mode = mode;
+  s->fp = NULL;
+  s->own = 0;
+  s->ncol = ncol;
+  s->names = names;
+  s->digits = 9;
+  s->rows = 0;
+  s->cmin = ( double * ) malloc ( 2 * ncol * sizeof ( double ) );
+  s->cmax = s->cmin + ncol;
+  s->buf = NULL;
+  s->len = 0;
+  s->size = 0;
+  s->key = 0;
+  s->head = 0;
+  s->chunk = 0;
+  s->pipe = NULL;
+  s->nwait = 0;
+
+  if ( mode == SINK_OFF )
+  {
+    return s;
+  }
+
+  if ( filename == NULL )
+  {
+    s->fp = stdout;
+  }
+  else
+  {
+    s->fp = fopen ( filename,
+      ( mode == SINK_BINARY || mode == SINK_TRAJ ) ? "wb" : "w" );
+    s->own = 1;
+    if ( s->fp == NULL )
+    {
+      free ( s->cmin );
+      free ( s );
+      return NULL;
+    }
+  }
+
+  if ( mode == SINK_CSV || mode == SINK_BINARY )
+  {
+    s->size = SINK_BUFFER_SIZE;
+  }
+/*
+  A chunk holds as many whole rows as fit in the buffer, at least one,
+  after its header.
+*/
+  if ( mode == SINK_TRAJ )
+  {
+    s->chunk = SINK_BUFFER_SIZE / ( ncol * sizeof ( double ) );
+    if ( s->chunk < 1 )
+    {
+      s->chunk = 1;
+    }
+    s->size = SINK_CHUNK_HEAD + s->chunk * ncol * sizeof ( double );
+    s->len = SINK_CHUNK_HEAD;
+  }
+  if ( 0 < s->size )
+  {
+    s->buf = ( char * ) malloc ( s->size );
+  }
+
+  if ( mode == SINK_CSV )
+  {
+    for ( j = 0; j < ncol; j++ )
+    {
+      fprintf ( s->fp, "%s%s", names[j], ( j < ncol - 1 ) ? "," : "\n" );
+    }
+  }
+  return s;
+}
+/******************************************************************************/
+
+void sink_row ( sink *s, double row[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_ROW writes one row of results.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, sink *S, the sink.
+
+    Input, double ROW[S->NCOL], the values of the row.
+*/
+{
+  int j;
+
+  switch ( s->mode )
+  {
+    case SINK_SUMMARY:
+      for ( j = 0; j < s->ncol; j++ )
+      {
+        if ( s->rows == 0 || row[j] < s->cmin[j] )
+        {
+          s->cmin[j] = row[j];
+        }
+        if ( s->rows == 0 || s->cmax[j] < row[j] )
+        {
+          s->cmax[j] = row[j];
+        }
+      }
+      break;
+
+    case SINK_CSV:
+      if ( SINK_BUFFER_SIZE < s->len + s->ncol * ( s->digits + 9 ) )
+      {
+        sink_flush ( s );
+      }
+      for ( j = 0; j < s->ncol; j++ )
+      {
+        s->len = s->len + sink_format ( row[j], s->digits, s->buf + s->len );
+        s->buf[s->len++] = ( j < s->ncol - 1 ) ? ',' : '\n';
+      }
+      break;
+
+    case SINK_BINARY:
+      sink_write ( s, row, s->ncol * sizeof ( double ) );
+      break;
+
+    case SINK_TRAJ:
+      if ( s->len == s->size )
+      {
+        sink_chunk ( s );
+      }
+      if ( 0 <= s->key && s->key < s->ncol )
+      {
+        if ( s->len == SINK_CHUNK_HEAD )
+        {
+          s->kfirst = row[s->key];
+        }
+        s->klast = row[s->key];
+      }
+      for ( j = 0; j < s->ncol; j++ )
+      {
+        sink_le ( ( unsigned char * ) s->buf + s->len, row + j,
+          sizeof ( double ) );
+        s->len = s->len + sizeof ( double );
+      }
+      break;
+  }
+  s->rows = s->rows + 1;
+
+  return;
+}
+/******************************************************************************/
+
+void sink_write ( sink *s, void *data, size_t size )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_WRITE appends doubles to the buffer of a binary sink.
+
+  Discussion:
+
+    The data is written in little-endian byte order whatever the byte
+    order of the machine.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license. 
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, sink *S, the sink.
+
+    Input, void *DATA, the doubles to write.
+
+    Input, size_t SIZE, the number of bytes, a multiple of sizeof(double).
+*/
+{
+  static const union { unsigned short u; unsigned char c[2]; } order = { 1 };
+  unsigned char *b;
+  size_t chunk;
+  unsigned char *p;
+  size_t i;
+  int k;
+
+  p = ( unsigned char * ) data;
+
+  while ( 0 < size )
+  {
+    if ( s->len == SINK_BUFFER_SIZE )
+    {
+      sink_flush ( s );
+    }
+    chunk = SINK_BUFFER_SIZE - s->len;
+    chunk = chunk - chunk % sizeof ( double );
+    if ( size < chunk )
+    {
+      chunk = size;
+    }
+    b = ( unsigned char * ) s->buf + s->len;
+    if ( order.c[0] == 1 )
+    {
+      memcpy ( b, p, chunk );
+    }
+    else
+    {
+      for ( i = 0; i < chunk; i = i + sizeof ( double ) )
+      {
+        for ( k = 0; k < ( int ) sizeof ( double ); k++ )
+        {
+          b[i+k] = p[i+sizeof(double)-1-k];
+        }
+      }
+    }
+    s->len = s->len + chunk;
+    p = p + chunk;
+    size = size - chunk;
+  }
+  return;
+}
+/******************************************************************************/
+
+static void *sink_writer ( void *arg )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_WRITER is the writer thread of an asynchronous sink.
+
+  Discussion:
+
+    It writes the buffers in the order they were handed over, sleeping
+    on READY while there are none, and returns once DONE is set and
+    nothing is left.  The lock is only held to sleep or to wake the
+    producer.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Input, void *ARG, the struct sink_pipe of the sink.
+*/
+{
+  int done;
+  struct sink_pipe *p = ( struct sink_pipe * ) arg;
+  unsigned long t;
+
+  t = 0;
+  for ( ; ; )
+  {
+    if ( t == atomic_load ( &p->head ) )
+    {
+      pthread_mutex_lock ( &p->lock );
+      atomic_store ( &p->wsleep, 1 );
+      while ( t == atomic_load ( &p->head ) && !p->done )
+      {
+        pthread_cond_wait ( &p->ready, &p->lock );
+      }
+      atomic_store ( &p->wsleep, 0 );
+      done = ( t == atomic_load ( &p->head ) );
+      pthread_mutex_unlock ( &p->lock );
+      if ( done )
+      {
+        break;
+      }
+    }
+
+    fwrite ( p->buf[t%p->nbuf], 1, p->len[t%p->nbuf], p->fp );
+/*
+  Give the buffer back, then wake the producer if it sleeps; the same
+  handshake as in SINK_FLUSH.
+*/
+    t = t + 1;
+    atomic_store ( &p->tail, t );
+    if ( atomic_load ( &p->psleep ) )
+    {
+      pthread_mutex_lock ( &p->lock );
+      pthread_cond_signal ( &p->room );
+      pthread_mutex_unlock ( &p->lock );
+    }
+  }
+
+  return NULL;
+}
@@ -0,0 +1,74 @@
+/*
+  SINK writes tables of numerical results without going through printf.
+
+  Modes:
+
+    SINK_OFF      nothing is written.
+    SINK_SUMMARY  only the row count and the range of each column, on close.
+    SINK_CSV      buffered text, one row per line, with a header line.
+    SINK_BINARY   raw little-endian doubles, one row after another.
+    SINK_TRAJ     a self-describing chunked binary file, read back by TRAJ.
+
+  A SINK_TRAJ file is little-endian throughout:
+
+    header   "SINKTRAJ", then 32 bit integers VERSION = 1, DTYPE = 8
+             (float64), NCOL and KEY, a 64 bit header size H, and the
+             NCOL column names, each ending with a NUL, padded with NULs
+             to H bytes, a multiple of 8;
+    chunks   each "CHNK", a 32 bit row count R, the doubles KEYFIRST and
+             KEYLAST, then R rows of NCOL doubles.
+
+  KEY is the column that increases along the rows, usually the time, or
+  -1 if there is none; S->KEY may be set any time before the first row.
+  The chunks are written whole, with sequential I/O, and the data of
+  each one starts on an 8 byte boundary so a reader can use it in place.
+
+  After SINK_ASYNC the writing is done by a background thread, fed with
+  full buffers through a ring, so the caller only waits for the disk
+  when the whole ring is still unwritten; S->NWAIT counts those waits.
+  Either side that has to wait sleeps on a condition variable.
+*/
+# ifndef SINK_H
+# define SINK_H
+
+# include <stdio.h>
+
+# define SINK_OFF     0
+# define SINK_SUMMARY 1
+# define SINK_CSV     2
+# define SINK_BINARY  3
+# define SINK_TRAJ    4
+
+# define SINK_BUFFER_SIZE 65536
+
+typedef struct
+{
+  int mode;
+  FILE *fp;
+  int own;
+  int ncol;
+  char **names;
+  int digits;
+  long rows;
+  double *cmin;
+  double *cmax;
+  char *buf;
+  size_t len;
+  size_t size;
+  int key;
+  int head;
+  long chunk;
+  double kfirst;
+  double klast;
+  struct sink_pipe *pipe;
+  long nwait;
+} sink;
+
+int sink_async ( sink *s, int nbuf );
+void sink_close ( sink *s );
+int sink_format ( double x, int digits, char *text );
+sink *sink_open ( int mode, char *filename, int ncol, char *names[] );
+void sink_row ( sink *s, double row[] );
+void sink_write ( sink *s, void *data, size_t size );
+
+# endif
@@ -0,0 +1,142 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <string.h>
+# include <math.h>
+# include <float.h>
+
+# include "sink.h"
+
+int main ( );
+int sink_test01 ( );
+
+/******************************************************************************/
+
+int main ( )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    MAIN is the main program for SINK_PRB.
+
+  Discussion:
+
+    SINK_PRB tests the SINK library.  It is built with
+
+      gcc -O3 -o sink_prb sink_prb.c sink.c -lm -lpthread
+
+    and returns 0 when every test passes.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+*/
+{
+  int fail;
+
+  printf ( "\n" );
+  printf ( "SINK_PRB\n" );
+  printf ( "  C version\n" );
+  printf ( "  Test the SINK library.\n" );
+
+  fail = sink_test01 ( );
+
+  printf ( "\n" );
+  printf ( "SINK_PRB\n" );
+  if ( fail == 0 )
+  {
+    printf ( "  Normal end of execution.\n" );
+  }
+  else
+  {
+    printf ( "  %d tests failed.\n", fail );
+  }
+
+  return ( fail != 0 );
+}
+/******************************************************************************/
+
+int sink_test01 ( )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SINK_TEST01 tests SINK_FORMAT on extreme values.
+
+  Discussion:
+
+    Each value is written with 1 to 15 digits and compared with the
+    output of printf ( "%.*e" ).  The texts must agree, except that the
+    last digit may differ by a unit.  Subnormal values once made
+    SINK_FORMAT loop forever.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    19 October 2026
+
+  Parameters:
+
+    Output, int SINK_TEST01, the number of failures.
+*/
+{
+  int digits;
+  int fail;
+  int i;
+  int n;
+  char text[32];
+  char want[32];
+  double x[9];
+  double y;
+  double z;
+
+  x[0] = DBL_TRUE_MIN;
+  x[1] = 1.0E-320;
+  x[2] = DBL_MIN;
+  x[3] = DBL_MAX;
+  x[4] = 0.0;
+  x[5] = - 0.0;
+  x[6] = - DBL_TRUE_MIN;
+  x[7] = - DBL_MAX;
+  x[8] = 1.0 / 3.0;
+
+  printf ( "\n" );
+  printf ( "SINK_TEST01\n" );
+  printf ( "  SINK_FORMAT against printf, 1 to 15 digits.\n" );
+  printf ( "\n" );
+
+  fail = 0;
+
+  for ( i = 0; i < 9; i++ )
+  {
+    for ( digits = 1; digits <= 15; digits++ )
+    {
+      n = sink_format ( x[i], digits, text );
+      text[n] = '\0';
+      sprintf ( want, "%.*e", digits - 1, x[i] );
+      if ( strcmp ( text, want ) != 0 )
+      {
+        y = strtod ( text, NULL );
+        z = strtod ( want, NULL );
+        if ( pow ( 10.0, 1 - digits ) * fabs ( z ) < fabs ( y - z ) )
+        {
+          printf ( "  FAIL  %s  printf gives %s\n", text, want );
+          fail = fail + 1;
+        }
+      }
+    }
+    n = sink_format ( x[i], 15, text );
+    text[n] = '\0';
+    printf ( "  %24s\n", text );
+  }
+
+  return fail;
+}
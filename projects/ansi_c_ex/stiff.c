@@ -0,0 +1,1476 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <math.h>
+# include <float.h>
+
+# include "stiff.h"
+
+# define BDF_MAX_ORDER 5
+# define BDF_NEWTON_MAXITER 4
+# define ROSW_JAC_AGE 20
+
+static void bdf_change ( stiff *s, int order, double factor );
+static int bdf_step ( stiff *s, double tout );
+static int rosw_step ( stiff *s, double tout );
+static int stiff_factor ( stiff *s, double c );
+static void stiff_jacobian ( stiff *s, double t, double x[], double f0[] );
+static double stiff_norm ( int n, double e[], double scale[] );
+static void stiff_solve ( stiff *s, double b[] );
+
+/******************************************************************************/
+
+static void bdf_change ( stiff *s, int order, double factor )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    BDF_CHANGE rescales the BDF differences for a new step size.
+
+  Discussion:
+
+    The backward differences D[0:ORDER] of the interpolating polynomial
+    are recomputed for the step size multiplied by FACTOR, through the
+    matrices R and U of Shampine and Reichelt.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Lawrence Shampine, Mark Reichelt,
+    The MATLAB ODE Suite,
+    SIAM Journal on Scientific Computing,
+    Volume 18, Number 1, 1997, pages 1-22.
+
+  Parameters:
+
+    Input/output, stiff *S, the integrator.
+
+    Input, int ORDER, the current order.
+
+    Input, double FACTOR, the ratio of the new and old step sizes.
+*/
+{
+  double *d = s->dif;
+  int i;
+  int j;
+  int k;
+  double m;
+  int n = s->n;
+  double r[BDF_MAX_ORDER+1][BDF_MAX_ORDER+1];
+  double ru[BDF_MAX_ORDER+1][BDF_MAX_ORDER+1];
+  double tmp[BDF_MAX_ORDER+1];
+  double u[BDF_MAX_ORDER+1][BDF_MAX_ORDER+1];
+
+  for ( j = 0; j <= order; j++ )
+  {
+    r[0][j] = 1.0;
+    u[0][j] = 1.0;
+  }
+  for ( i = 1; i <= order; i++ )
+  {
+    for ( j = 0; j <= order; j++ )
+    {
+      m = ( j == 0 ) ? 0.0 : ( i - 1 - factor * j ) / ( double ) i;
+      r[i][j] = r[i-1][j] * m;
+      m = ( j == 0 ) ? 0.0 : ( i - 1 - j ) / ( double ) i;
+      u[i][j] = u[i-1][j] * m;
+    }
+  }
+  for ( i = 0; i <= order; i++ )
+  {
+    for ( j = 0; j <= order; j++ )
+    {
+      ru[i][j] = 0.0;
+      for ( k = 0; k <= order; k++ )
+      {
+        ru[i][j] = ru[i][j] + r[i][k] * u[k][j];
+      }
+    }
+  }
+
+  for ( i = 0; i < n; i++ )
+  {
+    for ( k = 0; k <= order; k++ )
+    {
+      tmp[k] = 0.0;
+      for ( j = 0; j <= order; j++ )
+      {
+        tmp[k] = tmp[k] + ru[j][k] * d[j*n+i];
+      }
+    }
+    for ( k = 0; k <= order; k++ )
+    {
+      d[k*n+i] = tmp[k];
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static int bdf_step ( stiff *s, double tout )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    BDF_STEP takes one accepted step of the variable order BDF method.
+
+  Discussion:
+
+    This follows the BDF code of SciPy, itself after ode15s: the solution
+    is held as backward differences, the corrector is solved by simplified
+    Newton iterations with the factors of I - c J, c = H / ALPHA(ORDER),
+    and after ORDER+1 steps of equal size the orders ORDER-1, ORDER and
+    ORDER+1 are compared to pick the next order and step size.
+
+    J is recomputed only when the Newton iterations fail to converge with
+    an old J.  The factors are recomputed when c changes.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Lawrence Shampine, Mark Reichelt,
+    The MATLAB ODE Suite,
+    SIAM Journal on Scientific Computing,
+    Volume 18, Number 1, 1997, pages 1-22.
+
+  Parameters:
+
+    Input/output, stiff *S, the integrator.
+
+    Input, double TOUT, a time not to step past.
+
+    Output, int BDF_STEP, is 0 on success, or 1 if the step size
+    became too small.
+*/
+{
+  const double kappa[BDF_MAX_ORDER+1] = {
+    0.0, -0.1850, -1.0 / 9.0, -0.0823, -0.0415, 0.0 };
+  int accepted;
+  double alpha[BDF_MAX_ORDER+1];
+  double c;
+  int converged;
+  double *d;
+  double *dif = s->dif;
+  int delta;
+  double *dy;
+  double dyn;
+  double dyold;
+  double errc[BDF_MAX_ORDER+1];
+  double *err;
+  double errm;
+  double errn;
+  double errp;
+  double factor;
+  double fm;
+  double fp;
+  double f1;
+  double *fv;
+  double gam[BDF_MAX_ORDER+1];
+  double h;
+  double habs;
+  double hmin;
+  int i;
+  int k;
+  int n = s->n;
+  int niter;
+  double newton_tol;
+  int order = s->order;
+  double *psi;
+  double rate;
+  double safety;
+  double *scale;
+  double t = s->t;
+  double tnew;
+  double *y;
+  double *ypred;
+
+  y = s->w;
+  d = s->w + n;
+  dy = s->w + 2 * n;
+  fv = s->w + 3 * n;
+  psi = s->w + 4 * n;
+  scale = s->w + 5 * n;
+  ypred = s->w + 6 * n;
+  err = s->w + 7 * n;
+
+  gam[0] = 0.0;
+  for ( k = 1; k <= BDF_MAX_ORDER; k++ )
+  {
+    gam[k] = gam[k-1] + 1.0 / k;
+  }
+  for ( k = 0; k <= BDF_MAX_ORDER; k++ )
+  {
+    alpha[k] = ( 1.0 - kappa[k] ) * gam[k];
+    errc[k] = kappa[k] * gam[k] + 1.0 / ( k + 1 );
+  }
+
+  newton_tol = fmax ( 10.0 * DBL_EPSILON / s->rtol, fmin ( 0.03, sqrt ( s->rtol ) ) );
+  hmin = 10.0 * fabs ( nextafter ( t, HUGE_VAL ) - t );
+
+  habs = s->h;
+  if ( s->hmax < habs )
+  {
+    bdf_change ( s, order, s->hmax / habs );
+    habs = s->hmax;
+    s->nequal = 0;
+  }
+
+  accepted = 0;
+
+  while ( !accepted )
+  {
+    if ( habs < hmin )
+    {
+      s->h = habs;
+      return 1;
+    }
+
+    tnew = t + habs;
+    if ( tout < tnew )
+    {
+      tnew = tout;
+      bdf_change ( s, order, ( tnew - t ) / habs );
+      s->nequal = 0;
+    }
+    h = tnew - t;
+    habs = h;
+
+    for ( i = 0; i < n; i++ )
+    {
+      ypred[i] = 0.0;
+      psi[i] = 0.0;
+      for ( k = 0; k <= order; k++ )
+      {
+        ypred[i] = ypred[i] + dif[k*n+i];
+      }
+      for ( k = 1; k <= order; k++ )
+      {
+        psi[i] = psi[i] + dif[k*n+i] * gam[k];
+      }
+      psi[i] = psi[i] / alpha[order];
+      scale[i] = s->atol + s->rtol * fabs ( ypred[i] );
+    }
+
+    c = h / alpha[order];
+    converged = 0;
+    niter = 0;
+
+    for ( ; ; )
+    {
+      if ( s->c != c && stiff_factor ( s, c ) != 0 )
+      {
+        converged = 0;
+      }
+      else
+      {
+/*
+  Simplified Newton iterations for the corrector.
+*/
+        for ( i = 0; i < n; i++ )
+        {
+          y[i] = ypred[i];
+          d[i] = 0.0;
+        }
+        dyold = -1.0;
+        for ( k = 0; k < BDF_NEWTON_MAXITER; k++ )
+        {
+          s->f ( tnew, y, fv, s->data );
+          s->nfev = s->nfev + 1;
+          for ( i = 0; i < n; i++ )
+          {
+            if ( !isfinite ( fv[i] ) )
+            {
+              break;
+            }
+            dy[i] = c * fv[i] - psi[i] - d[i];
+          }
+          if ( i < n )
+          {
+            break;
+          }
+          stiff_solve ( s, dy );
+          dyn = stiff_norm ( n, dy, scale );
+          rate = ( dyold < 0.0 ) ? -1.0 : dyn / dyold;
+          if ( 0.0 <= rate && ( 1.0 <= rate ||
+            pow ( rate, BDF_NEWTON_MAXITER - k ) / ( 1.0 - rate ) * dyn > newton_tol ) )
+          {
+            break;
+          }
+          for ( i = 0; i < n; i++ )
+          {
+            y[i] = y[i] + dy[i];
+            d[i] = d[i] + dy[i];
+          }
+          if ( dyn == 0.0 || ( 0.0 <= rate && rate / ( 1.0 - rate ) * dyn < newton_tol ) )
+          {
+            converged = 1;
+            break;
+          }
+          dyold = dyn;
+        }
+        niter = k + 1;
+      }
+
+      if ( converged || s->jfresh )
+      {
+        break;
+      }
+      s->f ( tnew, ypred, s->f0, s->data );
+      s->nfev = s->nfev + 1;
+      stiff_jacobian ( s, tnew, ypred, s->f0 );
+      s->jfresh = 1;
+      s->c = 0.0;
+    }
+
+    if ( !converged )
+    {
+      habs = 0.5 * habs;
+      bdf_change ( s, order, 0.5 );
+      s->nequal = 0;
+      s->nreject = s->nreject + 1;
+      continue;
+    }
+
+    safety = 0.9 * ( 2 * BDF_NEWTON_MAXITER + 1 )
+      / ( 2 * BDF_NEWTON_MAXITER + niter );
+    for ( i = 0; i < n; i++ )
+    {
+      scale[i] = s->atol + s->rtol * fabs ( y[i] );
+      err[i] = errc[order] * d[i];
+    }
+    errn = stiff_norm ( n, err, scale );
+
+    if ( 1.0 < errn )
+    {
+      factor = fmax ( 0.2, safety * pow ( errn, -1.0 / ( order + 1 ) ) );
+      habs = habs * factor;
+      bdf_change ( s, order, factor );
+      s->nequal = 0;
+      s->nreject = s->nreject + 1;
+    }
+    else
+    {
+      accepted = 1;
+    }
+  }
+
+  s->nequal = s->nequal + 1;
+  s->t = tnew;
+  s->h = habs;
+  s->jfresh = 0;
+  s->naccept = s->naccept + 1;
+  for ( i = 0; i < n; i++ )
+  {
+    s->x[i] = y[i];
+    dif[(order+2)*n+i] = d[i] - dif[(order+1)*n+i];
+    dif[(order+1)*n+i] = d[i];
+  }
+  for ( k = order; 0 <= k; k-- )
+  {
+    for ( i = 0; i < n; i++ )
+    {
+      dif[k*n+i] = dif[k*n+i] + dif[(k+1)*n+i];
+    }
+  }
+
+  if ( s->nequal < order + 1 )
+  {
+    return 0;
+  }
+/*
+  Compare the error estimates of the neighbouring orders.
+*/
+  errm = HUGE_VAL;
+  if ( 1 < order )
+  {
+    for ( i = 0; i < n; i++ )
+    {
+      err[i] = errc[order-1] * dif[order*n+i];
+    }
+    errm = stiff_norm ( n, err, scale );
+  }
+  errp = HUGE_VAL;
+  if ( order < BDF_MAX_ORDER )
+  {
+    for ( i = 0; i < n; i++ )
+    {
+      err[i] = errc[order+1] * dif[(order+2)*n+i];
+    }
+    errp = stiff_norm ( n, err, scale );
+  }
+
+  fm = ( errm == HUGE_VAL ) ? 0.0 : pow ( errm, -1.0 / order );
+  f1 = pow ( errn, -1.0 / ( order + 1 ) );
+  fp = ( errp == HUGE_VAL ) ? 0.0 : pow ( errp, -1.0 / ( order + 2 ) );
+
+  delta = 0;
+  factor = f1;
+  if ( factor < fm )
+  {
+    delta = -1;
+    factor = fm;
+  }
+  if ( factor < fp )
+  {
+    delta = 1;
+    factor = fp;
+  }
+  order = order + delta;
+  s->order = order;
+
+  factor = fmin ( 10.0, safety * factor );
+  s->h = s->h * factor;
+  bdf_change ( s, order, factor );
+  s->nequal = 0;
+
+  return 0;
+}
+/******************************************************************************/
+
+static int rosw_step ( stiff *s, double tout )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    ROSW_STEP takes one accepted step of the Rosenbrock-W method ROS34PW2.
+
+  Discussion:
+
+    The four stages are written in the transformed variables U(I) of
+    Hairer and Wanner, so each needs one solve with I - h GAMMA J and no
+    products with J:
+
+      ( I - h GAMMA J ) U(I) = h GAMMA ( F ( T + ALPHA(I) h,
+        X + sum A(I,J) U(J) ) + sum C(I,J) U(J) / h + GAMMA(I) h FT )
+
+    with FT an estimate of dF/dT.  As a W-method it keeps order 3 when J
+    is only approximate, so J is reused over many steps: it is refreshed
+    after a rejected step, or every ROSW_JAC_AGE steps.  To keep the
+    factors too, a step size increase of less than 20 percent is not
+    taken.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Joachim Rang, Lutz Angermann,
+    New Rosenbrock W-methods of order 3 for partial differential
+    algebraic equations of index 1,
+    BIT Numerical Mathematics,
+    Volume 45, Number 4, 2005, pages 761-787.
+
+    Ernst Hairer, Gerhard Wanner,
+    Solving Ordinary Differential Equations II: Stiff and
+    Differential-Algebraic Problems,
+    Springer, 1996, section IV.7.
+
+  Parameters:
+
+    Input/output, stiff *S, the integrator.
+
+    Input, double TOUT, a time not to step past.
+
+    Output, int ROSW_STEP, is 0 on success, or 1 if the step size
+    became too small.
+*/
+{
+  const double ga = 0.435866521508459;
+  const double aa[4][4] = {
+    { 0.0, 0.0, 0.0, 0.0 },
+    { 0.87173304301691801, 0.0, 0.0, 0.0 },
+    { 0.84457060015369423, -0.11299064236484185, 0.0, 0.0 },
+    { 0.0, 0.0, 1.0, 0.0 } };
+  const double gg[4][4] = {
+    { 0.0, 0.0, 0.0, 0.0 },
+    { -0.87173304301691801, 0.0, 0.0, 0.0 },
+    { -0.90338057013044082, 0.054180672388095326, 0.0, 0.0 },
+    { 0.24212380706095346, -1.2232505839045147, 0.54526025533510214, 0.0 } };
+  const double b[4] = {
+    0.24212380706095346, -1.2232505839045147, 1.5452602553351020,
+    0.435866521508459 };
+  const double bh[4] = {
+    0.37810903145819369, -0.096042292212423178, 0.5, 0.2179332607542295 };
+  double a[4][4];
+  double alpha[4];
+  double cc[4][4];
+  double c;
+  double *err;
+  double errn;
+  double fac;
+  double gi[4][4];
+  double gsum[4];
+  double h;
+  int i;
+  int j;
+  int k;
+  int last;
+  double m[4];
+  double me[4];
+  int n = s->n;
+  int needjac;
+  int reject;
+  double *rhs;
+  double sk;
+  double t = s->t;
+  double *u[4];
+  double *x = s->x;
+  double *xnew;
+  double *ys;
+
+  for ( i = 0; i < 4; i++ )
+  {
+    u[i] = s->w + i * n;
+  }
+  ys = s->w + 4 * n;
+  rhs = s->w + 5 * n;
+  xnew = s->w + 6 * n;
+  err = s->w + 7 * n;
+/*
+  Transformed coefficients: GI is the inverse of GAMMA = GG + GA I.
+*/
+  for ( j = 0; j < 4; j++ )
+  {
+    for ( i = 0; i < 4; i++ )
+    {
+      gi[i][j] = 0.0;
+    }
+    gi[j][j] = 1.0 / ga;
+    for ( i = j + 1; i < 4; i++ )
+    {
+      for ( k = j; k < i; k++ )
+      {
+        gi[i][j] = gi[i][j] - gg[i][k] * gi[k][j];
+      }
+      gi[i][j] = gi[i][j] / ga;
+    }
+  }
+  for ( i = 0; i < 4; i++ )
+  {
+    alpha[i] = 0.0;
+    gsum[i] = ga;
+    m[i] = 0.0;
+    me[i] = 0.0;
+    for ( j = 0; j < 4; j++ )
+    {
+      alpha[i] = alpha[i] + aa[i][j];
+      gsum[i] = gsum[i] + gg[i][j];
+      a[i][j] = 0.0;
+      for ( k = 0; k < 4; k++ )
+      {
+        a[i][j] = a[i][j] + aa[i][k] * gi[k][j];
+      }
+      cc[i][j] = ( i == j ) ? 0.0 : -gi[i][j];
+      m[i] = m[i] + b[j] * gi[j][i];
+      me[i] = me[i] + ( b[j] - bh[j] ) * gi[j][i];
+    }
+  }
+
+  s->f ( t, x, s->f0, s->data );
+  s->nfev = s->nfev + 1;
+
+  needjac = ( ROSW_JAC_AGE <= s->jage );
+  reject = 0;
+
+  for ( ; ; )
+  {
+    h = fmin ( s->h, s->hmax );
+    last = 0;
+    if ( tout <= t + 1.01 * h )
+    {
+      h = tout - t;
+      last = 1;
+    }
+    if ( h <= 16.0 * DBL_EPSILON * fabs ( t ) || h <= 0.0 )
+    {
+      return 1;
+    }
+
+    if ( needjac )
+    {
+      stiff_jacobian ( s, t, x, s->f0 );
+      sk = sqrt ( DBL_EPSILON ) * fmax ( 1.0, fabs ( t ) );
+      s->f ( t + sk, x, s->ft, s->data );
+      s->nfev = s->nfev + 1;
+      for ( i = 0; i < n; i++ )
+      {
+        s->ft[i] = ( s->ft[i] - s->f0[i] ) / sk;
+      }
+      s->jfresh = 1;
+      s->jage = 0;
+      s->c = 0.0;
+      needjac = 0;
+    }
+
+    c = ga * h;
+    if ( s->c != c && stiff_factor ( s, c ) != 0 )
+    {
+      s->h = 0.5 * h;
+      s->nreject = s->nreject + 1;
+      needjac = !s->jfresh;
+      reject = 1;
+      continue;
+    }
+
+    for ( k = 0; k < 4; k++ )
+    {
+      if ( k == 0 )
+      {
+        for ( i = 0; i < n; i++ )
+        {
+          rhs[i] = s->f0[i];
+        }
+      }
+      else
+      {
+        for ( i = 0; i < n; i++ )
+        {
+          ys[i] = x[i];
+          for ( j = 0; j < k; j++ )
+          {
+            ys[i] = ys[i] + a[k][j] * u[j][i];
+          }
+        }
+        s->f ( t + alpha[k] * h, ys, rhs, s->data );
+        s->nfev = s->nfev + 1;
+      }
+      for ( i = 0; i < n; i++ )
+      {
+        for ( j = 0; j < k; j++ )
+        {
+          rhs[i] = rhs[i] + ( cc[k][j] / h ) * u[j][i];
+        }
+        u[k][i] = c * ( rhs[i] + gsum[k] * h * s->ft[i] );
+      }
+      stiff_solve ( s, u[k] );
+    }
+
+    for ( i = 0; i < n; i++ )
+    {
+      xnew[i] = x[i];
+      err[i] = 0.0;
+      for ( k = 0; k < 4; k++ )
+      {
+        xnew[i] = xnew[i] + m[k] * u[k][i];
+        err[i] = err[i] + me[k] * u[k][i];
+      }
+      sk = s->atol + s->rtol * fmax ( fabs ( x[i] ), fabs ( xnew[i] ) );
+      rhs[i] = sk;
+    }
+    errn = stiff_norm ( n, err, rhs );
+
+    if ( errn <= 1.0 )
+    {
+      fac = fmax ( 0.2, fmin ( 5.0, 0.9 * pow ( errn, -1.0 / 3.0 ) ) );
+      if ( reject )
+      {
+        fac = fmin ( fac, 1.0 );
+      }
+      if ( last )
+      {
+        if ( s->h < h * fac )
+        {
+          s->h = h * fac;
+        }
+      }
+      else if ( fac < 1.0 || 1.2 < fac )
+      {
+        s->h = h * fac;
+      }
+      else
+      {
+        s->h = h;
+      }
+      for ( i = 0; i < n; i++ )
+      {
+        x[i] = xnew[i];
+      }
+      s->t = last ? tout : t + h;
+      s->jfresh = 0;
+      s->jage = s->jage + 1;
+      s->naccept = s->naccept + 1;
+      return 0;
+    }
+
+    fac = 0.2;
+    if ( isfinite ( errn ) )
+    {
+      fac = fmax ( 0.2, 0.9 * pow ( errn, -1.0 / 3.0 ) );
+    }
+    s->h = h * fac;
+    s->nreject = s->nreject + 1;
+    needjac = !s->jfresh;
+    reject = 1;
+  }
+}
+/******************************************************************************/
+
+int stiff_advance ( stiff *s, double tout )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    STIFF_ADVANCE integrates up to a given time.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, stiff *S, the integrator.
+
+    Input, double TOUT, the time to reach.
+
+    Output, int STIFF_ADVANCE, is 0 on success, or 1 if the step size
+    became too small.
+*/
+{
+  while ( s->t < tout )
+  {
+    if ( stiff_step ( s, tout ) != 0 )
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+/******************************************************************************/
+
+stiff *stiff_create ( int method, ode_rhs *f, ode_jac *jac, int n, int type,
+  int ml, int mu, double t, double x[], double atol, double rtol,
+  void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    STIFF_CREATE sets up a stiff integrator.
+
+  Discussion:
+
+    The Jacobian is evaluated at the initial point, and the first step
+    size is chosen as in Hairer, Norsett and Wanner.  S->HMAX, the
+    largest step allowed, is initially unlimited.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int METHOD, STIFF_BDF or STIFF_ROSW.
+
+    Input, ode_rhs *F, the right hand side.
+
+    Input, ode_jac *JAC, the Jacobian routine, or NULL to use
+    differences of F.
+
+    Input, int N, the number of components.
+
+    Input, int TYPE, STIFF_DENSE, STIFF_BANDED or STIFF_TRIDIAGONAL.
+
+    Input, int ML, MU, the lower and upper bandwidths for STIFF_BANDED.
+    They are ignored for the other types.
+
+    Input, double T, X[N], the initial time and state.
+
+    Input, double ATOL, RTOL, the absolute and relative tolerances.
+
+    Input, void *DATA, passed to F and JAC.
+
+    Output, stiff *STIFF_CREATE, the integrator, or NULL if memory
+    ran out.
+*/
+{
+  double d0;
+  double d1;
+  double d2;
+  double h0;
+  double h1;
+  int i;
+  int jsize;
+  int lsize;
+  stiff *s;
+  double sk;
+
+  if ( type == STIFF_DENSE )
+  {
+    ml = n - 1;
+    mu = n - 1;
+    jsize = n * n;
+    lsize = n * n;
+  }
+  else if ( type == STIFF_TRIDIAGONAL )
+  {
+    ml = 1;
+    mu = 1;
+    jsize = 3 * n;
+    lsize = 3 * n;
+  }
+  else
+  {
+    jsize = ( ml + mu + 1 ) * n;
+    lsize = ( 2 * ml + mu + 1 ) * n;
+  }
+
+  s = ( stiff * ) malloc ( sizeof ( stiff ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+  s->x = ( double * ) malloc ( ( 21 * n + jsize + lsize ) * sizeof ( double ) );
+  s->piv = ( int * ) malloc ( n * sizeof ( int ) );
+  if ( s->x == NULL || s->piv == NULL )
+  {
+    free ( s->x );
+    free ( s->piv );
+    free ( s );
+    return NULL;
+  }
+  s->dif = s->x + n;
+  s->f0 = s->x + 9 * n;
+  s->ft = s->x + 10 * n;
+  s->w = s->x + 11 * n;
+  s->jm = s->x + 21 * n;
+  s->lu = s->jm + jsize;
+
+  s->f = f;
+  s->jac = jac;
+  s->data = data;
+  s->n = n;
+  s->method = method;
+  s->type = type;
+  s->ml = ml;
+  s->mu = mu;
+  s->atol = atol;
+  s->rtol = rtol;
+  s->hmax = HUGE_VAL;
+  s->t = t;
+  s->c = 0.0;
+  s->order = 1;
+  s->nequal = 0;
+  s->nfev = 0;
+  s->njev = 0;
+  s->nlu = 0;
+  s->naccept = 0;
+  s->nreject = 0;
+
+  for ( i = 0; i < n; i++ )
+  {
+    s->x[i] = x[i];
+  }
+  f ( t, s->x, s->f0, data );
+  s->nfev = s->nfev + 1;
+/*
+  Initial step, as in DOPRI_CREATE, for an error of order 1 (BDF)
+  or 2 (ROSW).
+*/
+  d0 = 0.0;
+  d1 = 0.0;
+  for ( i = 0; i < n; i++ )
+  {
+    sk = atol + rtol * fabs ( x[i] );
+    d0 = d0 + ( x[i] / sk ) * ( x[i] / sk );
+    d1 = d1 + ( s->f0[i] / sk ) * ( s->f0[i] / sk );
+  }
+  d0 = sqrt ( d0 / n );
+  d1 = sqrt ( d1 / n );
+  h0 = ( d0 < 1.0E-10 || d1 < 1.0E-10 ) ? 1.0E-06 : 0.01 * d0 / d1;
+
+  for ( i = 0; i < n; i++ )
+  {
+    s->w[i] = x[i] + h0 * s->f0[i];
+  }
+  f ( t + h0, s->w, s->w + n, data );
+  s->nfev = s->nfev + 1;
+  d2 = 0.0;
+  for ( i = 0; i < n; i++ )
+  {
+    sk = atol + rtol * fabs ( x[i] );
+    d2 = d2 + pow ( ( s->w[n+i] - s->f0[i] ) / sk, 2 );
+  }
+  d2 = sqrt ( d2 / n ) / h0;
+
+  if ( fmax ( d1, d2 ) <= 1.0E-15 )
+  {
+    h1 = fmax ( 1.0E-06, h0 * 1.0E-03 );
+  }
+  else
+  {
+    h1 = pow ( 0.01 / fmax ( d1, d2 ),
+      1.0 / ( ( method == STIFF_BDF ) ? 2.0 : 3.0 ) );
+  }
+  s->h = fmin ( 100.0 * h0, h1 );
+
+/*
+  ROSW also needs dF/dT with its Jacobian, and takes both on its first step.
+*/
+  if ( method == STIFF_BDF )
+  {
+    stiff_jacobian ( s, t, s->x, s->f0 );
+    s->jfresh = 1;
+    s->jage = 0;
+  }
+  else
+  {
+    s->jfresh = 0;
+    s->jage = ROSW_JAC_AGE;
+  }
+
+  for ( i = 0; i < 8 * n; i++ )
+  {
+    s->dif[i] = 0.0;
+  }
+  for ( i = 0; i < n; i++ )
+  {
+    s->dif[i] = x[i];
+    s->dif[n+i] = s->h * s->f0[i];
+  }
+
+  return s;
+}
+/******************************************************************************/
+
+static int stiff_factor ( stiff *s, double c )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    STIFF_FACTOR forms and factors I - C J.
+
+  Discussion:
+
+    Dense and banded matrices are factored by Gaussian elimination with
+    partial pivoting, the banded one in the LAPACK band layout with ML
+    extra rows for fill in.  Tridiagonal ones are factored without
+    pivoting.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, stiff *S, the integrator.  On success, S->C is set
+    to C.
+
+    Input, double C, the coefficient.
+
+    Output, int STIFF_FACTOR, is 0 on success, or 1 if the matrix
+    is singular.
+*/
+{
+  int i;
+  int j;
+  int jp;
+  int ju;
+  int k;
+  int kv;
+  int km;
+  int ld;
+  double *lu = s->lu;
+  int ml = s->ml;
+  int mu = s->mu;
+  int n = s->n;
+  double pmax;
+  double tmp;
+
+  s->c = 0.0;
+  s->nlu = s->nlu + 1;
+
+  if ( s->type == STIFF_DENSE )
+  {
+    for ( j = 0; j < n; j++ )
+    {
+      for ( i = 0; i < n; i++ )
+      {
+        lu[i+j*n] = - c * s->jm[i+j*n];
+      }
+      lu[j+j*n] = lu[j+j*n] + 1.0;
+    }
+
+    for ( k = 0; k < n; k++ )
+    {
+      jp = k;
+      pmax = fabs ( lu[k+k*n] );
+      for ( i = k + 1; i < n; i++ )
+      {
+        if ( pmax < fabs ( lu[i+k*n] ) )
+        {
+          jp = i;
+          pmax = fabs ( lu[i+k*n] );
+        }
+      }
+      s->piv[k] = jp;
+      if ( pmax == 0.0 )
+      {
+        return 1;
+      }
+      if ( jp != k )
+      {
+        for ( j = 0; j < n; j++ )
+        {
+          tmp = lu[k+j*n];
+          lu[k+j*n] = lu[jp+j*n];
+          lu[jp+j*n] = tmp;
+        }
+      }
+      for ( i = k + 1; i < n; i++ )
+      {
+        lu[i+k*n] = lu[i+k*n] / lu[k+k*n];
+      }
+      for ( j = k + 1; j < n; j++ )
+      {
+        tmp = lu[k+j*n];
+        if ( tmp != 0.0 )
+        {
+          for ( i = k + 1; i < n; i++ )
+          {
+            lu[i+j*n] = lu[i+j*n] - lu[i+k*n] * tmp;
+          }
+        }
+      }
+    }
+  }
+  else if ( s->type == STIFF_TRIDIAGONAL )
+  {
+/*
+  LU holds the multipliers, the pivots and the superdiagonal.
+*/
+    for ( i = 0; i < n; i++ )
+    {
+      lu[n+i] = 1.0 - c * s->jm[1+i*3];
+      lu[2*n+i] = ( i < n - 1 ) ? - c * s->jm[(i+1)*3] : 0.0;
+      lu[i] = ( 0 < i ) ? - c * s->jm[2+(i-1)*3] : 0.0;
+    }
+    for ( i = 0; i < n; i++ )
+    {
+      if ( 0 < i )
+      {
+        lu[i] = lu[i] / lu[n+i-1];
+        lu[n+i] = lu[n+i] - lu[i] * lu[2*n+i-1];
+      }
+      if ( lu[n+i] == 0.0 )
+      {
+        return 1;
+      }
+    }
+  }
+  else
+  {
+/*
+  Entry (I,J) of the band matrix is LU[KV+I-J+J*LD].
+*/
+    kv = ml + mu;
+    ld = 2 * ml + mu + 1;
+    for ( i = 0; i < ld * n; i++ )
+    {
+      lu[i] = 0.0;
+    }
+    for ( j = 0; j < n; j++ )
+    {
+      for ( i = ( j < mu ? 0 : j - mu ); i <= j + ml && i < n; i++ )
+      {
+        lu[kv+i-j+j*ld] = - c * s->jm[mu+i-j+j*(ml+mu+1)];
+      }
+      lu[kv+j*ld] = lu[kv+j*ld] + 1.0;
+    }
+
+    ju = 0;
+    for ( j = 0; j < n; j++ )
+    {
+      km = ( ml < n - 1 - j ) ? ml : n - 1 - j;
+      jp = 0;
+      pmax = fabs ( lu[kv+j*ld] );
+      for ( i = 1; i <= km; i++ )
+      {
+        if ( pmax < fabs ( lu[kv+i+j*ld] ) )
+        {
+          jp = i;
+          pmax = fabs ( lu[kv+i+j*ld] );
+        }
+      }
+      s->piv[j] = j + jp;
+      if ( pmax == 0.0 )
+      {
+        return 1;
+      }
+      if ( ju < j + mu + jp )
+      {
+        ju = j + mu + jp;
+      }
+      if ( n - 1 < ju )
+      {
+        ju = n - 1;
+      }
+      if ( jp != 0 )
+      {
+        for ( k = j; k <= ju; k++ )
+        {
+          tmp = lu[kv+j-k+k*ld];
+          lu[kv+j-k+k*ld] = lu[kv+j+jp-k+k*ld];
+          lu[kv+j+jp-k+k*ld] = tmp;
+        }
+      }
+      for ( i = 1; i <= km; i++ )
+      {
+        lu[kv+i+j*ld] = lu[kv+i+j*ld] / lu[kv+j*ld];
+      }
+      for ( k = j + 1; k <= ju; k++ )
+      {
+        tmp = lu[kv+j-k+k*ld];
+        if ( tmp != 0.0 )
+        {
+          for ( i = 1; i <= km; i++ )
+          {
+            lu[kv+j+i-k+k*ld] = lu[kv+j+i-k+k*ld] - lu[kv+i+j*ld] * tmp;
+          }
+        }
+      }
+    }
+  }
+
+  s->c = c;
+  return 0;
+}
+/******************************************************************************/
+
+void stiff_free ( stiff *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    STIFF_FREE frees a stiff integrator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, stiff *S, the integrator.
+*/
+{
+  free ( s->x );
+  free ( s->piv );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+static void stiff_jacobian ( stiff *s, double t, double x[], double f0[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    STIFF_JACOBIAN evaluates the Jacobian into S->JM.
+
+  Discussion:
+
+    Without a user routine, column J is ( F ( X + DEL E(J) ) - F0 ) / DEL,
+    DEL = sqrt ( EPS * max ( 1.0E-05, |X(J)| ) ).  For a band matrix,
+    columns ML+MU+1 apart touch disjoint rows, so they are perturbed
+    together and one call of F serves all of them.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, stiff *S, the integrator.
+
+    Input, double T, X[N], the point.
+
+    Input, double F0[N], the value of F at the point.
+*/
+{
+  double del;
+  int g;
+  int i;
+  int j;
+  double *jf;
+  double *jx;
+  int n = s->n;
+  int ml = s->ml;
+  int mu = s->mu;
+  int w;
+
+  s->njev = s->njev + 1;
+
+  if ( s->jac != NULL )
+  {
+    s->jac ( t, x, s->jm, s->data );
+    return;
+  }
+
+  jx = s->w + 8 * n;
+  jf = s->w + 9 * n;
+  for ( i = 0; i < n; i++ )
+  {
+    jx[i] = x[i];
+  }
+
+  if ( s->type == STIFF_DENSE )
+  {
+    for ( j = 0; j < n; j++ )
+    {
+      del = sqrt ( DBL_EPSILON * fmax ( 1.0E-05, fabs ( x[j] ) ) );
+      jx[j] = x[j] + del;
+      del = jx[j] - x[j];
+      s->f ( t, jx, jf, s->data );
+      for ( i = 0; i < n; i++ )
+      {
+        s->jm[i+j*n] = ( jf[i] - f0[i] ) / del;
+      }
+      jx[j] = x[j];
+    }
+    s->nfev = s->nfev + n;
+    return;
+  }
+
+  w = ml + mu + 1;
+  for ( g = 0; g < w && g < n; g++ )
+  {
+    for ( j = g; j < n; j = j + w )
+    {
+      jx[j] = x[j] + sqrt ( DBL_EPSILON * fmax ( 1.0E-05, fabs ( x[j] ) ) );
+    }
+    s->f ( t, jx, jf, s->data );
+    s->nfev = s->nfev + 1;
+    for ( j = g; j < n; j = j + w )
+    {
+      del = jx[j] - x[j];
+      for ( i = ( j < mu ? 0 : j - mu ); i <= j + ml && i < n; i++ )
+      {
+        s->jm[mu+i-j+j*w] = ( jf[i] - f0[i] ) / del;
+      }
+      jx[j] = x[j];
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static double stiff_norm ( int n, double e[], double scale[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    STIFF_NORM is the RMS norm of E / SCALE.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int N, the length.
+
+    Input, double E[N], SCALE[N], the vector and the scale factors.
+
+    Output, double STIFF_NORM, the norm.
+*/
+{
+  int i;
+  double value;
+
+  value = 0.0;
+  for ( i = 0; i < n; i++ )
+  {
+    value = value + ( e[i] / scale[i] ) * ( e[i] / scale[i] );
+  }
+  value = sqrt ( value / n );
+
+  return value;
+}
+/******************************************************************************/
+
+static void stiff_solve ( stiff *s, double b[] )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    STIFF_SOLVE solves ( I - C J ) X = B with the factors of STIFF_FACTOR.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, stiff *S, the integrator, with current factors.
+
+    Input/output, double B[N], the right hand side, replaced by the
+    solution.
+*/
+{
+  int i;
+  int j;
+  int km;
+  int kv;
+  int ld;
+  double *lu = s->lu;
+  int ml = s->ml;
+  int n = s->n;
+  double tmp;
+
+  if ( s->type == STIFF_DENSE )
+  {
+    for ( j = 0; j < n; j++ )
+    {
+      if ( s->piv[j] != j )
+      {
+        tmp = b[j];
+        b[j] = b[s->piv[j]];
+        b[s->piv[j]] = tmp;
+      }
+      for ( i = j + 1; i < n; i++ )
+      {
+        b[i] = b[i] - lu[i+j*n] * b[j];
+      }
+    }
+    for ( j = n - 1; 0 <= j; j-- )
+    {
+      b[j] = b[j] / lu[j+j*n];
+      for ( i = 0; i < j; i++ )
+      {
+        b[i] = b[i] - lu[i+j*n] * b[j];
+      }
+    }
+  }
+  else if ( s->type == STIFF_TRIDIAGONAL )
+  {
+    for ( i = 1; i < n; i++ )
+    {
+      b[i] = b[i] - lu[i] * b[i-1];
+    }
+    b[n-1] = b[n-1] / lu[2*n-1];
+    for ( i = n - 2; 0 <= i; i-- )
+    {
+      b[i] = ( b[i] - lu[2*n+i] * b[i+1] ) / lu[n+i];
+    }
+  }
+  else
+  {
+    kv = ml + s->mu;
+    ld = 2 * ml + s->mu + 1;
+    for ( j = 0; j < n; j++ )
+    {
+      km = ( ml < n - 1 - j ) ? ml : n - 1 - j;
+      if ( s->piv[j] != j )
+      {
+        tmp = b[j];
+        b[j] = b[s->piv[j]];
+        b[s->piv[j]] = tmp;
+      }
+      for ( i = 1; i <= km; i++ )
+      {
+        b[j+i] = b[j+i] - lu[kv+i+j*ld] * b[j];
+      }
+    }
+    for ( j = n - 1; 0 <= j; j-- )
+    {
+      b[j] = b[j] / lu[kv+j*ld];
+      for ( i = ( j < kv ? 0 : j - kv ); i < j; i++ )
+      {
+        b[i] = b[i] - lu[kv+i-j+j*ld] * b[j];
+      }
+    }
+  }
+
+  return;
+}
+/******************************************************************************/
+
+int stiff_step ( stiff *s, double tout )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    STIFF_STEP takes one accepted step with the chosen method.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, stiff *S, the integrator.
+
+    Input, double TOUT, a time not to step past.
+
+    Output, int STIFF_STEP, is 0 on success, or 1 if the step size
+    became too small.
+*/
+{
+  if ( s->method == STIFF_BDF )
+  {
+    return bdf_step ( s, tout );
+  }
+  return rosw_step ( s, tout );
+}
@@ -0,0 +1,86 @@
+/*
+  STIFF holds implicit integrators for stiff systems:
+
+    STIFF_BDF   backward differentiation formulas of variable order 1 to 5
+                and variable step, in the quasi-constant step form of
+                Shampine's ode15s, solved by simplified Newton iterations;
+    STIFF_ROSW  the Rosenbrock-W method ROS34PW2 of Rang and Angermann,
+                order 3 with an embedded order 2 error estimate, which
+                stays of order 3 with an outdated Jacobian.
+
+  Both solve linear systems with I - c J, J an approximate Jacobian of F.
+  J is stored as
+
+    STIFF_DENSE        entry (I,J) in JAC[I+J*N];
+    STIFF_BANDED       ML subdiagonals and MU superdiagonals, with
+                       entry (I,J) in JAC[MU+I-J+J*(ML+MU+1)];
+    STIFF_TRIDIAGONAL  the banded storage with ML = MU = 1, factored by
+                       the Thomas algorithm without pivoting, for the
+                       diagonally dominant matrices of diffusion problems.
+
+  J comes from the user routine JAC ( T, X, J, DATA ), filling that
+  storage, or if JAC is NULL, from differences of F: N calls of F for a
+  dense J, but only ML+MU+1 for a banded one, by perturbing every
+  (ML+MU+1)-th component at once.
+
+  J is kept as long as the Newton iterations converge (BDF) or the steps
+  are accepted (ROSW), and the factors of I - c J are kept as long as c
+  does not change, so most steps need neither.
+*/
+# ifndef STIFF_H
+# define STIFF_H
+
+# include "ode.h"
+
+# define STIFF_BDF 0
+# define STIFF_ROSW 1
+
+# define STIFF_DENSE 0
+# define STIFF_BANDED 1
+# define STIFF_TRIDIAGONAL 2
+
+typedef void ode_jac ( double t, double x[], double jac[], void *data );
+
+typedef struct
+{
+  ode_rhs *f;
+  ode_jac *jac;
+  void *data;
+  int n;
+  int method;
+  int type;
+  int ml;
+  int mu;
+  double atol;
+  double rtol;
+  double hmax;
+  double t;
+  double h;
+  double *x;
+  double *jm;
+  double *lu;
+  int *piv;
+  double c;
+  int jfresh;
+  int jage;
+  int order;
+  int nequal;
+  double *dif;
+  double *f0;
+  double *ft;
+  double *w;
+  long nfev;
+  long njev;
+  long nlu;
+  long naccept;
+  long nreject;
+} stiff;
+
+int stiff_advance ( stiff *s, double tout );
+stiff *stiff_create ( int method, ode_rhs *f, ode_jac *jac, int n, int type,
+  int ml, int mu, double t, double x[], double atol, double rtol,
+  void *data );
+void stiff_free ( stiff *s );
+int stiff_step ( stiff *s, double tout );
+
+# endif
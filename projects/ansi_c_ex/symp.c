@@ -0,0 +1,328 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <math.h>
+
+# include "symp.h"
+
+static void rkn4_step ( symp *s, double h );
+static void verlet_step ( symp *s, double h );
+
+/******************************************************************************/
+
+static void rkn4_step ( symp *s, double h )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    RKN4_STEP takes one step of the 3 stage Runge-Kutta-Nystrom method.
+
+  Discussion:
+
+      K1 = G ( T,       Q )
+      K2 = G ( T + H/2, Q + H/2 V + H^2/8 K1 )
+      K3 = G ( T + H,   Q + H V + H^2/2 K2 )
+      Q  = Q + H V + H^2/6 ( K1 + 2 K2 )
+      V  = V + H/6 ( K1 + 4 K2 + K3 )
+
+    This is fourth order for X'' = G ( T, X ).  S->A holds K1 on entry
+    and G at the new point on exit, so a step costs 3 calls of G.
+    Damping, if any, is applied by the exact flow at both ends.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Ernst Hairer, Syvert Norsett, Gerhard Wanner,
+    Solving Ordinary Differential Equations I: Nonstiff Problems,
+    Springer, 1993, section II.14.
+
+  Parameters:
+
+    Input/output, symp *S, the integrator.
+
+    Input, double H, the step size.
+*/
+{
+  double damp;
+  int i;
+  double *k2 = s->w;
+  double *k3 = s->w + s->n;
+  int n = s->n;
+  double *qs = s->w + 2 * s->n;
+
+  damp = exp ( -0.5 * s->gamma * h );
+  if ( s->gamma != 0.0 )
+  {
+    for ( i = 0; i < n; i++ )
+    {
+      s->v[i] = damp * s->v[i];
+    }
+  }
+
+  for ( i = 0; i < n; i++ )
+  {
+    qs[i] = s->q[i] + 0.5 * h * s->v[i] + h * h / 8.0 * s->a[i];
+  }
+  s->g ( s->t + 0.5 * h, qs, k2, s->data );
+
+  for ( i = 0; i < n; i++ )
+  {
+    qs[i] = s->q[i] + h * s->v[i] + 0.5 * h * h * k2[i];
+  }
+  s->g ( s->t + h, qs, k3, s->data );
+
+  for ( i = 0; i < n; i++ )
+  {
+    s->q[i] = s->q[i] + h * s->v[i] + h * h / 6.0 * ( s->a[i] + 2.0 * k2[i] );
+    s->v[i] = s->v[i] + h / 6.0 * ( s->a[i] + 4.0 * k2[i] + k3[i] );
+    if ( s->gamma != 0.0 )
+    {
+      s->v[i] = damp * s->v[i];
+    }
+  }
+  s->t = s->t + h;
+  s->g ( s->t, s->q, s->a, s->data );
+  s->nfev = s->nfev + 3;
+
+  return;
+}
+/******************************************************************************/
+
+symp *symp_create ( int method, ode_acc *g, int n, double t, double q[],
+  double v[], void *data )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SYMP_CREATE sets up an integrator for a second order system.
+
+  Discussion:
+
+    S->GAMMA, the damping rate, is initially 0.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, int METHOD, SYMP_VERLET, SYMP_YOSHIDA4, SYMP_YOSHIDA6
+    or SYMP_RKN4.
+
+    Input, ode_acc *G, the acceleration routine.
+
+    Input, int N, the number of positions.
+
+    Input, double T, Q[N], V[N], the initial time, positions and
+    velocities.
+
+    Input, void *DATA, passed to G.
+
+    Output, symp *SYMP_CREATE, the integrator, or NULL if memory
+    ran out.
+*/
+{
+  int i;
+  symp *s;
+
+  s = ( symp * ) malloc ( sizeof ( symp ) );
+  if ( s == NULL )
+  {
+    return NULL;
+  }
+  s->q = ( double * ) malloc ( 6 * n * sizeof ( double ) );
+  if ( s->q == NULL )
+  {
+    free ( s );
+    return NULL;
+  }
+  s->v = s->q + n;
+  s->a = s->q + 2 * n;
+  s->w = s->q + 3 * n;
+
+  s->g = g;
+  s->data = data;
+  s->n = n;
+  s->method = method;
+  s->gamma = 0.0;
+  s->t = t;
+  for ( i = 0; i < n; i++ )
+  {
+    s->q[i] = q[i];
+    s->v[i] = v[i];
+  }
+  g ( t, s->q, s->a, data );
+  s->nfev = 1;
+
+  return s;
+}
+/******************************************************************************/
+
+void symp_free ( symp *s )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SYMP_FREE frees a second order integrator.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, symp *S, the integrator.
+*/
+{
+  free ( s->q );
+  free ( s );
+
+  return;
+}
+/******************************************************************************/
+
+void symp_step ( symp *s, double h )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SYMP_STEP takes one step of size H.
+
+  Discussion:
+
+    The Yoshida methods are symmetric compositions of Verlet steps of
+    sizes W(I) H.  For order 4, W = ( W1, W0, W1 ) with
+    W1 = 1 / ( 2 - 2^(1/3) ) and W0 = 1 - 2 W1.  For order 6, solution A
+    of Yoshida's paper, W = ( W3, W2, W1, W0, W1, W2, W3 ) with
+    W0 = 1 - 2 ( W1 + W2 + W3 ).
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Reference:
+
+    Haruo Yoshida,
+    Construction of higher order symplectic integrators,
+    Physics Letters A,
+    Volume 150, Number 5-7, 1990, pages 262-268.
+
+  Parameters:
+
+    Input/output, symp *S, the integrator.
+
+    Input, double H, the step size.
+*/
+{
+  const double y6[4] = {
+    1.31518632068391, -1.17767998417887, 0.235573213359357,
+    0.784513610477560 };
+  int i;
+  double w0;
+  double w1;
+
+  if ( s->method == SYMP_VERLET )
+  {
+    verlet_step ( s, h );
+  }
+  else if ( s->method == SYMP_YOSHIDA4 )
+  {
+    w1 = 1.0 / ( 2.0 - cbrt ( 2.0 ) );
+    w0 = 1.0 - 2.0 * w1;
+    verlet_step ( s, w1 * h );
+    verlet_step ( s, w0 * h );
+    verlet_step ( s, w1 * h );
+  }
+  else if ( s->method == SYMP_YOSHIDA6 )
+  {
+    for ( i = 3; 1 <= i; i-- )
+    {
+      verlet_step ( s, y6[i] * h );
+    }
+    verlet_step ( s, y6[0] * h );
+    for ( i = 1; i <= 3; i++ )
+    {
+      verlet_step ( s, y6[i] * h );
+    }
+  }
+  else
+  {
+    rkn4_step ( s, h );
+  }
+
+  return;
+}
+/******************************************************************************/
+
+static void verlet_step ( symp *s, double h )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    VERLET_STEP takes one velocity Verlet step.
+
+  Discussion:
+
+    V = V + H/2 A, Q = Q + H V, A = G ( T + H, Q ), V = V + H/2 A,
+    with S->A already holding G at the starting point, so one call
+    of G per step.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input/output, symp *S, the integrator.
+
+    Input, double H, the step size, which may be negative inside
+    a composition.
+*/
+{
+  double damp;
+  int i;
+  int n = s->n;
+
+  damp = exp ( -0.5 * s->gamma * h );
+  for ( i = 0; i < n; i++ )
+  {
+    s->v[i] = damp * s->v[i] + 0.5 * h * s->a[i];
+    s->q[i] = s->q[i] + h * s->v[i];
+  }
+  s->t = s->t + h;
+  s->g ( s->t, s->q, s->a, s->data );
+  s->nfev = s->nfev + 1;
+  for ( i = 0; i < n; i++ )
+  {
+    s->v[i] = damp * ( s->v[i] + 0.5 * h * s->a[i] );
+  }
+
+  return;
+}
@@ -0,0 +1,50 @@
+/*
+  SYMP holds integrators for second order systems X'' = G ( T, X ), with
+  the acceleration routine G ( T, Q, A, DATA ) filling A[0:N-1]:
+
+    SYMP_VERLET    velocity Verlet, order 2, 1 call of G per step;
+    SYMP_YOSHIDA4  Yoshida's triple jump of Verlet steps, order 4, 3 calls;
+    SYMP_YOSHIDA6  Yoshida's 7 stage composition, order 6, 7 calls;
+    SYMP_RKN4      the 3 stage Runge-Kutta-Nystrom method, order 4,
+                   3 calls, not symplectic but exact in T.
+
+  The Verlet based methods are symplectic: for a conservative system the
+  energy error stays bounded over any number of steps instead of
+  drifting, as it does with RK4.  Their last call of G is at the new
+  point and is reused by the next step.
+
+  S->GAMMA adds linear damping, X'' = G - GAMMA X'.  The Verlet based
+  methods apply its exact flow, V = exp ( - GAMMA H / 2 ) V, before and
+  after each Verlet step, which keeps them conformally symplectic.
+*/
+# ifndef SYMP_H
+# define SYMP_H
+
+# define SYMP_VERLET 0
+# define SYMP_YOSHIDA4 1
+# define SYMP_YOSHIDA6 2
+# define SYMP_RKN4 3
+
+typedef void ode_acc ( double t, double q[], double a[], void *data );
+
+typedef struct
+{
+  ode_acc *g;
+  void *data;
+  int n;
+  int method;
+  double gamma;
+  double t;
+  double *q;
+  double *v;
+  double *a;
+  double *w;
+  long nfev;
+} symp;
+
+symp *symp_create ( int method, ode_acc *g, int n, double t, double q[],
+  double v[], void *data );
+void symp_free ( symp *s );
+void symp_step ( symp *s, double h );
+
+# endif
@@ -0,0 +1,394 @@
+# include <stdlib.h>
+# include <stdio.h>
+# include <string.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+
+# include "traj.h"
+
+static int traj_chunk ( traj *tr, long r );
+
+/******************************************************************************/
+
+static int traj_chunk ( traj *tr, long r )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    TRAJ_CHUNK finds the chunk that holds a given row.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, traj *TR, the open file.
+
+    Input, long R, a row, between 0 and TR->NROW-1.
+
+    Output, int TRAJ_CHUNK, the chunk C with
+    TR->FIRST[C] <= R < TR->FIRST[C+1].
+*/
+{
+  long hi;
+  long lo;
+  long mid;
+
+  lo = 0;
+  hi = tr->nchunk - 1;
+  while ( lo < hi )
+  {
+    mid = ( lo + hi + 1 ) / 2;
+    if ( tr->first[mid] <= r )
+    {
+      lo = mid;
+    }
+    else
+    {
+      hi = mid - 1;
+    }
+  }
+
+  return ( int ) lo;
+}
+/******************************************************************************/
+
+void traj_close ( traj *tr )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    TRAJ_CLOSE unmaps a trajectory file and frees its index.
+
+  Discussion:
+
+    Row pointers from TRAJ_ROW are no longer valid afterwards.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, traj *TR, the open file.
+*/
+{
+  if ( tr == NULL )
+  {
+    return;
+  }
+  munmap ( tr->map, tr->size );
+  free ( tr->names );
+  free ( tr->data );
+  free ( tr->first );
+  free ( tr->kfirst );
+  free ( tr->klast );
+  free ( tr );
+
+  return;
+}
+/******************************************************************************/
+
+long traj_find ( traj *tr, double t )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    TRAJ_FIND finds the first row whose key is at least T.
+
+  Discussion:
+
+    The rows between TRAJ_FIND ( TR, T0 ) and TRAJ_FIND ( TR, T1 ) - 1
+    are those with T0 <= KEY < T1.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, traj *TR, the open file.
+
+    Input, double T, the key value.
+
+    Output, long TRAJ_FIND, the row, or TR->NROW if every key is less
+    than T, or -1 if the file has no key column.
+*/
+{
+  int c;
+  long hi;
+  long lo;
+  long mid;
+  long nr;
+
+  if ( tr->key < 0 )
+  {
+    return -1;
+  }
+/*
+  The first chunk that ends at or after T.
+*/
+  lo = 0;
+  hi = tr->nchunk;
+  while ( lo < hi )
+  {
+    mid = ( lo + hi ) / 2;
+    if ( tr->klast[mid] < t )
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  if ( lo == tr->nchunk )
+  {
+    return tr->nrow;
+  }
+  c = ( int ) lo;
+/*
+  The first row of that chunk at or after T.
+*/
+  nr = tr->first[c+1] - tr->first[c];
+  lo = 0;
+  hi = nr;
+  while ( lo < hi )
+  {
+    mid = ( lo + hi ) / 2;
+    if ( tr->data[c][mid*tr->ncol+tr->key] < t )
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  return tr->first[c] + lo;
+}
+/******************************************************************************/
+
+traj *traj_open ( char *filename )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    TRAJ_OPEN maps a SINK_TRAJ file and indexes its chunks.
+
+  Discussion:
+
+    A last chunk cut short, by a writer that did not finish, is ignored.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, char *FILENAME, the file.
+
+    Output, traj *TRAJ_OPEN, the open file, or NULL if it could not be
+    mapped or is not a SINK_TRAJ file.
+*/
+{
+  char *b;
+  int c;
+  int fd;
+  unsigned long long hsize;
+  int j;
+  int key;
+  unsigned int ncol;
+  long nchunk;
+  unsigned int nr;
+  size_t offset;
+  static const union { unsigned short u; unsigned char c[2]; } order = { 1 };
+  size_t rowsize;
+  struct stat st;
+  traj *tr;
+  unsigned int u;
+
+  if ( order.c[0] != 1 )
+  {
+    fprintf ( stderr, "\n" );
+    fprintf ( stderr, "TRAJ_OPEN - Fatal error!\n" );
+    fprintf ( stderr, "  Trajectory files are only read on little-endian hosts.\n" );
+    return NULL;
+  }
+
+  fd = open ( filename, O_RDONLY );
+  if ( fd < 0 )
+  {
+    fprintf ( stderr, "\n" );
+    fprintf ( stderr, "TRAJ_OPEN - Fatal error!\n" );
+    fprintf ( stderr, "  Could not open \"%s\".\n", filename );
+    return NULL;
+  }
+  if ( fstat ( fd, &st ) != 0 || st.st_size < 32 )
+  {
+    close ( fd );
+    fprintf ( stderr, "\n" );
+    fprintf ( stderr, "TRAJ_OPEN - Fatal error!\n" );
+    fprintf ( stderr, "  \"%s\" is too short.\n", filename );
+    return NULL;
+  }
+
+  tr = ( traj * ) malloc ( sizeof ( traj ) );
+  tr->size = ( size_t ) st.st_size;
+  tr->map = mmap ( NULL, tr->size, PROT_READ, MAP_PRIVATE, fd, 0 );
+  close ( fd );
+  if ( tr->map == MAP_FAILED )
+  {
+    free ( tr );
+    fprintf ( stderr, "\n" );
+    fprintf ( stderr, "TRAJ_OPEN - Fatal error!\n" );
+    fprintf ( stderr, "  Could not map \"%s\".\n", filename );
+    return NULL;
+  }
+  b = ( char * ) tr->map;
+/*
+  The file header.
+*/
+  memcpy ( &u, b + 8, 4 );
+  memcpy ( &ncol, b + 16, 4 );
+  memcpy ( &key, b + 20, 4 );
+  memcpy ( &hsize, b + 24, 8 );
+  if ( memcmp ( b, "SINKTRAJ", 8 ) != 0 || u != 1
+    || memcmp ( b + 12, "\10\0\0\0", 4 ) != 0 || ncol == 0
+    || hsize % 8 != 0 || tr->size < hsize
+    || ( key < -1 || ( int ) ncol <= key ) )
+  {
+    munmap ( tr->map, tr->size );
+    free ( tr );
+    fprintf ( stderr, "\n" );
+    fprintf ( stderr, "TRAJ_OPEN - Fatal error!\n" );
+    fprintf ( stderr, "  \"%s\" is not a trajectory file.\n", filename );
+    return NULL;
+  }
+  tr->ncol = ( int ) ncol;
+  tr->key = key;
+/*
+  The names point into the header; each ends with its own NUL.
+*/
+  tr->names = ( char ** ) malloc ( ncol * sizeof ( char * ) );
+  offset = 32;
+  for ( j = 0; j < tr->ncol; j++ )
+  {
+    tr->names[j] = b + offset;
+    offset = offset + strnlen ( b + offset, hsize - offset ) + 1;
+    if ( hsize < offset )
+    {
+      tr->names[j] = "";
+      offset = hsize;
+    }
+  }
+/*
+  Count the whole chunks, then index them.
+*/
+  rowsize = ncol * sizeof ( double );
+  nchunk = 0;
+  offset = hsize;
+  while ( offset + 24 <= tr->size && memcmp ( b + offset, "CHNK", 4 ) == 0 )
+  {
+    memcpy ( &nr, b + offset + 4, 4 );
+    if ( tr->size - offset - 24 < nr * rowsize )
+    {
+      break;
+    }
+    offset = offset + 24 + nr * rowsize;
+    nchunk = nchunk + 1;
+  }
+
+  tr->nchunk = nchunk;
+  tr->data = ( double ** ) malloc ( ( nchunk + 1 ) * sizeof ( double * ) );
+  tr->first = ( long * ) malloc ( ( nchunk + 1 ) * sizeof ( long ) );
+  tr->kfirst = ( double * ) malloc ( ( nchunk + 1 ) * sizeof ( double ) );
+  tr->klast = ( double * ) malloc ( ( nchunk + 1 ) * sizeof ( double ) );
+
+  tr->first[0] = 0;
+  offset = hsize;
+  for ( c = 0; c < nchunk; c++ )
+  {
+    memcpy ( &nr, b + offset + 4, 4 );
+    memcpy ( tr->kfirst + c, b + offset + 8, 8 );
+    memcpy ( tr->klast + c, b + offset + 16, 8 );
+    tr->data[c] = ( double * ) ( b + offset + 24 );
+    tr->first[c+1] = tr->first[c] + nr;
+    offset = offset + 24 + nr * rowsize;
+  }
+  tr->nrow = tr->first[nchunk];
+
+  return tr;
+}
+/******************************************************************************/
+
+double *traj_row ( traj *tr, long r, long *run )
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    TRAJ_ROW returns a row of a trajectory file, in place.
+
+  Discussion:
+
+    The rows of one chunk are contiguous, so ROW[K*NCOL+J], for K less
+    than RUN, is column J of row R+K.
+
+  Licensing:
+
+    This code is distributed under the GNU LGPL license.
+
+  Modified:
+
+    18 October 2026
+
+  Parameters:
+
+    Input, traj *TR, the open file.
+
+    Input, long R, the row, between 0 and TR->NROW-1.
+
+    Output, long *RUN, the number of rows, R among them, that can be read
+    from the pointer returned.
+
+    Output, double *TRAJ_ROW, the row, read only, or NULL if R is out of
+    range.
+*/
+{
+  int c;
+
+  if ( r < 0 || tr->nrow <= r )
+  {
+    *run = 0;
+    return NULL;
+  }
+  c = traj_chunk ( tr, r );
+  *run = tr->first[c+1] - r;
+
+  return tr->data[c] + ( r - tr->first[c] ) * tr->ncol;
+}
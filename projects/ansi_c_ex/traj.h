@@ -0,0 +1,45 @@
+/*
+  TRAJ reads the chunked binary files written by a SINK_TRAJ sink, in
+  place, through a read only memory map:
+
+    tr = traj_open ( "osc.traj" );
+    r = traj_find ( tr, 2.5 );          first row with KEY >= 2.5
+    row = traj_row ( tr, r, &run );     ROW[0:NCOL-1], and RUN-1 more
+                                        rows follow it in memory
+    traj_close ( tr );
+
+  Opening reads the file header and walks the chunk headers once, so the
+  rows are never copied and the pages of a long trajectory are only
+  touched when asked for.  TRAJ_FIND searches the first and last keys of
+  the chunks, then the rows of one chunk, so a time range costs two
+  binary searches however large the file is.
+
+  The rows are used as stored, little-endian, so the reader refuses to
+  open a file on a big-endian host.
+*/
+# ifndef TRAJ_H
+# define TRAJ_H
+
+# include <stddef.h>
+
+typedef struct
+{
+  void *map;
+  size_t size;
+  int ncol;
+  int key;
+  char **names;
+  long nchunk;
+  long nrow;
+  double **data;
+  long *first;
+  double *kfirst;
+  double *klast;
+} traj;
+
+void traj_close ( traj *tr );
+long traj_find ( traj *tr, double t );
+traj *traj_open ( char *filename );
+double *traj_row ( traj *tr, long r, long *run );
+
+# endif